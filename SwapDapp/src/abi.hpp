@@ -0,0 +1,222 @@
+/*
+ * File:        abi.hpp
+ * Created on:  2026-10-17
+ * Description: Compile-time Solidity ABI calldata encoder for static argument
+ *              types (address, bool, uintN, intN, bytesN).
+ *
+ *                  using Approve = abi::Function<"approve(address,uint256)">;
+ *                  std::string data = Approve::encode_hex(spender, amount);
+ *
+ *              The selector is keccak256 of the signature, evaluated by the
+ *              constexpr Keccak at compile time. The signature is parsed at
+ *              compile time as well: an unknown type name, or arguments that
+ *              do not match the declared parameters, fail to compile. The
+ *              encoded size is a constant, and encode_into() writes straight
+ *              into a caller-provided buffer with no allocation.
+ *
+ *              C++ argument types:
+ *              - address: Address or AddressBytes.
+ *              - bool: bool.
+ *              - uintN / intN: any integral type, uint256, or Bytes32
+ *                holding the big-endian word.
+ *              - bytesN: std::array<uint8_t, N> (left-aligned).
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "hex_codec.hpp"
+#include "keccak.hpp"
+#include "uint256.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace abi {
+
+// Signature string usable as a template argument.
+template <size_t N>
+struct FixedString {
+    char chars[N]{};
+    constexpr FixedString(const char (&s)[N]) {
+        for (size_t i = 0; i < N; ++i) chars[i] = s[i];
+    }
+    constexpr std::string_view view() const { return {chars, N - 1}; }
+};
+
+inline constexpr size_t kWord = 32;
+
+namespace detail {
+
+enum class Kind { Address, Bool, Uint, Int, FixedBytes, Unsupported };
+
+struct Param {
+    Kind kind = Kind::Unsupported;
+    size_t size = 0;   // bits for uintN/intN, bytes for bytesN
+};
+
+constexpr bool parse_size(std::string_view digits, size_t& out) {
+    if (digits.empty() || digits[0] == '0') return false;
+    size_t v = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (size_t)(c - '0');
+    }
+    out = v;
+    return true;
+}
+
+constexpr Param parse_type(std::string_view t) {
+    Param p;
+    size_t n = 0;
+    if (t == "address") return {Kind::Address, 20};
+    if (t == "bool") return {Kind::Bool, 1};
+    if (t == "uint") return {Kind::Uint, 256};
+    if (t == "int") return {Kind::Int, 256};
+    if (t.substr(0, 4) == "uint" && parse_size(t.substr(4), n) && n % 8 == 0 && n <= 256) return {Kind::Uint, n};
+    if (t.substr(0, 3) == "int" && parse_size(t.substr(3), n) && n % 8 == 0 && n <= 256) return {Kind::Int, n};
+    if (t.substr(0, 5) == "bytes" && parse_size(t.substr(5), n) && n <= 32) return {Kind::FixedBytes, n};
+    return p;   // dynamic (bytes, string, T[]) and tuples are not supported
+}
+
+constexpr bool well_formed(std::string_view sig) {
+    size_t open = sig.find('(');
+    if (open == 0 || open == std::string_view::npos || sig.back() != ')') return false;
+    for (size_t i = 0; i < sig.size(); ++i) {
+        if (sig[i] == ' ' || (i > open && i + 1 < sig.size() && (sig[i] == '(' || sig[i] == ')'))) return false;
+    }
+    return true;
+}
+
+constexpr size_t count_params(std::string_view sig) {
+    size_t open = sig.find('(');
+    std::string_view list = sig.substr(open + 1, sig.size() - open - 2);
+    if (list.empty()) return 0;
+    size_t n = 1;
+    for (char c : list) n += (c == ',');
+    return n;
+}
+
+template <size_t N>
+constexpr std::array<Param, N> parse_params(std::string_view sig) {
+    std::array<Param, N> out{};
+    size_t pos = sig.find('(') + 1;
+    for (size_t i = 0; i < N; ++i) {
+        size_t end = sig.find_first_of(",)", pos);
+        out[i] = parse_type(sig.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return out;
+}
+
+template <class T>
+inline constexpr bool is_byte_array = false;
+template <size_t N>
+inline constexpr bool is_byte_array<std::array<uint8_t, N>> = true;
+
+template <class T>
+inline constexpr size_t byte_array_size = 0;
+template <size_t N>
+inline constexpr size_t byte_array_size<std::array<uint8_t, N>> = N;
+
+// Whether a C++ argument of type T may be passed for parameter p.
+template <class T>
+constexpr bool accepts(Param p) {
+    using U = std::remove_cvref_t<T>;
+    switch (p.kind) {
+    case Kind::Address: return std::is_same_v<U, Address> || std::is_same_v<U, AddressBytes>;
+    case Kind::Bool:    return std::is_same_v<U, bool>;
+    case Kind::Uint:
+    case Kind::Int:
+        return (std::is_integral_v<U> && !std::is_same_v<U, bool>) || std::is_same_v<U, uint256> ||
+               std::is_same_v<U, Bytes32>;
+    case Kind::FixedBytes: return is_byte_array<U> && byte_array_size<U> == p.size;
+    default: return false;
+    }
+}
+
+// One 32-byte head word.
+template <class T>
+constexpr void encode_word(uint8_t* w, const T& v) {
+    using U = std::remove_cvref_t<T>;
+    for (size_t i = 0; i < kWord; ++i) w[i] = 0;
+    if constexpr (std::is_same_v<U, bool>) {
+        w[kWord - 1] = v ? 1 : 0;
+    } else if constexpr (std::is_integral_v<U>) {
+        // Two's complement sign extension for negative intN arguments.
+        if constexpr (std::is_signed_v<U>) {
+            if (v < 0) {
+                for (size_t i = 0; i < kWord; ++i) w[i] = 0xff;
+            }
+        }
+        auto x = static_cast<std::make_unsigned_t<U>>(v);
+        for (size_t i = 0; i < sizeof(U); ++i) w[kWord - 1 - i] = static_cast<uint8_t>(x >> (8 * i));
+    } else if constexpr (std::is_same_v<U, uint256>) {
+        Bytes32 be = v.to_word();
+        for (size_t i = 0; i < kWord; ++i) w[i] = be[i];
+    } else if constexpr (std::is_same_v<U, Address>) {
+        for (size_t i = 0; i < v.size(); ++i) w[kWord - v.size() + i] = v.data()[i];
+    } else if constexpr (std::is_same_v<U, AddressBytes>) {
+        for (size_t i = 0; i < v.size(); ++i) w[kWord - v.size() + i] = v[i];
+    } else {
+        // Bytes32 (uint256 word) and bytesN share the left-aligned copy: for
+        // N = 32 the two layouts coincide.
+        for (size_t i = 0; i < v.size(); ++i) w[i] = v[i];
+    }
+}
+
+} // namespace detail
+
+template <FixedString Sig>
+struct Function {
+    static_assert(detail::well_formed(Sig.view()),
+                  "ABI signature must look like name(type1,type2) with no spaces");
+
+    static constexpr std::string_view signature = Sig.view();
+    static constexpr size_t arity = detail::count_params(Sig.view());
+    static constexpr std::array<detail::Param, arity> params = detail::parse_params<arity>(Sig.view());
+    static constexpr std::array<uint8_t, 4> selector = [] {
+        Keccak256::Digest d = keccak256(Sig.view());
+        return std::array<uint8_t, 4>{d[0], d[1], d[2], d[3]};
+    }();
+    // Static types only, so every argument is one head word.
+    static constexpr size_t encoded_size = 4 + kWord * arity;
+
+    // Writes exactly encoded_size bytes to out.
+    template <class... Args>
+    static constexpr void encode_into(uint8_t* out, const Args&... args) {
+        static_assert(sizeof...(Args) == arity, "argument count does not match the ABI signature");
+        static_assert(check<Args...>(std::make_index_sequence<arity>{}),
+                      "argument type does not match the ABI signature (or the signature names an "
+                      "unsupported type)");
+        for (size_t i = 0; i < 4; ++i) out[i] = selector[i];
+        size_t off = 4;
+        ((detail::encode_word(out + off, args), off += kWord), ...);
+    }
+
+    template <class... Args>
+    static constexpr std::array<uint8_t, encoded_size> encode(const Args&... args) {
+        std::array<uint8_t, encoded_size> out{};
+        encode_into(out.data(), args...);
+        return out;
+    }
+
+    // "0x"-prefixed calldata for JSON-RPC, built with a single allocation.
+    template <class... Args>
+    static std::string encode_hex(const Args&... args) {
+        std::array<uint8_t, encoded_size> raw = encode(args...);
+        return to_hex(raw.data(), raw.size());
+    }
+
+private:
+    template <class... Args, size_t... I>
+    static constexpr bool check(std::index_sequence<I...>) {
+        return (detail::accepts<Args>(params[I]) && ...);
+    }
+};
+
+} // namespace abi
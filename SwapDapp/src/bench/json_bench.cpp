@@ -0,0 +1,231 @@
+/*
+ * File:        json_bench.cpp
+ * Created on:  2026-10-17
+ * Description: Micro-benchmark for the JSON-RPC extractor. Times each scanner
+ *              kernel (scalar / SSE2 / AVX2) against a full nlohmann parse on
+ *              the responses the clients read most: a quantity, a tx hash, a
+ *              receipt with logs, and eth_getBlockReceipts for a busy block.
+ *              Every kernel is first cross-checked against nlohmann on random
+ *              documents with escapes and brackets inside strings. The
+ *              streaming parser is checked the same way with the body split
+ *              at random points, and timed on 16 KiB chunks (curl's default).
+ *
+ *              ./json_bench [iterations]   (build with -DCMAKE_BUILD_TYPE=Release)
+ */
+
+#include "json_extract.hpp"
+#include "json_stream.hpp"
+#include "rpc_client.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+static uint64_t g_sink;   // printed at exit so results stay live
+
+template <class F>
+static void run(const char* name, size_t iters, size_t bytesPerIter, F&& f) {
+    for (size_t i = 0; i < iters / 10 + 1; ++i) f();   // warm-up
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iters; ++i) f();
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("  %-36s %11.1f ns/op %8.2f GB/s\n", name, ns / (double)iters,
+                bytesPerIter ? (double)(bytesPerIter * iters) / ns : 0.0);
+}
+
+static std::string random_hex(std::mt19937_64& rng, size_t bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string s = "0x";
+    for (size_t i = 0; i < 2 * bytes; ++i) s += digits[rng() & 15];
+    return s;
+}
+
+static nlohmann::json make_receipt(std::mt19937_64& rng, size_t logs) {
+    nlohmann::json r = {
+        {"blockHash", random_hex(rng, 32)},
+        {"blockNumber", "0x12a4f3c"},
+        {"contractAddress", nullptr},
+        {"cumulativeGasUsed", "0x1c9c380"},
+        {"effectiveGasPrice", "0x3b9aca0e"},
+        {"from", random_hex(rng, 20)},
+        {"gasUsed", "0x2a1b4"},
+        {"logsBloom", random_hex(rng, 256)},
+        {"status", "0x1"},
+        {"to", random_hex(rng, 20)},
+        {"transactionHash", random_hex(rng, 32)},
+        {"transactionIndex", "0x4"},
+        {"type", "0x2"}
+    };
+    nlohmann::json arr = nlohmann::json::array();
+    for (size_t i = 0; i < logs; ++i) {
+        arr.push_back({
+            {"address", random_hex(rng, 20)},
+            {"topics", {random_hex(rng, 32), random_hex(rng, 32), random_hex(rng, 32)}},
+            {"data", random_hex(rng, 96)},
+            {"logIndex", "0x" + std::to_string(i)},
+            {"removed", false}
+        });
+    }
+    r["logs"] = std::move(arr);
+    return r;
+}
+
+static std::string envelope(const nlohmann::json& result) {
+    return nlohmann::json{{"jsonrpc", "2.0"}, {"id", 1}, {"result", result}}.dump();
+}
+
+// -----------------------------------------------------------------------------
+// Cross-check
+// -----------------------------------------------------------------------------
+static nlohmann::json random_value(std::mt19937_64& rng, int depth) {
+    static const char alphabet[] = "ab{}[]\"\\:,0x \t/\x01";
+    switch (depth > 4 ? rng() % 4 : rng() % 6) {
+    case 0: return nullptr;
+    case 1: return (int64_t)(rng() % 100000) - 50000;
+    case 2: return (rng() & 1) == 1;
+    case 3: {
+        std::string s(rng() % 90, ' ');
+        for (char& c : s) c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        return s;
+    }
+    case 4: {
+        nlohmann::json a = nlohmann::json::array();
+        for (size_t i = rng() % 5; i > 0; --i) a.push_back(random_value(rng, depth + 1));
+        return a;
+    }
+    default: {
+        nlohmann::json o = nlohmann::json::object();
+        for (size_t i = rng() % 5; i > 0; --i) o["k" + std::to_string(rng() % 50)] = random_value(rng, depth + 1);
+        return o;
+    }
+    }
+}
+
+static bool cross_check(JsonKernel k) {
+    set_json_kernel(k);
+    std::mt19937_64 rng(42);
+    for (int n = 0; n < 3000; ++n) {
+        nlohmann::json result = random_value(rng, 0);
+        std::string body = (n & 1) ? envelope(result)
+                                   : nlohmann::json{{"id", n}, {"result", result}, {"jsonrpc", "2.0"}}.dump(n % 3 ? -1 : 2);
+        std::optional<RpcView> v = rpc_extract(body);
+        if (!v || nlohmann::json::parse(v->result) != result || json_uint(v->id) != (uint64_t)((n & 1) ? 1 : n)) return false;
+        // Truncations must be rejected, never read past the end.
+        if (rpc_extract(std::string_view(body).substr(0, rng() % body.size()))) return false;
+    }
+    return true;
+}
+
+// Elements must come out whole and in order whatever the chunk boundaries.
+static bool cross_check_stream() {
+    std::mt19937_64 rng(43);
+    for (int n = 0; n < 2000; ++n) {
+        nlohmann::json result = nlohmann::json::array();
+        for (size_t i = rng() % 6; i > 0; --i) result.push_back(random_value(rng, 1));
+        nlohmann::json other = random_value(rng, 0);
+        std::string body = nlohmann::json{{"id", n}, {"jsonrpc", "2.0"}, {"result", (n % 4) ? result : other}}.dump(n % 3 ? -1 : 2);
+
+        std::vector<nlohmann::json> got;
+        RpcStreamParser stream([&](std::string_view e) { got.push_back(nlohmann::json::parse(e)); });
+        for (size_t off = 0; off < body.size();) {
+            size_t len = std::min<size_t>(body.size() - off, 1 + rng() % 40);
+            if (!stream.feed(body.data() + off, len)) return false;
+            off += len;
+        }
+        if (!stream.complete() || json_uint(stream.id()) != (uint64_t)n) return false;
+        if (n % 4) {
+            if (!stream.streamed() || nlohmann::json(got) != result) return false;
+        } else if (other.is_array() ? (!stream.streamed() || nlohmann::json(got) != other)
+                                    : (stream.streamed() || nlohmann::json::parse(stream.result()) != other)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::mt19937_64 rng(7);
+
+    const std::string quantity = envelope("0x1b4");
+    const std::string txHash = envelope(random_hex(rng, 32));
+    const std::string receipt = envelope(make_receipt(rng, 3));
+    nlohmann::json block = nlohmann::json::array();
+    for (int i = 0; i < 200; ++i) block.push_back(make_receipt(rng, rng() % 4));
+    const std::string blockReceipts = envelope(block);
+    const size_t blockIters = iters / 200 + 1;
+
+    std::printf("json extractor benchmark, %zu iterations, best kernel: %s\n", iters,
+                json_kernel_name(json_kernel()));
+    std::printf("sizes: quantity %zu B, hash %zu B, receipt %zu B, block receipts %zu B\n\n",
+                quantity.size(), txHash.size(), receipt.size(), blockReceipts.size());
+
+    std::printf("baseline (nlohmann::json::parse of the whole body)\n");
+    run("quantity", iters, quantity.size(), [&] {
+        nlohmann::json j = nlohmann::json::parse(quantity);
+        g_sink += std::strtoull(j["result"].get_ref<const std::string&>().c_str() + 2, nullptr, 16);
+    });
+    run("tx hash", iters, txHash.size(), [&] {
+        nlohmann::json j = nlohmann::json::parse(txHash);
+        g_sink += Hash32::from_hex(j["result"].get_ref<const std::string&>())->data()[0];
+    });
+    run("receipt status", iters, receipt.size(), [&] {
+        nlohmann::json j = nlohmann::json::parse(receipt);
+        g_sink += j["result"]["status"].get_ref<const std::string&>().size();
+    });
+    run("block receipts: tx hashes", blockIters, blockReceipts.size(), [&] {
+        nlohmann::json j = nlohmann::json::parse(blockReceipts);
+        for (auto& r : j["result"]) g_sink += Hash32::from_hex(r["transactionHash"].get_ref<const std::string&>())->data()[0];
+    });
+
+    JsonKernel best = json_kernel();
+    for (JsonKernel k : {JsonKernel::Scalar, JsonKernel::Sse2, JsonKernel::Avx2}) {
+        if (k > best) break;
+        if (!cross_check(k)) {
+            std::printf("\n%s: MISMATCH against nlohmann\n", json_kernel_name(k));
+            return 1;
+        }
+        set_json_kernel(k);
+        std::printf("\n%s (cross-check ok)\n", json_kernel_name(k));
+        run("quantity", iters, quantity.size(), [&] { g_sink += *json_quantity(rpc_extract(quantity)->result); });
+        run("tx hash", iters, txHash.size(), [&] { g_sink += json_hash(rpc_extract(txHash)->result)->data()[0]; });
+        run("receipt status", iters, receipt.size(), [&] {
+            g_sink += *json_quantity(*json_member(rpc_extract(receipt)->result, "status"));
+        });
+        run("receipt via rpc_result_from", iters, receipt.size(), [&] {
+            g_sink += rpc_result_from(receipt).result->size();
+        });
+        run("block receipts: tx hashes", blockIters, blockReceipts.size(), [&] {
+            std::optional<std::vector<std::string_view>> receipts = json_elements(rpc_extract(blockReceipts)->result);
+            for (std::string_view r : *receipts) g_sink += json_hash(*json_member(r, "transactionHash"))->data()[0];
+        });
+    }
+    set_json_kernel(best);
+
+    if (!cross_check_stream()) {
+        std::printf("\nstream: MISMATCH against nlohmann\n");
+        return 1;
+    }
+    std::printf("\nstreaming parser, 16 KiB chunks (cross-check ok)\n");
+    size_t peak = 0;
+    run("block receipts: tx hashes", blockIters, blockReceipts.size(), [&] {
+        RpcStreamParser stream([&](std::string_view r) {
+            g_sink += json_hash(*json_member(r, "transactionHash"))->data()[0];
+        });
+        for (size_t off = 0; off < blockReceipts.size(); off += 16384) {
+            stream.feed(blockReceipts.data() + off, std::min<size_t>(16384, blockReceipts.size() - off));
+        }
+        peak = stream.peak_buffer();
+    });
+    std::printf("  peak buffered element: %zu B of %zu B body\n", peak, blockReceipts.size());
+    std::printf("\n(sink %llu)\n", (unsigned long long)g_sink);
+    return 0;
+}
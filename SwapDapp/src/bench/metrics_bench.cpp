@@ -0,0 +1,131 @@
+/*
+ * File:        metrics_bench.cpp
+ * Created on:  2026-10-17
+ * Description: Overhead of the per-call instrumentation path. Times each
+ *              piece RpcMetrics::record() runs after a transfer - method
+ *              lookup in the request body, the registry lookup, one histogram
+ *              record - and the whole call on an idle easy handle, single
+ *              threaded and with threads hammering the same entry. The
+ *              histogram's percentiles are first checked against exact ones
+ *              on random latencies.
+ *
+ *              ./metrics_bench [iterations]   (build with -DCMAKE_BUILD_TYPE=Release)
+ */
+
+#include "rpc_metrics.hpp"
+#include "rpc_template.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+static uint64_t g_sink;   // printed at exit so results stay live
+
+template <class F>
+static void run(const char* name, size_t iters, F&& f) {
+    for (size_t i = 0; i < iters / 10 + 1; ++i) f();   // warm-up
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iters; ++i) f();
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("  %-40s %9.1f ns/op\n", name, ns / (double)iters);
+}
+
+template <class F>
+static void run_threads(const char* name, unsigned threads, size_t iters, F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> ts;
+    for (unsigned t = 0; t < threads; ++t) {
+        ts.emplace_back([&] {
+            for (size_t i = 0; i < iters; ++i) f();
+        });
+    }
+    for (auto& t : ts) t.join();
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    // Wall time over all ops: flat with thread count means no contention,
+    // as long as there are at least as many CPUs as threads.
+    std::printf("  %-40s %9.1f ns/op overall (%u threads, %u cpus)\n", name, ns / (double)(iters * threads),
+                threads, std::thread::hardware_concurrency());
+}
+
+// Reported percentiles must sit in the exact value's bucket: never below it
+// and at most one sub-bucket (1/16) above.
+static bool cross_check() {
+    std::mt19937_64 rng(42);
+    std::lognormal_distribution<double> latency(8.0, 1.5);   // ~3 ms median, long tail
+    LatencyHistogram h;
+    std::vector<uint64_t> exact;
+    for (int i = 0; i < 200000; ++i) {
+        uint64_t us = (uint64_t)latency(rng);
+        h.record(us);
+        exact.push_back(us);
+    }
+    std::sort(exact.begin(), exact.end());
+    for (double q : {0.01, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+        uint64_t want = exact[std::max<size_t>(1, (size_t)std::ceil(q * (double)exact.size())) - 1];
+        uint64_t got = h.percentile(q);
+        if (got < want || (double)got > (double)want * (1.0 + 1.0 / 16) + 1) {
+            std::printf("p%g: got %llu want %llu\n", q * 100, (unsigned long long)got, (unsigned long long)want);
+            return false;
+        }
+    }
+    return h.max_us() == exact.back() && h.count() == exact.size();
+}
+
+int main(int argc, char** argv) {
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    std::printf("rpc metrics benchmark, %zu iterations\n\n", iters);
+    if (!cross_check()) {
+        std::printf("histogram percentiles: MISMATCH against exact\n");
+        return 1;
+    }
+    std::printf("histogram percentiles: cross-check ok\n\n");
+
+    const std::string url = "https://mainnet.example.org/v3/0123456789abcdef";
+    const RpcTemplate receipt("eth_getTransactionReceipt", R"(["$0"])");
+    const std::string body = receipt.render(7, {"0x8f2c1a4e9b0d7c3f6a5e2d1c0b9a8f7e6d5c4b3a29180f7e6d5c4b3a2918f7e6"});
+
+    RpcMetrics metrics;
+    LatencyHistogram hist;
+    CURL* h = curl_easy_init();   // idle handle: getinfo answers zeros, the cost is the same
+
+    std::printf("pieces\n");
+    run("rpc_method_of(receipt request)", iters, [&] { g_sink += rpc_method_of(body).size(); });
+    run("RpcMetrics::stats (existing entry)", iters, [&] { g_sink += (uint64_t)&metrics.stats(url, "eth_call") & 1; });
+    run("LatencyHistogram::record", iters, [&] { hist.record(g_sink++ & 0xffff); });
+    run("7x curl_easy_getinfo", iters, [&] {
+        curl_off_t v = 0;
+        for (CURLINFO info : {CURLINFO_NAMELOOKUP_TIME_T, CURLINFO_CONNECT_TIME_T, CURLINFO_APPCONNECT_TIME_T,
+                              CURLINFO_PRETRANSFER_TIME_T, CURLINFO_STARTTRANSFER_TIME_T, CURLINFO_TOTAL_TIME_T,
+                              CURLINFO_SIZE_DOWNLOAD_T}) {
+            curl_easy_getinfo(h, info, &v);
+            g_sink += (uint64_t)v;
+        }
+    });
+
+    std::printf("\nwhole path\n");
+    run("RpcMetrics::record", iters, [&] { metrics.record(h, CURLE_OK, url, body); });
+    for (unsigned threads : {2u, 4u}) {
+        // Each thread gets its own handle, as transfers do.
+        run_threads("RpcMetrics::record, same entry", threads, iters / threads, [&] {
+            thread_local CURL* mine = curl_easy_init();
+            metrics.record(mine, CURLE_OK, url, body);
+        });
+    }
+
+    std::printf("\n%s", metrics.summary().c_str());
+    curl_easy_cleanup(h);
+    curl_global_cleanup();
+    std::printf("\n(sink %llu)\n", (unsigned long long)g_sink);
+    return 0;
+}
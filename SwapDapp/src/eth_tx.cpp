@@ -0,0 +1,93 @@
+/*
+ * File:        eth_tx.cpp
+ * Created on:  2026-10-17
+ * Description: EIP-1559 transaction building and signing (see eth_tx.hpp).
+ */
+
+#include "eth_tx.hpp"
+#include "json_extract.hpp"
+#include "keccak.hpp"
+#include "rlp.hpp"
+#include "rpc_batch.hpp"
+#include "rpc_coalesce.hpp"
+
+
+static constexpr uint8_t kEip1559Type = 0x02;
+
+// Fields shared by the signing payload and the signed envelope.
+static void encode_fields(Bytes& out, const Eip1559Tx& tx) {
+    rlp_uint(out, tx.chain_id);
+    rlp_uint(out, tx.nonce);
+    rlp_uint(out, tx.max_priority_fee_per_gas);
+    rlp_uint(out, tx.max_fee_per_gas);
+    rlp_uint(out, tx.gas_limit);
+    if (tx.to) {
+        rlp_bytes(out, tx.to->data(), tx.to->size());
+    } else {
+        rlp_bytes(out, nullptr, 0);
+    }
+    rlp_bytes(out, tx.value);
+    rlp_bytes(out, tx.data);
+    rlp_list(out, Bytes{});   // access list
+}
+
+// Signature scalars are integers: strip leading zeros before encoding.
+static void rlp_scalar(Bytes& out, const std::array<uint8_t, 32>& be) {
+    size_t lead = 0;
+    while (lead < be.size() && be[lead] == 0) ++lead;
+    rlp_bytes(out, be.data() + lead, be.size() - lead);
+}
+
+Bytes32 eip1559_signing_hash(const Eip1559Tx& tx) {
+    Bytes fields;
+    encode_fields(fields, tx);
+    Bytes payload{kEip1559Type};
+    rlp_list(payload, fields);
+    return keccak256(payload.data(), payload.size());
+}
+
+std::optional<SignedTx> sign_eip1559(const Eip1559Tx& tx, const Secp256k1Key& key) {
+    std::optional<Signature> sig = key.sign(eip1559_signing_hash(tx));
+    if (!sig) return std::nullopt;
+
+    Bytes fields;
+    encode_fields(fields, tx);
+    rlp_uint(fields, sig->y_parity);
+    rlp_scalar(fields, sig->r);
+    rlp_scalar(fields, sig->s);
+    Bytes raw{kEip1559Type};
+    rlp_list(raw, fields);
+
+    Keccak256::Digest h = keccak256(raw.data(), raw.size());
+    return SignedTx{to_hex(raw), Hash32(h)};
+}
+
+// -----------------------------------------------------------------------------
+// Fee quote
+// -----------------------------------------------------------------------------
+std::optional<FeeQuote> quote_fees(RpcClient& client) {
+    RpcBatch batch;
+    size_t blockSlot = batch.add("eth_getBlockByNumber", nlohmann::json::array({"latest", false}));
+    size_t tipSlot = batch.add("eth_maxPriorityFeePerGas");
+    if (!rpc_call_batch(client, batch)) return std::nullopt;
+
+    const RpcResult& block = batch[blockSlot];
+    if (!block.ok() || !block.result->is_object()) return std::nullopt;
+    std::optional<uint64_t> base = json_quantity_of(block.result->value("baseFeePerGas", nlohmann::json()));
+    if (!base) return std::nullopt;   // pre-London chain
+
+    // Nodes without eth_maxPriorityFeePerGas get a 1 gwei tip.
+    std::optional<uint64_t> tip;
+    if (batch[tipSlot].ok()) tip = json_quantity_of(*batch[tipSlot].result);
+    FeeQuote q;
+    q.max_priority_fee_per_gas = tip.value_or(1000000000ull);
+    q.max_fee_per_gas = 2 * *base + q.max_priority_fee_per_gas;
+    return q;
+}
+
+// Every swap thread asks this at startup: they share one request.
+std::optional<uint64_t> fetch_chain_id(RpcClient& client) {
+    RpcResult r = rpc_call_coalesced(client, "eth_chainId", nlohmann::json::array());
+    if (!r.ok()) return std::nullopt;
+    return json_quantity_of(*r.result);
+}
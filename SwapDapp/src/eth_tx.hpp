@@ -0,0 +1,59 @@
+/*
+ * File:        eth_tx.hpp
+ * Created on:  2026-10-17
+ * Description: In-process EIP-1559 (type 2) transactions. Builds the RLP
+ *              payload, signs keccak256(0x02 || rlp(fields)) with a local
+ *              secp256k1 key and returns the raw bytes for
+ *              eth_sendRawTransaction. No wallet round trip and no unlocked
+ *              node account are needed, so it works against any public RPC.
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "hex_codec.hpp"
+#include "rpc_client.hpp"
+#include "secp256k1.hpp"
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+struct Eip1559Tx {
+    uint64_t chain_id = 1;
+    uint64_t nonce = 0;
+    uint64_t max_priority_fee_per_gas = 0;   // wei
+    uint64_t max_fee_per_gas = 0;            // wei
+    uint64_t gas_limit = 21000;
+    std::optional<AddressBytes> to;          // nullopt: contract creation
+    Bytes value;                             // wei, big-endian without leading zeros
+    Bytes data;
+    // Access lists are always encoded empty.
+};
+
+struct SignedTx {
+    std::string raw;    // 0x-prefixed, for eth_sendRawTransaction
+    Hash32 hash;
+};
+
+// Hash that gets signed: keccak256(0x02 || rlp([chain_id .. access_list])).
+Bytes32 eip1559_signing_hash(const Eip1559Tx& tx);
+
+// nullopt only if signing fails.
+std::optional<SignedTx> sign_eip1559(const Eip1559Tx& tx, const Secp256k1Key& key);
+
+// -----------------------------------------------------------------------------
+// Fee quote
+// -----------------------------------------------------------------------------
+struct FeeQuote {
+    uint64_t max_priority_fee_per_gas = 0;
+    uint64_t max_fee_per_gas = 0;
+};
+
+// One batch: latest baseFeePerGas + eth_maxPriorityFeePerGas.
+// max_fee = 2 * base_fee + tip, which survives six full blocks of base fee growth.
+std::optional<FeeQuote> quote_fees(RpcClient& client);
+
+// One eth_chainId call.
+std::optional<uint64_t> fetch_chain_id(RpcClient& client);
@@ -0,0 +1,162 @@
+/*
+ * File:        eth_types.hpp
+ * Created on:  2026-10-17
+ * Description: Fixed-size value types for addresses (20 bytes) and hashes /
+ *              topics (32 bytes), in place of "0x..." strings.
+ *
+ *              - Trivially copyable std::array storage: no allocation, no
+ *                case or prefix normalization when used as a key.
+ *              - Equality is two (or one) SSE2 compares instead of a string
+ *                compare.
+ *              - std::hash mixes two stored words; the bytes are keccak
+ *                output, so no further hashing is needed.
+ *              - Hex is rendered only when asked, into a stack buffer
+ *                (hex()), or streamed directly with operator<<.
+ */
+
+#pragma once
+
+#include "hex_codec.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// "0x" + 2N lower-case hex chars in place.
+template <size_t N>
+struct HexText {
+    char chars[2 + 2 * N];
+
+    constexpr std::string_view view() const { return {chars, sizeof(chars)}; }
+    constexpr operator std::string_view() const { return view(); }
+    std::string str() const { return std::string(view()); }
+
+    friend std::ostream& operator<<(std::ostream& os, const HexText& t) {
+        return os.write(t.chars, (std::streamsize)sizeof(t.chars));
+    }
+};
+
+namespace eth_types_detail {
+
+constexpr int nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return 10 + c - 'a';
+    if (c >= 'A' && c <= 'F') return 10 + c - 'A';
+    return -1;
+}
+
+template <size_t N>
+inline bool bytes_equal(const uint8_t* a, const uint8_t* b) {
+#if defined(__SSE2__)
+    if constexpr (N == 20) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+        uint32_t ta, tb;
+        std::memcpy(&ta, a + 16, 4);
+        std::memcpy(&tb, b + 16, 4);
+        return _mm_movemask_epi8(eq) == 0xffff && ta == tb;
+    } else if constexpr (N == 32) {
+#if defined(__AVX2__)
+        __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)a), _mm256_loadu_si256((const __m256i*)b));
+        return _mm256_movemask_epi8(eq) == -1;
+#else
+        __m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+        __m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + 16)),
+                                    _mm_loadu_si128((const __m128i*)(b + 16)));
+        return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xffff;
+#endif
+    }
+#endif
+    return std::memcmp(a, b, N) == 0;
+}
+
+} // namespace eth_types_detail
+
+template <size_t N>
+class FixedBytes {
+public:
+    static_assert(N >= 16, "FixedBytes is meant for addresses and hashes");
+
+    constexpr FixedBytes() = default;
+    // Implicit: keys, signatures and ABI words already come as std::array.
+    constexpr FixedBytes(const std::array<uint8_t, N>& b) : b_(b) {}
+
+    // Exactly N bytes, "0x" optional, either case. Usable in constant
+    // expressions (see address_literal below).
+    static constexpr std::optional<FixedBytes> from_hex(std::string_view hex) {
+        if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+        if (hex.size() != 2 * N) return std::nullopt;
+        FixedBytes out;
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < N; ++i) {
+                int hi = eth_types_detail::nibble(hex[2 * i]), lo = eth_types_detail::nibble(hex[2 * i + 1]);
+                if (hi < 0 || lo < 0) return std::nullopt;
+                out.b_[i] = (uint8_t)(hi << 4 | lo);
+            }
+        } else if (!hex_decode(out.b_.data(), hex.data(), N)) {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    constexpr const std::array<uint8_t, N>& bytes() const { return b_; }
+    constexpr const uint8_t* data() const { return b_.data(); }
+    static constexpr size_t size() { return N; }
+    constexpr bool is_zero() const {
+        for (uint8_t v : b_) {
+            if (v) return false;
+        }
+        return true;
+    }
+
+    HexText<N> hex() const {
+        HexText<N> t;
+        t.chars[0] = '0';
+        t.chars[1] = 'x';
+        hex_encode(t.chars + 2, b_.data(), N);
+        return t;
+    }
+    // For JSON params, which need an owning string.
+    std::string hex_string() const { return hex().str(); }
+
+    friend bool operator==(const FixedBytes& a, const FixedBytes& b) {
+        return eth_types_detail::bytes_equal<N>(a.b_.data(), b.b_.data());
+    }
+
+    size_t hash() const noexcept {
+        uint64_t head, tail;
+        std::memcpy(&head, b_.data(), 8);
+        std::memcpy(&tail, b_.data() + N - 8, 8);   // vanity addresses share leading zeros
+        uint64_t h = tail ^ (head * 0x9e3779b97f4a7c15ull);
+        return (size_t)(h ^ (h >> 32));
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const FixedBytes& v) { return os << v.hex(); }
+
+private:
+    std::array<uint8_t, N> b_{};
+};
+
+using Address = FixedBytes<20>;
+using Hash32 = FixedBytes<32>;
+
+static_assert(std::is_trivially_copyable_v<Address> && sizeof(Address) == 20);
+static_assert(std::is_trivially_copyable_v<Hash32> && sizeof(Hash32) == 32);
+
+template <size_t N>
+struct std::hash<FixedBytes<N>> {
+    size_t operator()(const FixedBytes<N>& v) const noexcept { return v.hash(); }
+};
+
+// Compile-time checked literal: a malformed address fails to build.
+consteval Address address_literal(std::string_view hex) { return Address::from_hex(hex).value(); }
@@ -0,0 +1,293 @@
+/*
+ * File:        hex_codec.cpp
+ * Created on:  2026-10-17
+ * Description: Byte <-> hex conversions (see hex_codec.hpp).
+ *
+ *              Encode: split each byte into nibbles and map them through a
+ *              16-entry table with pshufb, interleaving high/low.
+ *              Decode: classify digits and letters with unsigned range checks
+ *              (c|0x20 folds upper case), then pmaddubsw joins each nibble
+ *              pair as hi * 16 + lo and packuswb narrows to bytes.
+ */
+
+#include "hex_codec.hpp"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HEX_CODEC_X86 1
+#include <immintrin.h>
+#endif
+
+static constexpr char kDigits[] = "0123456789abcdef";
+
+// Nibble value per input char, 0xff for non-hex.
+static constexpr std::array<uint8_t, 256> kNibble = [] {
+    std::array<uint8_t, 256> t{};
+    for (auto& v : t) v = 0xff;
+    for (int c = '0'; c <= '9'; ++c) t[c] = (uint8_t)(c - '0');
+    for (int c = 'a'; c <= 'f'; ++c) t[c] = (uint8_t)(10 + c - 'a');
+    for (int c = 'A'; c <= 'F'; ++c) t[c] = (uint8_t)(10 + c - 'A');
+    return t;
+}();
+
+// -----------------------------------------------------------------------------
+// Scalar
+// -----------------------------------------------------------------------------
+static void encode_scalar(char* out, const uint8_t* in, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        out[2 * i] = kDigits[in[i] >> 4];
+        out[2 * i + 1] = kDigits[in[i] & 0xf];
+    }
+}
+
+static bool decode_scalar(uint8_t* out, const char* in, size_t len) {
+    uint8_t bad = 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t hi = kNibble[(uint8_t)in[2 * i]], lo = kNibble[(uint8_t)in[2 * i + 1]];
+        bad |= (hi | lo) & 0xf0;
+        out[i] = (uint8_t)(hi << 4 | (lo & 0xf));
+    }
+    return bad == 0;
+}
+
+#ifdef HEX_CODEC_X86
+// -----------------------------------------------------------------------------
+// SSSE3: 16 bytes <-> 32 chars per step
+// -----------------------------------------------------------------------------
+__attribute__((target("ssse3")))
+static void encode_ssse3(char* out, const uint8_t* in, size_t len) {
+    const __m128i lut = _mm_loadu_si128((const __m128i*)kDigits);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    encode_scalar(out + 2 * i, in + i, len - i);
+}
+
+// 16 chars -> 16 nibble values; lanes holding a non-hex char are set in bad.
+__attribute__((target("ssse3")))
+static inline __m128i nibbles_ssse3(__m128i c, __m128i& bad) {
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    bad = _mm_or_si128(bad, _mm_andnot_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(-1)));
+    __m128i letterVal = _mm_add_epi8(letter, _mm_set1_epi8(10));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_andnot_si128(isDigit, letterVal));
+}
+
+__attribute__((target("ssse3")))
+static bool decode_ssse3(uint8_t* out, const char* in, size_t len) {
+    const __m128i weights = _mm_set1_epi16(0x0110);   // hi * 16 + lo * 1
+    __m128i bad = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i a = nibbles_ssse3(_mm_loadu_si128((const __m128i*)(in + 2 * i)), bad);
+        __m128i b = nibbles_ssse3(_mm_loadu_si128((const __m128i*)(in + 2 * i + 16)), bad);
+        __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128((__m128i*)(out + i), bytes);
+    }
+    if (_mm_movemask_epi8(bad) != 0) return false;
+    return decode_scalar(out + i, in + 2 * i, len - i);
+}
+
+// -----------------------------------------------------------------------------
+// AVX2: 32 bytes <-> 64 chars per step
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static void encode_avx2(char* out, const uint8_t* in, size_t len) {
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kDigits));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+        // Unpacks work per 128-bit lane: recombine lanes to restore byte order.
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);   // bytes 0-7 | 16-23
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);   // bytes 8-15 | 24-31
+        _mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    encode_ssse3(out + 2 * i, in + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i nibbles_avx2(__m256i c, __m256i& bad) {
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    bad = _mm256_or_si256(bad, _mm256_andnot_si256(_mm256_or_si256(isDigit, isLetter), _mm256_set1_epi8(-1)));
+    return _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, isDigit);
+}
+
+__attribute__((target("avx2")))
+static bool decode_avx2(uint8_t* out, const char* in, size_t len) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i bad = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i a = nibbles_avx2(_mm256_loadu_si256((const __m256i*)(in + 2 * i)), bad);
+        __m256i b = nibbles_avx2(_mm256_loadu_si256((const __m256i*)(in + 2 * i + 32)), bad);
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        // packus interleaves lanes (a.lo b.lo a.hi b.hi): put a's halves first.
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    if (_mm256_movemask_epi8(bad) != 0) return false;
+    return decode_ssse3(out + i, in + 2 * i, len - i);
+}
+#endif // HEX_CODEC_X86
+
+// -----------------------------------------------------------------------------
+// Dispatch
+// -----------------------------------------------------------------------------
+using EncodeFn = void (*)(char*, const uint8_t*, size_t);
+using DecodeFn = bool (*)(uint8_t*, const char*, size_t);
+
+static HexKernel best_kernel() {
+#ifdef HEX_CODEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return HexKernel::Avx2;
+    if (__builtin_cpu_supports("ssse3")) return HexKernel::Ssse3;
+#endif
+    return HexKernel::Scalar;
+}
+
+struct Dispatch {
+    HexKernel kernel;
+    EncodeFn encode;
+    DecodeFn decode;
+};
+
+static Dispatch make_dispatch(HexKernel k) {
+    switch (k) {
+#ifdef HEX_CODEC_X86
+    case HexKernel::Avx2:  return {k, encode_avx2, decode_avx2};
+    case HexKernel::Ssse3: return {k, encode_ssse3, decode_ssse3};
+#endif
+    default:               return {HexKernel::Scalar, encode_scalar, decode_scalar};
+    }
+}
+
+// Function-local statics: safe to use from other translation units' static
+// initializers.
+static HexKernel supported_kernel() {
+    static const HexKernel best = best_kernel();
+    return best;
+}
+
+static Dispatch& dispatch() {
+    static Dispatch d = make_dispatch(supported_kernel());
+    return d;
+}
+
+HexKernel hex_kernel() { return dispatch().kernel; }
+
+HexKernel set_hex_kernel(HexKernel k) {
+    dispatch() = make_dispatch(std::min(k, supported_kernel()));
+    return dispatch().kernel;
+}
+
+const char* hex_kernel_name(HexKernel k) {
+    switch (k) {
+    case HexKernel::Avx2:  return "avx2";
+    case HexKernel::Ssse3: return "ssse3";
+    default:               return "scalar";
+    }
+}
+
+// Short inputs (a quantity, a nonce) never reach a vector loop: skip the
+// indirect call for them.
+void hex_encode(char* out, const uint8_t* in, size_t len) {
+    if (len < 16) return encode_scalar(out, in, len);
+    dispatch().encode(out, in, len);
+}
+
+bool hex_decode(uint8_t* out, const char* in, size_t len) {
+    if (len < 16) return decode_scalar(out, in, len);
+    return dispatch().decode(out, in, len);
+}
+
+// -----------------------------------------------------------------------------
+// String API
+// -----------------------------------------------------------------------------
+static std::string_view strip_prefix(std::string_view hex) {
+    if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+    return hex;
+}
+
+// Decodes an odd- or even-length digit string into exactly (size + 1) / 2
+// bytes at out; an odd length gets an implied leading zero nibble.
+static bool decode_digits(uint8_t* out, std::string_view hex) {
+    if (hex.size() % 2) {
+        uint8_t lo = kNibble[(uint8_t)hex[0]];
+        if (lo > 0xf) return false;
+        *out++ = lo;
+        hex.remove_prefix(1);
+    }
+    return hex_decode(out, hex.data(), hex.size() / 2);
+}
+
+std::string to_hex(const uint8_t* data, size_t len, bool prefix) {
+    size_t off = prefix ? 2 : 0;
+    std::string out(off + 2 * len, '\0');
+    if (prefix) {
+        out[0] = '0';
+        out[1] = 'x';
+    }
+    hex_encode(out.data() + off, data, len);
+    return out;
+}
+
+std::optional<uint64_t> parse_quantity(std::string_view hex) {
+    if (hex.size() < 3 || hex[0] != '0' || (hex[1] != 'x' && hex[1] != 'X')) return std::nullopt;
+    std::string_view digits = hex.substr(2);
+    size_t lead = digits.find_first_not_of('0');
+    digits.remove_prefix(lead == std::string_view::npos ? digits.size() : lead);
+    if (digits.size() > 16) return std::nullopt;
+    uint64_t v = 0;
+    for (char c : digits) {
+        uint8_t n = kNibble[(uint8_t)c];
+        if (n == 0xff) return std::nullopt;
+        v = v << 4 | n;
+    }
+    return v;
+}
+
+std::string to_lower_ascii(std::string s) {
+    for (char& c : s) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return s;
+}
+
+std::optional<Bytes> from_hex(std::string_view hex) {
+    hex = strip_prefix(hex);
+    Bytes out((hex.size() + 1) / 2);
+    if (!decode_digits(out.data(), hex)) return std::nullopt;
+    return out;
+}
+
+std::optional<AddressBytes> parse_address(std::string_view hex) {
+    hex = strip_prefix(hex);
+    AddressBytes out{};
+    if (hex.size() != 2 * out.size() || !hex_decode(out.data(), hex.data(), out.size())) return std::nullopt;
+    return out;
+}
+
+std::optional<Bytes32> parse_word(std::string_view hex) {
+    hex = strip_prefix(hex);
+    size_t lead = hex.find_first_not_of('0');
+    hex.remove_prefix(lead == std::string_view::npos ? hex.size() : lead);
+    Bytes32 out{};
+    if (hex.size() > 2 * out.size()) return std::nullopt;
+    if (!decode_digits(out.data() + out.size() - (hex.size() + 1) / 2, hex)) return std::nullopt;
+    return out;
+}
@@ -0,0 +1,63 @@
+/*
+ * File:        hex_codec.hpp
+ * Created on:  2026-10-17
+ * Description: Byte <-> hex conversions for transaction building and keystores.
+ *              Output is lower-case; input accepts an optional "0x" prefix, either
+ *              case, and odd lengths (a leading zero nibble is implied).
+ *
+ *              The kernels are vectorized on x86-64: AVX2 (32 bytes per step)
+ *              or SSSE3 (16 bytes), picked once at startup from CPUID, with a
+ *              table-driven scalar fallback for other CPUs and for tails.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Bytes = std::vector<uint8_t>;
+using Bytes32 = std::array<uint8_t, 32>;
+using AddressBytes = std::array<uint8_t, 20>;
+
+std::string to_hex(const uint8_t* data, size_t len, bool prefix = true);
+inline std::string to_hex(const Bytes& b, bool prefix = true) { return to_hex(b.data(), b.size(), prefix); }
+
+// nullopt on any non-hex character.
+std::optional<Bytes> from_hex(std::string_view hex);
+
+// Exactly 20 bytes ("0x" optional); nullopt otherwise.
+std::optional<AddressBytes> parse_address(std::string_view hex);
+
+// "0x1b4" -> 436: "0x"-prefixed hex quantity that fits 64 bits; nullopt
+// otherwise.
+std::optional<uint64_t> parse_quantity(std::string_view hex);
+
+// ASCII lower-case copy (hex text, block tags, node error messages).
+std::string to_lower_ascii(std::string s);
+
+// Hex quantity or bytes of at most 32 bytes, left-padded to one 32-byte
+// big-endian word ("0xf4240" -> 00..0f4240); nullopt if wider or not hex.
+std::optional<Bytes32> parse_word(std::string_view hex);
+
+// -----------------------------------------------------------------------------
+// In-place kernels (no prefix handling, no allocation)
+// -----------------------------------------------------------------------------
+// Writes 2 * len lower-case hex chars to out.
+void hex_encode(char* out, const uint8_t* in, size_t len);
+
+// Decodes 2 * len hex chars (either case) into len bytes. Returns false on a
+// non-hex character; out is then partially written.
+bool hex_decode(uint8_t* out, const char* in, size_t len);
+
+enum class HexKernel { Scalar, Ssse3, Avx2 };
+
+// Kernel in use; set_hex_kernel() clamps to what the CPU supports and is meant
+// for benchmarks, not for switching while other threads are encoding.
+HexKernel hex_kernel();
+HexKernel set_hex_kernel(HexKernel k);
+const char* hex_kernel_name(HexKernel k);
@@ -0,0 +1,359 @@
+/*
+ * File:        json_extract.cpp
+ * Created on:  2026-10-17
+ * Description: Single-pass JSON-RPC field extraction (see json_extract.hpp).
+ *
+ *              Nested values are skipped 64 bytes at a time: a kernel
+ *              classifies the chunk into quote / backslash / bracket bitmasks
+ *              and a scalar loop visits only the set bits, tracking string
+ *              state, escapes and a 64-deep bracket stack. Chunks of plain
+ *              hex or log data have no bits set and cost one classify call.
+ */
+
+#include "json_extract.hpp"
+#include "hex_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_EXTRACT_X86 1
+#include <immintrin.h>
+#endif
+
+struct JsonMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t bracket;   // any of { } [ ]
+};
+
+static constexpr size_t kChunk = 64;
+
+enum : uint8_t { kQuote = 1, kBackslash = 2, kBracket = 4 };
+
+static constexpr std::array<uint8_t, 256> kClass = [] {
+    std::array<uint8_t, 256> t{};
+    t['"'] = kQuote;
+    t['\\'] = kBackslash;
+    t['{'] = t['}'] = t['['] = t[']'] = kBracket;
+    return t;
+}();
+
+// -----------------------------------------------------------------------------
+// Classify kernels: exactly kChunk bytes
+// -----------------------------------------------------------------------------
+static void classify_scalar(const char* p, JsonMasks& m) {
+    m = {};
+    for (size_t i = 0; i < kChunk; ++i) {
+        uint8_t c = kClass[(uint8_t)p[i]];
+        m.quote |= (uint64_t)(c & kQuote) << i;
+        m.backslash |= (uint64_t)((c & kBackslash) >> 1) << i;
+        m.bracket |= (uint64_t)((c & kBracket) >> 2) << i;
+    }
+}
+
+#ifdef JSON_EXTRACT_X86
+// c | 0x20 folds '[' onto '{' and ']' onto '}', and nothing else onto either.
+__attribute__((target("sse2")))
+static void classify_sse2(const char* p, JsonMasks& m) {
+    const __m128i quote = _mm_set1_epi8('"'), slash = _mm_set1_epi8('\\');
+    const __m128i fold = _mm_set1_epi8(0x20), open = _mm_set1_epi8('{'), close = _mm_set1_epi8('}');
+    m = {};
+    for (int k = 0; k < 4; ++k) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(p + 16 * k));
+        __m128i f = _mm_or_si128(c, fold);
+        uint64_t q = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, quote));
+        uint64_t b = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, slash));
+        uint64_t br = (uint16_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(f, open), _mm_cmpeq_epi8(f, close)));
+        m.quote |= q << (16 * k);
+        m.backslash |= b << (16 * k);
+        m.bracket |= br << (16 * k);
+    }
+}
+
+__attribute__((target("avx2")))
+static void classify_avx2(const char* p, JsonMasks& m) {
+    const __m256i quote = _mm256_set1_epi8('"'), slash = _mm256_set1_epi8('\\');
+    const __m256i fold = _mm256_set1_epi8(0x20), open = _mm256_set1_epi8('{'), close = _mm256_set1_epi8('}');
+    __m256i lo = _mm256_loadu_si256((const __m256i*)p);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(p + 32));
+    auto bits = [](__m256i a, __m256i b) __attribute__((target("avx2"))) {
+        return (uint64_t)(uint32_t)_mm256_movemask_epi8(a) | (uint64_t)(uint32_t)_mm256_movemask_epi8(b) << 32;
+    };
+    __m256i flo = _mm256_or_si256(lo, fold), fhi = _mm256_or_si256(hi, fold);
+    m.quote = bits(_mm256_cmpeq_epi8(lo, quote), _mm256_cmpeq_epi8(hi, quote));
+    m.backslash = bits(_mm256_cmpeq_epi8(lo, slash), _mm256_cmpeq_epi8(hi, slash));
+    m.bracket = bits(_mm256_or_si256(_mm256_cmpeq_epi8(flo, open), _mm256_cmpeq_epi8(flo, close)),
+                     _mm256_or_si256(_mm256_cmpeq_epi8(fhi, open), _mm256_cmpeq_epi8(fhi, close)));
+}
+#endif // JSON_EXTRACT_X86
+
+// -----------------------------------------------------------------------------
+// Dispatch
+// -----------------------------------------------------------------------------
+using ClassifyFn = void (*)(const char*, JsonMasks&);
+
+static JsonKernel best_kernel() {
+#ifdef JSON_EXTRACT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return JsonKernel::Avx2;
+    if (__builtin_cpu_supports("sse2")) return JsonKernel::Sse2;
+#endif
+    return JsonKernel::Scalar;
+}
+
+struct Dispatch {
+    JsonKernel kernel;
+    ClassifyFn classify;
+};
+
+static Dispatch make_dispatch(JsonKernel k) {
+    switch (k) {
+#ifdef JSON_EXTRACT_X86
+    case JsonKernel::Avx2: return {k, classify_avx2};
+    case JsonKernel::Sse2: return {k, classify_sse2};
+#endif
+    default:               return {JsonKernel::Scalar, classify_scalar};
+    }
+}
+
+static JsonKernel supported_kernel() {
+    static const JsonKernel best = best_kernel();
+    return best;
+}
+
+static Dispatch& dispatch() {
+    static Dispatch d = make_dispatch(supported_kernel());
+    return d;
+}
+
+JsonKernel json_kernel() { return dispatch().kernel; }
+
+JsonKernel set_json_kernel(JsonKernel k) {
+    dispatch() = make_dispatch(std::min(k, supported_kernel()));
+    return dispatch().kernel;
+}
+
+const char* json_kernel_name(JsonKernel k) {
+    switch (k) {
+    case JsonKernel::Avx2: return "avx2";
+    case JsonKernel::Sse2: return "sse2";
+    default:               return "scalar";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Skipping values
+// -----------------------------------------------------------------------------
+// p is at '"', '{' or '['; returns one past the matching close, nullptr if
+// the input ends first or brackets do not match.
+static const char* skip_nested(const char* p, const char* end) {
+    ClassifyFn classify = dispatch().classify;
+    uint64_t stack = 0;            // bit per level: 1 = '{', 0 = '['
+    unsigned depth = 0;
+    bool inString = false;
+    const char* escapedUntil = p;  // bits before this are escaped chars
+
+    for (const char* chunk = p; chunk < end; chunk += kChunk) {
+        const char* text = chunk;
+        char tail[kChunk];
+        if ((size_t)(end - chunk) < kChunk) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, chunk, (size_t)(end - chunk));
+            text = tail;
+        }
+        JsonMasks m;
+        classify(text, m);
+        uint64_t bits = m.quote | m.backslash | m.bracket;
+
+        while (bits) {
+            unsigned i = (unsigned)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (chunk + i < escapedUntil) continue;
+            char c = text[i];
+            if (inString) {
+                if (c == '\\') escapedUntil = chunk + i + 2;
+                else if (c == '"') inString = false;
+                else continue;                        // bracket inside a string
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                if (depth == 64) return nullptr;
+                stack = stack << 1 | (c == '{');
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0 || (stack & 1) != (uint64_t)(c == '}')) return nullptr;
+                stack >>= 1;
+                --depth;
+            } else {
+                return nullptr;                       // backslash outside a string
+            }
+            if (!inString && depth == 0) return chunk + i + 1;
+        }
+    }
+    return nullptr;
+}
+
+// Keys and quantities are short: look for the closing quote directly before
+// paying for a chunk classify.
+static const char* skip_string(const char* p, const char* end) {
+    const char* stop = std::min(end, p + 1 + 32);
+    for (const char* q = p + 1; q < stop; ++q) {
+        if (*q == '"') return q + 1;
+        if (*q == '\\') break;
+    }
+    return skip_nested(p, end);
+}
+
+static bool is_ws(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+static const char* skip_ws(const char* p, const char* end) {
+    while (p < end && is_ws(*p)) ++p;
+    return p;
+}
+
+// Numbers, true / false / null: up to the next delimiter.
+static const char* skip_scalar(const char* p, const char* end) {
+    const char* start = p;
+    while (p < end && !is_ws(*p) && *p != ',' && *p != '}' && *p != ']') ++p;
+    return p == start ? nullptr : p;
+}
+
+static const char* skip_value(const char* p, const char* end) {
+    if (p >= end) return nullptr;
+    if (*p == '"') return skip_string(p, end);
+    if (*p == '{' || *p == '[') return skip_nested(p, end);
+    return skip_scalar(p, end);
+}
+
+// Calls f(key, value) for each member of the object at p until f returns
+// false. Returns one past the closing brace (or the stopping member), nullptr
+// on malformed input.
+template <class F>
+static const char* walk_object(const char* p, const char* end, F&& f) {
+    p = skip_ws(p, end);
+    if (p >= end || *p != '{') return nullptr;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == '}') return p + 1;
+    while (p < end) {
+        if (*p != '"') return nullptr;
+        const char* keyEnd = skip_string(p, end);
+        if (!keyEnd) return nullptr;
+        std::string_view key(p + 1, (size_t)(keyEnd - p - 2));
+        p = skip_ws(keyEnd, end);
+        if (p >= end || *p != ':') return nullptr;
+        p = skip_ws(p + 1, end);
+        const char* valueEnd = skip_value(p, end);
+        if (!valueEnd) return nullptr;
+        if (!f(key, std::string_view(p, (size_t)(valueEnd - p)))) return valueEnd;
+        p = skip_ws(valueEnd, end);
+        if (p < end && *p == '}') return p + 1;
+        if (p >= end || *p != ',') return nullptr;
+        p = skip_ws(p + 1, end);
+    }
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+std::optional<RpcView> rpc_extract(std::string_view body) {
+    RpcView v;
+    const char* end = body.data() + body.size();
+    const char* p = walk_object(body.data(), end, [&](std::string_view key, std::string_view value) {
+        if (key == "result") v.result = value;
+        else if (key == "error") v.error = value;
+        else if (key == "id") v.id = value;
+        return true;
+    });
+    if (!p || skip_ws(p, end) != end) return std::nullopt;
+    return v;
+}
+
+std::optional<std::string_view> json_member(std::string_view object, std::string_view key) {
+    std::optional<std::string_view> found;
+    const char* p = walk_object(object.data(), object.data() + object.size(),
+                                [&](std::string_view k, std::string_view value) {
+        if (k != key) return true;
+        found = value;
+        return false;
+    });
+    if (!p) return std::nullopt;
+    return found;
+}
+
+std::optional<std::vector<std::string_view>> json_elements(std::string_view array) {
+    const char* p = array.data();
+    const char* end = p + array.size();
+    p = skip_ws(p, end);
+    if (p >= end || *p != '[') return std::nullopt;
+    std::vector<std::string_view> out;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == ']') return out;
+    while (p < end) {
+        const char* valueEnd = skip_value(p, end);
+        if (!valueEnd) return std::nullopt;
+        out.emplace_back(p, (size_t)(valueEnd - p));
+        p = skip_ws(valueEnd, end);
+        if (p < end && *p == ']') return out;
+        if (p >= end || *p != ',') return std::nullopt;
+        p = skip_ws(p + 1, end);
+    }
+    return std::nullopt;
+}
+
+char json_kind(std::string_view value) { return value.empty() ? 0 : value.front(); }
+
+std::optional<std::string_view> json_string(std::string_view value) {
+    if (value.size() < 2 || value.front() != '"' || value.back() != '"') return std::nullopt;
+    value = value.substr(1, value.size() - 2);
+    if (value.find('\\') != std::string_view::npos) return std::nullopt;
+    return value;
+}
+
+std::optional<uint64_t> json_quantity(std::string_view value) {
+    std::optional<std::string_view> s = json_string(value);
+    return s ? parse_quantity(*s) : std::nullopt;
+}
+
+std::optional<uint64_t> json_quantity_of(const nlohmann::json& v) {
+    return v.is_string() ? parse_quantity(v.get_ref<const std::string&>()) : std::nullopt;
+}
+
+std::optional<uint256> json_uint256(std::string_view value) {
+    std::optional<std::string_view> s = json_string(value);
+    if (!s) return std::nullopt;
+    return uint256::from_hex(*s);
+}
+
+std::optional<uint64_t> json_uint(std::string_view value) {
+    if (value.empty() || value.size() > 20) return std::nullopt;
+    uint64_t v = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') return std::nullopt;
+        uint64_t d = (uint64_t)(c - '0');
+        if (v > (UINT64_MAX - d) / 10) return std::nullopt;
+        v = v * 10 + d;
+    }
+    return v;
+}
+
+std::optional<Hash32> json_hash(std::string_view value) {
+    std::optional<std::string_view> s = json_string(value);
+    if (!s) return std::nullopt;
+    return Hash32::from_hex(*s);
+}
+
+std::optional<Address> json_address(std::string_view value) {
+    std::optional<std::string_view> s = json_string(value);
+    if (!s) return std::nullopt;
+    return Address::from_hex(*s);
+}
+
+std::optional<uint64_t> rpc_result_quantity(std::optional<std::string_view> raw) {
+    if (!raw) return std::nullopt;
+    std::optional<RpcView> v = rpc_extract(*raw);
+    if (!v || !v->error.empty()) return std::nullopt;
+    return json_quantity(v->result);
+}
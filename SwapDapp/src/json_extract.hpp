@@ -0,0 +1,96 @@
+/*
+ * File:        json_extract.hpp
+ * Created on:  2026-10-17
+ * Description: Single-pass field extraction from JSON-RPC responses.
+ *
+ *              Most calls only need `result` (often a hex quantity or a hash)
+ *              or `error`. rpc_extract() walks the response body once and
+ *              returns views of those members without building a DOM; the
+ *              typed decoders then read quantities, hashes and addresses
+ *              straight from the view. Callers that need a tree parse just
+ *              the returned span with nlohmann.
+ *
+ *              Skipping over nested values is the hot loop: the scanner
+ *              jumps from one structural character ("{}[]) to the next, and
+ *              through strings to the next quote or backslash, 16 (SSE2) or
+ *              32 (AVX2) bytes at a time, with a scalar fallback.
+ *
+ *              Structure is checked (brackets match, strings terminate);
+ *              scalars are only delimited, not validated.
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "uint256.hpp"
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Response envelope
+// -----------------------------------------------------------------------------
+// Raw member spans into the response body (valid while the body is); empty
+// when the member is absent.
+struct RpcView {
+    std::string_view id;
+    std::string_view result;
+    std::string_view error;
+};
+
+// One JSON-RPC response object; nullopt if the body is not a well-formed object.
+std::optional<RpcView> rpc_extract(std::string_view body);
+
+// -----------------------------------------------------------------------------
+// Navigating values
+// -----------------------------------------------------------------------------
+// Top-level member of an object value; nullopt if absent or not an object.
+std::optional<std::string_view> json_member(std::string_view object, std::string_view key);
+
+// Element spans of an array value; nullopt if not a well-formed array.
+std::optional<std::vector<std::string_view>> json_elements(std::string_view array);
+
+// First character of the value ('{', '[', '"', 'n', ...), 0 if empty.
+char json_kind(std::string_view value);
+inline bool json_is_null(std::string_view value) { return value == "null"; }
+
+// -----------------------------------------------------------------------------
+// Typed decoders (whitespace-free views as returned above)
+// -----------------------------------------------------------------------------
+// String contents without the quotes; nullopt for non-strings and strings with
+// escapes (hex payloads never have any).
+std::optional<std::string_view> json_string(std::string_view value);
+
+// Hex quantity string ("0x1a") that fits 64 bits.
+std::optional<uint64_t> json_quantity(std::string_view value);
+// Same, for a member of an already parsed document.
+std::optional<uint64_t> json_quantity_of(const nlohmann::json& v);
+std::optional<uint256> json_uint256(std::string_view value);
+
+// Plain non-negative JSON number (request ids).
+std::optional<uint64_t> json_uint(std::string_view value);
+
+std::optional<Hash32> json_hash(std::string_view value);
+std::optional<Address> json_address(std::string_view value);
+
+// Shortcut for single-call responses that carry a quantity: nullopt on a
+// transport error, an RPC error or a result of another shape.
+std::optional<uint64_t> rpc_result_quantity(std::optional<std::string_view> raw);
+inline std::optional<uint64_t> rpc_result_quantity(const std::optional<std::string>& raw) {
+    return rpc_result_quantity(raw ? std::optional<std::string_view>(*raw) : std::nullopt);
+}
+
+// -----------------------------------------------------------------------------
+// Scanner backend
+// -----------------------------------------------------------------------------
+enum class JsonKernel { Scalar, Sse2, Avx2 };
+
+// Same contract as the hex kernels: set_json_kernel() clamps to the CPU and is
+// meant for benchmarks.
+JsonKernel json_kernel();
+JsonKernel set_json_kernel(JsonKernel k);
+const char* json_kernel_name(JsonKernel k);
@@ -0,0 +1,199 @@
+/*
+ * File:        json_stream.cpp
+ * Created on:  2026-10-17
+ * Description: Incremental JSON-RPC response parser (see json_stream.hpp).
+ *
+ *              A byte-level state machine that survives any chunk split:
+ *              string state, escapes, the open brackets and the current
+ *              top-level key all carry over between feed() calls. String
+ *              runs are copied with memchr instead of a byte at a time.
+ */
+
+#include "json_stream.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+static bool is_ws(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+// First quote or backslash in [p, end), or end.
+static const char* find_special(const char* p, const char* end) {
+    const char* q = static_cast<const char*>(std::memchr(p, '"', (size_t)(end - p)));
+    const char* stop = q ? q : end;
+    const char* b = static_cast<const char*>(std::memchr(p, '\\', (size_t)(stop - p)));
+    return b ? b : stop;
+}
+
+RpcStreamParser::RpcStreamParser(ElementFn on_element) : on_element_(std::move(on_element)) {}
+
+void RpcStreamParser::reset() {
+    ElementFn fn = std::move(on_element_);
+    *this = RpcStreamParser(std::move(fn));
+}
+
+bool RpcStreamParser::fail() {
+    failed_ = true;
+    return false;
+}
+
+void RpcStreamParser::append(const char* p, size_t n) {
+    if (readingKey_) key_.append(p, n);
+    else if (sink_) sink_->append(p, n);
+}
+
+// c is the first char of a value at depth_ (1: a member, 2: an element).
+void RpcStreamParser::begin_value(char c) {
+    if (depth_ == 1 && c == '[' && key_ == "result") {
+        streaming_ = true;
+        depth_ = 2;
+        open_.push_back('[');
+        pendingValue_ = true;
+        return;
+    }
+    valueDepth_ = depth_;
+    if (streaming_ && depth_ == 2) sink_ = &element_;
+    else if (key_ == "result") sink_ = &result_;
+    else if (key_ == "error") sink_ = &error_;
+    else if (key_ == "id") sink_ = &id_;
+    else sink_ = nullptr;
+    if (sink_) sink_->clear();
+    append(&c, 1);
+
+    if (c == '"') {
+        value_ = Value::String;
+        inString_ = true;
+    } else if (c == '{' || c == '[') {
+        value_ = Value::Container;
+        ++depth_;
+        open_.push_back(c);
+    } else {
+        value_ = Value::Scalar;
+    }
+}
+
+void RpcStreamParser::end_value() {
+    if (sink_ == &element_) {
+        peak_ = std::max(peak_, element_.size());
+        ++elements_;
+        if (on_element_) on_element_(element_);
+        element_.clear();
+    }
+    value_ = Value::None;
+    sink_ = nullptr;
+}
+
+bool RpcStreamParser::feed(const char* data, size_t len) {
+    if (failed_) return false;
+    const char* p = data;
+    const char* end = data + len;
+
+    while (p < end) {
+        if (inString_) {
+            if (escape_) {
+                escape_ = false;
+                append(p++, 1);
+                continue;
+            }
+            const char* stop = find_special(p, end);
+            append(p, (size_t)(stop - p));
+            p = stop;
+            if (p == end) break;
+            if (*p == '\\') {
+                escape_ = true;
+                append(p, 1);
+            } else if (readingKey_) {
+                readingKey_ = false;
+                inString_ = false;
+            } else {
+                append(p, 1);
+                inString_ = false;
+                if (value_ == Value::String && depth_ == valueDepth_) end_value();
+            }
+            ++p;
+            continue;
+        }
+
+        char c = *p;
+        if (value_ == Value::Scalar) {
+            if (!is_ws(c) && c != ',' && c != '}' && c != ']') {
+                append(p++, 1);
+                continue;
+            }
+            end_value();   // the delimiter is handled below
+        }
+        if (is_ws(c)) {
+            ++p;
+            continue;
+        }
+        if (done_) return fail();
+        if (pendingValue_ && c != ']') {
+            pendingValue_ = false;
+            begin_value(c);
+            ++p;
+            continue;
+        }
+
+        switch (c) {
+        case '{':
+        case '[':
+            if (depth_ == 0) {
+                if (c != '{') return fail();
+                depth_ = 1;
+                open_.push_back(c);
+                expectKey_ = true;
+                break;
+            }
+            if (value_ == Value::None) return fail();
+            append(p, 1);
+            ++depth_;
+            open_.push_back(c);
+            break;
+        case '}':
+        case ']':
+            if (depth_ == 0 || open_.back() != (c == '}' ? '{' : '[')) return fail();
+            append(p, 1);
+            --depth_;
+            open_.pop_back();
+            pendingValue_ = false;
+            if (value_ == Value::Container && depth_ == valueDepth_) {
+                end_value();
+            } else if (streaming_ && depth_ == 1) {
+                streaming_ = false;   // closing bracket of the result array
+                streamed_ = true;
+            } else if (depth_ == 0) {
+                done_ = true;
+            }
+            break;
+        case '"':
+            if (value_ == Value::None) {
+                if (depth_ != 1 || !expectKey_) return fail();
+                readingKey_ = true;
+                expectKey_ = false;
+                key_.clear();
+            } else {
+                append(p, 1);
+            }
+            inString_ = true;
+            break;
+        case ':':
+            if (value_ == Value::None) {
+                if (depth_ != 1) return fail();
+                pendingValue_ = true;
+            } else {
+                append(p, 1);
+            }
+            break;
+        case ',':
+            if (value_ != Value::None) append(p, 1);
+            else if (depth_ == 1) expectKey_ = true;
+            else if (streaming_ && depth_ == 2) pendingValue_ = true;
+            else return fail();
+            break;
+        default:
+            if (value_ == Value::None) return fail();
+            append(p, 1);
+        }
+        ++p;
+    }
+    return true;
+}
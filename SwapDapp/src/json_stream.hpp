@@ -0,0 +1,87 @@
+/*
+ * File:        json_stream.hpp
+ * Created on:  2026-10-17
+ * Description: Incremental JSON-RPC response parser fed from the curl write
+ *              callback (RpcClient::post_stream). When `result` is an array -
+ *              eth_getBlockReceipts, eth_getLogs - each element is handed to
+ *              the callback as soon as its closing bracket arrives, then
+ *              dropped, so memory is bounded by the largest element rather
+ *              than the body, and processing overlaps the transfer.
+ *
+ *              Other members (id, error, a non-array result) are small and
+ *              kept whole for after the transfer. Like json_extract, the
+ *              parser delimits values without validating scalars; elements
+ *              are checked by whatever decodes them.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class RpcStreamParser {
+public:
+    // Called once per complete element of an array result, in order. The view
+    // is only valid during the call.
+    using ElementFn = std::function<void(std::string_view)>;
+
+    explicit RpcStreamParser(ElementFn on_element);
+
+    // Consumes the next chunk; false once the input is malformed (the
+    // transfer should then be aborted).
+    bool feed(const char* data, size_t len);
+
+    // The closing brace of the response object has been seen.
+    bool complete() const { return done_ && !failed_; }
+
+    // `result` was an array and went to the callback element by element.
+    bool streamed() const { return streamed_; }
+    size_t elements() const { return elements_; }
+
+    // Raw member text when present (empty otherwise); result() stays empty
+    // for a streamed result.
+    std::string_view id() const { return id_; }
+    std::string_view result() const { return result_; }
+    std::string_view error() const { return error_; }
+
+    // Largest element buffered at once.
+    size_t peak_buffer() const { return peak_; }
+
+    void reset();
+
+private:
+    enum class Value { None, String, Container, Scalar };
+
+    bool fail();
+    void begin_value(char c);
+    void end_value();
+    void append(const char* p, size_t n);
+
+    ElementFn on_element_;
+
+    int depth_ = 0;
+    std::string open_;            // '{' / '[' per open level, so closers must match
+    bool inString_ = false;
+    bool escape_ = false;
+    bool readingKey_ = false;
+    bool expectKey_ = false;
+    bool pendingValue_ = false;   // next non-blank char starts a value
+    bool streaming_ = false;      // inside the streamed result array
+    bool streamed_ = false;
+    bool done_ = false;
+    bool failed_ = false;
+
+    std::string key_;             // current top-level key
+    Value value_ = Value::None;   // value being captured
+    int valueDepth_ = 0;
+    std::string* sink_ = nullptr; // where the value goes; nullptr discards it
+
+    std::string id_;
+    std::string result_;
+    std::string error_;
+    std::string element_;
+    size_t elements_ = 0;
+    size_t peak_ = 0;
+};
@@ -0,0 +1,111 @@
+/*
+ * File:        keccak.hpp
+ * Created on:  2026-10-17
+ * Description: Keccak-256 as Ethereum uses it (original Keccak padding 0x01, not
+ *              the FIPS-202 SHA3-256 padding 0x06). Header-only and constexpr,
+ *              so the same code hashes transactions at run time and can fold
+ *              constant inputs at compile time.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace keccak_detail {
+
+inline constexpr uint64_t kRoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+// Rotation offsets, indexed by x + 5y.
+inline constexpr int kRotations[25] = {
+    0,  1,  62, 28, 27,
+    36, 44, 6,  55, 20,
+    3,  10, 43, 25, 39,
+    41, 45, 15, 21, 8,
+    18, 2,  61, 56, 14,
+};
+
+constexpr uint64_t rotl(uint64_t v, int n) { return n == 0 ? v : (v << n) | (v >> (64 - n)); }
+
+constexpr void keccak_f(std::array<uint64_t, 25>& a) {
+    for (int round = 0; round < 24; ++round) {
+        // theta
+        uint64_t c[5] = {};
+        for (int x = 0; x < 5; ++x) c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        for (int x = 0; x < 5; ++x) {
+            uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+            for (int y = 0; y < 25; y += 5) a[x + y] ^= d;
+        }
+        // rho + pi
+        uint64_t b[25] = {};
+        for (int x = 0; x < 5; ++x) {
+            for (int y = 0; y < 5; ++y) {
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = rotl(a[x + 5 * y], kRotations[x + 5 * y]);
+            }
+        }
+        // chi
+        for (int y = 0; y < 25; y += 5) {
+            for (int x = 0; x < 5; ++x) a[x + y] = b[x + y] ^ (~b[(x + 1) % 5 + y] & b[(x + 2) % 5 + y]);
+        }
+        // iota
+        a[0] ^= kRoundConstants[round];
+    }
+}
+
+} // namespace keccak_detail
+
+// Streaming hasher: update() any number of times, then finalize() once.
+class Keccak256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+    static constexpr size_t kRate = 136;   // bytes absorbed per permutation
+
+    constexpr void update(const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) absorb(data[i]);
+    }
+    constexpr void update(std::string_view s) {
+        for (char c : s) absorb(static_cast<uint8_t>(c));
+    }
+
+    constexpr Digest finalize() {
+        state_[pos_ / 8] ^= uint64_t(0x01) << (8 * (pos_ % 8));
+        state_[(kRate - 1) / 8] ^= uint64_t(0x80) << (8 * ((kRate - 1) % 8));
+        keccak_detail::keccak_f(state_);
+        Digest out{};
+        for (size_t i = 0; i < out.size(); ++i) out[i] = static_cast<uint8_t>(state_[i / 8] >> (8 * (i % 8)));
+        return out;
+    }
+
+private:
+    constexpr void absorb(uint8_t byte) {
+        state_[pos_ / 8] ^= uint64_t(byte) << (8 * (pos_ % 8));
+        if (++pos_ == kRate) {
+            keccak_detail::keccak_f(state_);
+            pos_ = 0;
+        }
+    }
+
+    std::array<uint64_t, 25> state_{};
+    size_t pos_ = 0;
+};
+
+constexpr Keccak256::Digest keccak256(const uint8_t* data, size_t len) {
+    Keccak256 h;
+    h.update(data, len);
+    return h.finalize();
+}
+
+constexpr Keccak256::Digest keccak256(std::string_view s) {
+    Keccak256 h;
+    h.update(s);
+    return h.finalize();
+}
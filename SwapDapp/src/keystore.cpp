@@ -0,0 +1,335 @@
+/*
+ * File:        keystore.cpp
+ * Created on:  2026-10-17
+ * Description: Keystore v3 files (see keystore.hpp).
+ */
+
+#include "keystore.hpp"
+#include "hex_codec.hpp"
+#include "keccak.hpp"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct CipherFree { void operator()(EVP_CIPHER_CTX* p) const { EVP_CIPHER_CTX_free(p); } };
+
+// Wipes itself on destruction; holds derived keys and plaintext secrets.
+struct SecretBytes {
+    Bytes b;
+    explicit SecretBytes(size_t n) : b(n) {}
+    ~SecretBytes() { OPENSSL_cleanse(b.data(), b.size()); }
+};
+
+// -----------------------------------------------------------------------------
+// scrypt (RFC 7914) for parameters OpenSSL refuses
+// -----------------------------------------------------------------------------
+// EVP_PBE_scrypt enforces n < 2^(16 r). geth does not, and the Web3 Secret
+// Storage example itself (n = 2^18, r = 1, p = 8) breaks it, so those files
+// are derived here: the same PBKDF2 wrapping around a plain ROMix.
+constexpr uint64_t kScryptMaxMem = 1ull << 30;
+
+uint32_t rotl32(uint32_t v, int c) { return (v << c) | (v >> (32 - c)); }
+
+void salsa20_8(uint32_t b[16]) {
+    uint32_t x[16];
+    std::copy(b, b + 16, x);
+    for (int i = 0; i < 8; i += 2) {
+        x[4] ^= rotl32(x[0] + x[12], 7);   x[8] ^= rotl32(x[4] + x[0], 9);
+        x[12] ^= rotl32(x[8] + x[4], 13);  x[0] ^= rotl32(x[12] + x[8], 18);
+        x[9] ^= rotl32(x[5] + x[1], 7);    x[13] ^= rotl32(x[9] + x[5], 9);
+        x[1] ^= rotl32(x[13] + x[9], 13);  x[5] ^= rotl32(x[1] + x[13], 18);
+        x[14] ^= rotl32(x[10] + x[6], 7);  x[2] ^= rotl32(x[14] + x[10], 9);
+        x[6] ^= rotl32(x[2] + x[14], 13);  x[10] ^= rotl32(x[6] + x[2], 18);
+        x[3] ^= rotl32(x[15] + x[11], 7);  x[7] ^= rotl32(x[3] + x[15], 9);
+        x[11] ^= rotl32(x[7] + x[3], 13);  x[15] ^= rotl32(x[11] + x[7], 18);
+        x[1] ^= rotl32(x[0] + x[3], 7);    x[2] ^= rotl32(x[1] + x[0], 9);
+        x[3] ^= rotl32(x[2] + x[1], 13);   x[0] ^= rotl32(x[3] + x[2], 18);
+        x[6] ^= rotl32(x[5] + x[4], 7);    x[7] ^= rotl32(x[6] + x[5], 9);
+        x[4] ^= rotl32(x[7] + x[6], 13);   x[5] ^= rotl32(x[4] + x[7], 18);
+        x[11] ^= rotl32(x[10] + x[9], 7);  x[8] ^= rotl32(x[11] + x[10], 9);
+        x[9] ^= rotl32(x[8] + x[11], 13);  x[10] ^= rotl32(x[9] + x[8], 18);
+        x[12] ^= rotl32(x[15] + x[14], 7); x[13] ^= rotl32(x[12] + x[15], 9);
+        x[14] ^= rotl32(x[13] + x[12], 13); x[15] ^= rotl32(x[14] + x[13], 18);
+    }
+    for (int i = 0; i < 16; ++i) b[i] += x[i];
+}
+
+// in and out are 2 r blocks of 16 words.
+void block_mix(const uint32_t* in, uint32_t* out, uint64_t r) {
+    uint32_t x[16];
+    std::copy(in + (2 * r - 1) * 16, in + 2 * r * 16, x);
+    for (uint64_t i = 0; i < 2 * r; ++i) {
+        for (int j = 0; j < 16; ++j) x[j] ^= in[i * 16 + j];
+        salsa20_8(x);
+        // Even blocks to the first half, odd ones to the second.
+        std::copy(x, x + 16, out + ((i & 1) * r + i / 2) * 16);
+    }
+}
+
+void ro_mix(uint8_t* block, uint64_t n, uint64_t r, std::vector<uint32_t>& v, std::vector<uint32_t>& x,
+            std::vector<uint32_t>& y) {
+    const size_t words = 32 * r;
+    for (size_t i = 0; i < words; ++i) {
+        const uint8_t* p = block + 4 * i;
+        x[i] = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        std::copy(x.begin(), x.end(), v.begin() + (std::ptrdiff_t)(i * words));
+        block_mix(x.data(), y.data(), r);
+        x.swap(y);
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        uint64_t j = x[(2 * r - 1) * 16] & (n - 1);   // integerify; n is a power of two
+        for (size_t k = 0; k < words; ++k) x[k] ^= v[j * words + k];
+        block_mix(x.data(), y.data(), r);
+        x.swap(y);
+    }
+    for (size_t i = 0; i < words; ++i) {
+        uint8_t* p = block + 4 * i;
+        p[0] = (uint8_t)x[i]; p[1] = (uint8_t)(x[i] >> 8); p[2] = (uint8_t)(x[i] >> 16); p[3] = (uint8_t)(x[i] >> 24);
+    }
+}
+
+bool scrypt_fallback(const std::string& password, const Bytes& salt, uint64_t n, uint64_t r, uint64_t p, Bytes& out) {
+    if (n < 2 || (n & (n - 1)) != 0 || r == 0 || p == 0 || r * p >= (1u << 30)) return false;
+    if (n > kScryptMaxMem / (128 * r) || p > kScryptMaxMem / (128 * r)) return false;
+    SecretBytes b((size_t)(128 * r * p));
+    if (PKCS5_PBKDF2_HMAC(password.data(), (int)password.size(), salt.data(), (int)salt.size(), 1, EVP_sha256(),
+                          (int)b.b.size(), b.b.data()) != 1) {
+        return false;
+    }
+    std::vector<uint32_t> v((size_t)(32 * r * n)), x((size_t)(32 * r)), y((size_t)(32 * r));
+    for (uint64_t i = 0; i < p; ++i) ro_mix(b.b.data() + i * 128 * r, n, r, v, x, y);
+    OPENSSL_cleanse(v.data(), v.size() * sizeof(uint32_t));
+    OPENSSL_cleanse(x.data(), x.size() * sizeof(uint32_t));
+    OPENSSL_cleanse(y.data(), y.size() * sizeof(uint32_t));
+    return PKCS5_PBKDF2_HMAC(password.data(), (int)password.size(), b.b.data(), (int)b.b.size(), 1, EVP_sha256(),
+                             (int)out.size(), out.data()) == 1;
+}
+
+bool derive_scrypt(const std::string& password, const Bytes& salt, uint64_t n, uint64_t r, uint64_t p, Bytes& out) {
+    if (n > kScryptMaxMem / (128 * r)) return false;
+    // scrypt needs 128 * r * (n + p + 2) bytes; OpenSSL's default cap is 32 MB.
+    uint64_t maxmem = 128 * r * (n + p + 2) + (1u << 20);
+    if (EVP_PBE_scrypt(password.data(), password.size(), salt.data(), salt.size(),
+                       n, r, p, maxmem, out.data(), out.size()) == 1) {
+        return true;
+    }
+    bool over_bound = r < 4 && n >= (1ull << (16 * r));
+    return over_bound && scrypt_fallback(password, salt, n, r, p, out);
+}
+
+bool derive_pbkdf2(const std::string& password, const Bytes& salt, int iterations, Bytes& out) {
+    return PKCS5_PBKDF2_HMAC(password.data(), (int)password.size(), salt.data(), (int)salt.size(),
+                             iterations, EVP_sha256(), (int)out.size(), out.data()) == 1;
+}
+
+// AES-128-CTR is its own inverse: the same call encrypts and decrypts.
+bool aes128_ctr(const uint8_t* key, const Bytes& iv, const Bytes& in, Bytes& out) {
+    std::unique_ptr<EVP_CIPHER_CTX, CipherFree> ctx(EVP_CIPHER_CTX_new());
+    if (!ctx || iv.size() != 16) return false;
+    out.resize(in.size());
+    int len = 0, tail = 0;
+    return EVP_EncryptInit_ex(ctx.get(), EVP_aes_128_ctr(), nullptr, key, iv.data()) == 1 &&
+           EVP_EncryptUpdate(ctx.get(), out.data(), &len, in.data(), (int)in.size()) == 1 &&
+           EVP_EncryptFinal_ex(ctx.get(), out.data() + len, &tail) == 1;
+}
+
+Keccak256::Digest keystore_mac(const Bytes& derived, const Bytes& ciphertext) {
+    Keccak256 h;
+    h.update(derived.data() + 16, 16);
+    h.update(ciphertext.data(), ciphertext.size());
+    return h.finalize();
+}
+
+std::optional<Bytes> hex_field(const nlohmann::json& obj, const char* key) {
+    if (!obj.contains(key) || !obj[key].is_string()) return std::nullopt;
+    return from_hex(obj[key].get<std::string>());
+}
+
+// "" unless obj[key] is a string; json::value() would throw on any other type.
+std::string string_field(const nlohmann::json& obj, const char* key) {
+    if (!obj.contains(key) || !obj[key].is_string()) return std::string();
+    return obj[key].get<std::string>();
+}
+
+// obj[key] as an unsigned integer in [lo, hi]; fallback when the key is absent.
+std::optional<uint64_t> uint_field(const nlohmann::json& obj, const char* key, uint64_t lo, uint64_t hi,
+                                   std::optional<uint64_t> fallback = std::nullopt) {
+    if (!obj.contains(key)) return fallback;
+    const nlohmann::json& v = obj[key];
+    // Parsed files give unsigned numbers; documents built in code may hold signed ones.
+    if (!v.is_number_integer() || (!v.is_number_unsigned() && v.get<int64_t>() < 0)) return std::nullopt;
+    uint64_t u = v.get<uint64_t>();
+    if (u < lo || u > hi) return std::nullopt;
+    return u;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Decrypt
+// -----------------------------------------------------------------------------
+std::optional<Secp256k1Key> decrypt_keystore(const nlohmann::json& keystore, const std::string& password) {
+    // geth writes "crypto"; some older tools wrote "Crypto".
+    const char* section = keystore.contains("crypto") ? "crypto" : "Crypto";
+    if (!keystore.contains(section) || !keystore[section].is_object()) {
+        std::cerr << "Error::keystore: missing crypto section\n";
+        return std::nullopt;
+    }
+    const nlohmann::json& c = keystore[section];
+    if (string_field(c, "cipher") != "aes-128-ctr") {
+        std::cerr << "Error::keystore: unsupported cipher " << string_field(c, "cipher") << "\n";
+        return std::nullopt;
+    }
+    std::optional<Bytes> ciphertext = hex_field(c, "ciphertext");
+    std::optional<Bytes> mac = hex_field(c, "mac");
+    std::optional<Bytes> iv = c.contains("cipherparams") ? hex_field(c["cipherparams"], "iv") : std::nullopt;
+    const nlohmann::json& kp = c.contains("kdfparams") ? c["kdfparams"] : nlohmann::json::object();
+    std::optional<Bytes> salt = hex_field(kp, "salt");
+    if (!ciphertext || !mac || !iv || !salt || ciphertext->size() != 32) {
+        std::cerr << "Error::keystore: malformed crypto section\n";
+        return std::nullopt;
+    }
+
+    std::optional<uint64_t> dklen = uint_field(kp, "dklen", 32, 64, 32);
+    if (!dklen) {
+        std::cerr << "Error::keystore: dklen must be a number in [32, 64]\n";
+        return std::nullopt;
+    }
+    SecretBytes derived((size_t)*dklen);
+    std::string kdf = string_field(c, "kdf");
+    bool ok = false;
+    if (kdf == "scrypt") {
+        std::optional<uint64_t> n = uint_field(kp, "n", 2, 1ull << 32);
+        std::optional<uint64_t> r = uint_field(kp, "r", 1, 1024);
+        std::optional<uint64_t> p = uint_field(kp, "p", 1, 1024);
+        if (!n || !r || !p) {
+            std::cerr << "Error::keystore: scrypt n, r and p must be positive numbers\n";
+            return std::nullopt;
+        }
+        ok = derive_scrypt(password, *salt, *n, *r, *p, derived.b);
+    } else if (kdf == "pbkdf2" && string_field(kp, "prf") == "hmac-sha256") {
+        std::optional<uint64_t> iterations = uint_field(kp, "c", 1, INT32_MAX);
+        if (!iterations) {
+            std::cerr << "Error::keystore: pbkdf2 c must be a positive number\n";
+            return std::nullopt;
+        }
+        ok = derive_pbkdf2(password, *salt, (int)*iterations, derived.b);
+    } else {
+        std::cerr << "Error::keystore: unsupported kdf " << kdf << "\n";
+        return std::nullopt;
+    }
+    if (!ok) {
+        std::cerr << "Error::keystore: key derivation failed (" << kdf << " parameters rejected)\n";
+        return std::nullopt;
+    }
+
+    Keccak256::Digest expect = keystore_mac(derived.b, *ciphertext);
+    if (mac->size() != expect.size() || CRYPTO_memcmp(mac->data(), expect.data(), expect.size()) != 0) {
+        std::cerr << "Error::keystore: wrong password (MAC mismatch)\n";
+        return std::nullopt;
+    }
+
+    SecretBytes plain(32);
+    if (!aes128_ctr(derived.b.data(), *iv, *ciphertext, plain.b)) {
+        std::cerr << "Error::keystore: decryption failed\n";
+        return std::nullopt;
+    }
+    std::array<uint8_t, 32> secret{};
+    std::copy(plain.b.begin(), plain.b.end(), secret.begin());
+    std::optional<Secp256k1Key> key = Secp256k1Key::from_secret(secret);
+    OPENSSL_cleanse(secret.data(), secret.size());
+    if (!key) {
+        std::cerr << "Error::keystore: decrypted key is not a valid secp256k1 secret\n";
+        return std::nullopt;
+    }
+
+    // The address field is optional, but when present it must match.
+    if (keystore.contains("address") && keystore["address"].is_string()) {
+        std::optional<Bytes> addr = from_hex(keystore["address"].get<std::string>());
+        if (addr && !std::equal(addr->begin(), addr->end(), key->address().begin(), key->address().end())) {
+            std::cerr << "Error::keystore: address field does not match the key\n";
+            return std::nullopt;
+        }
+    }
+    return key;
+}
+
+std::optional<Secp256k1Key> load_keystore(const std::string& path, const std::string& password) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Error::keystore: cannot open " << path << "\n";
+        return std::nullopt;
+    }
+    nlohmann::json doc = nlohmann::json::parse(in, nullptr, false);
+    if (doc.is_discarded()) {
+        std::cerr << "Error::keystore: " << path << " is not JSON\n";
+        return std::nullopt;
+    }
+    try {
+        return decrypt_keystore(doc, password);
+    } catch (const std::exception& e) {
+        // A corrupt file is a load failure, never a crash of the caller.
+        std::cerr << "Error::keystore: " << path << ": " << e.what() << "\n";
+        return std::nullopt;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Encrypt
+// -----------------------------------------------------------------------------
+std::optional<nlohmann::json> encrypt_keystore(const Secp256k1Key& key, const std::string& password,
+                                               uint64_t scrypt_n) {
+    Bytes salt(32), iv(16), uuid(16);
+    if (RAND_bytes(salt.data(), (int)salt.size()) != 1 || RAND_bytes(iv.data(), (int)iv.size()) != 1 ||
+        RAND_bytes(uuid.data(), (int)uuid.size()) != 1) {
+        return std::nullopt;
+    }
+    SecretBytes derived(32);
+    if (!derive_scrypt(password, salt, scrypt_n, 8, 1, derived.b)) return std::nullopt;
+
+    Bytes secret(key.secret().begin(), key.secret().end());
+    Bytes ciphertext;
+    bool ok = aes128_ctr(derived.b.data(), iv, secret, ciphertext);
+    OPENSSL_cleanse(secret.data(), secret.size());
+    if (!ok) return std::nullopt;
+    Keccak256::Digest mac = keystore_mac(derived.b, ciphertext);
+
+    // Random (version 4) UUID for the id field.
+    uuid[6] = (uint8_t)((uuid[6] & 0x0f) | 0x40);
+    uuid[8] = (uint8_t)((uuid[8] & 0x3f) | 0x80);
+    std::string h = to_hex(uuid, false);
+    std::string id = h.substr(0, 8) + "-" + h.substr(8, 4) + "-" + h.substr(12, 4) + "-" + h.substr(16, 4) + "-" + h.substr(20);
+
+    return nlohmann::json{
+        {"address", key.address_hex().substr(2)},
+        {"crypto", {
+            {"cipher", "aes-128-ctr"},
+            {"cipherparams", {{"iv", to_hex(iv, false)}}},
+            {"ciphertext", to_hex(ciphertext, false)},
+            {"kdf", "scrypt"},
+            {"kdfparams", {
+                {"dklen", 32},
+                {"n", scrypt_n},
+                {"p", 1},
+                {"r", 8},
+                {"salt", to_hex(salt, false)}
+            }},
+            {"mac", to_hex(mac.data(), mac.size(), false)}
+        }},
+        {"id", id},
+        {"version", 3}
+    };
+}
@@ -0,0 +1,33 @@
+/*
+ * File:        keystore.hpp
+ * Created on:  2026-10-17
+ * Description: Web3 Secret Storage (keystore v3) files, as written by geth,
+ *              clef, foundry's `cast wallet` and most wallets:
+ *              - kdf: scrypt or pbkdf2 (hmac-sha256).
+ *              - cipher: aes-128-ctr.
+ *              - mac: keccak256(derived_key[16..32] ++ ciphertext).
+ *              Every primitive comes from OpenSSL libcrypto, except scrypt
+ *              parameters it refuses (n >= 2^(16 r), as in the spec's own
+ *              example), which are derived in keystore.cpp.
+ */
+
+#pragma once
+
+#include "secp256k1.hpp"
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Decrypts a keystore document. nullopt (with a reason on stderr) for a wrong
+// password, an unsupported kdf/cipher or a malformed file.
+std::optional<Secp256k1Key> decrypt_keystore(const nlohmann::json& keystore, const std::string& password);
+
+// Reads and decrypts a keystore file.
+std::optional<Secp256k1Key> load_keystore(const std::string& path, const std::string& password);
+
+// Encrypts key with scrypt (n, r = 8, p = 1). Default n matches geth's
+// "standard" setting; tests can pass a small n to keep it fast.
+std::optional<nlohmann::json> encrypt_keystore(const Secp256k1Key& key, const std::string& password,
+                                               uint64_t scrypt_n = 262144);
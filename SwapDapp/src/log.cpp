@@ -0,0 +1,271 @@
+/*
+ * File:        log.cpp
+ * Created on:  2026-10-17
+ * Description: Asynchronous structured logger (see log.hpp).
+ *
+ *              The ring is a bounded multi-producer queue (Vyukov): each slot
+ *              carries a sequence number, producers claim a position with a
+ *              CAS on the enqueue counter, format in place and publish by
+ *              bumping the slot's sequence. The writer thread is the only
+ *              consumer, so dequeue needs no CAS.
+ */
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+static int level_from_env() {
+    const char* v = std::getenv("WEB3_LOG_LEVEL");
+    if (!v) return (int)LogLevel::Info;
+    std::string s(v);
+    for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    for (int l = (int)LogLevel::Trace; l <= (int)LogLevel::Off; ++l) {
+        if (s == log_level_name((LogLevel)l)) return l;
+    }
+    return (int)LogLevel::Info;
+}
+
+std::atomic<int> g_log_level{level_from_env()};
+
+void set_log_level(LogLevel level) { g_log_level.store((int)level, std::memory_order_relaxed); }
+LogLevel log_level() { return (LogLevel)g_log_level.load(std::memory_order_relaxed); }
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace: return "trace";
+    case LogLevel::Debug: return "debug";
+    case LogLevel::Info:  return "info";
+    case LogLevel::Warn:  return "warn";
+    case LogLevel::Error: return "error";
+    default:              return "off";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Ring
+// -----------------------------------------------------------------------------
+struct LogSlot {
+    std::atomic<size_t> seq;
+    LogLevel level;
+    uint32_t thread;
+    int64_t ts_us;
+    const char* event;
+    size_t len;
+    char text[LogEvent::kCapacity];   // ,"key":value pairs
+};
+
+static constexpr size_t kSlots = 2048;   // power of two
+
+static uint32_t thread_number() {
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t n = next.fetch_add(1, std::memory_order_relaxed);
+    return n;
+}
+
+class Logger {
+public:
+    Logger() : slots_(new LogSlot[kSlots]) {
+        for (size_t i = 0; i < kSlots; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+        if (const char* path = std::getenv("WEB3_LOG_FILE")) {
+            out_ = std::fopen(path, "a");
+            if (!out_) std::fprintf(stderr, "Error::cannot open WEB3_LOG_FILE %s\n", path);
+        }
+        if (!out_) out_ = stderr;
+        writer_ = std::thread(&Logger::run, this);
+    }
+
+    ~Logger() {
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+        if (out_ != stderr) std::fclose(out_);
+        delete[] slots_;
+    }
+
+    // nullptr when full; otherwise the caller fills the slot and calls publish.
+    LogSlot* claim(size_t& pos) {
+        pos = enq_.load(std::memory_order_relaxed);
+        for (;;) {
+            LogSlot* s = &slots_[pos & (kSlots - 1)];
+            intptr_t diff = (intptr_t)s->seq.load(std::memory_order_acquire) - (intptr_t)pos;
+            if (diff == 0) {
+                if (enq_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return s;
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            } else {
+                pos = enq_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static void publish(LogSlot* s, size_t pos) { s->seq.store(pos + 1, std::memory_order_release); }
+
+    void flush() {
+        size_t target = enq_.load(std::memory_order_acquire);
+        while (written_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        std::string batch;
+        batch.reserve(64 * 1024);
+        for (;;) {
+            bool stopping = stop_.load(std::memory_order_acquire);
+            size_t n = drain(batch);
+            if (!batch.empty()) {
+                std::fwrite(batch.data(), 1, batch.size(), out_);
+                std::fflush(out_);
+                batch.clear();
+            }
+            written_.store(deq_, std::memory_order_release);
+            if (n == 0) {
+                if (stopping) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+    size_t drain(std::string& batch) {
+        size_t n = 0;
+        for (;;) {
+            LogSlot* s = &slots_[deq_ & (kSlots - 1)];
+            if (s->seq.load(std::memory_order_acquire) != deq_ + 1) return n;
+            char head[160];
+            int len = std::snprintf(head, sizeof(head), "{\"ts_us\":%lld,\"level\":\"%s\",\"thread\":%u,\"event\":\"%s\"",
+                                    (long long)s->ts_us, log_level_name(s->level), s->thread, s->event);
+            batch.append(head, (size_t)std::max(0, std::min(len, (int)sizeof(head) - 1)));
+            batch.append(s->text, s->len);
+            batch += "}\n";
+            s->seq.store(deq_ + kSlots, std::memory_order_release);
+            ++deq_;
+            ++n;
+        }
+    }
+
+    LogSlot* slots_;
+    std::atomic<size_t> enq_{0};
+    size_t deq_ = 0;                     // writer thread only
+    std::atomic<size_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stop_{false};
+    std::FILE* out_ = nullptr;
+    std::thread writer_;
+};
+
+static Logger& logger() {
+    static Logger l;
+    return l;
+}
+
+uint64_t log_dropped() { return logger().dropped(); }
+void log_flush() { logger().flush(); }
+
+// -----------------------------------------------------------------------------
+// LogEvent
+// -----------------------------------------------------------------------------
+LogEvent::LogEvent(LogLevel level, const char* event) : slot_(logger().claim(pos_)) {
+    if (!slot_) return;
+    slot_->level = level;
+    slot_->thread = thread_number();
+    slot_->ts_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    slot_->event = event;
+    slot_->len = 0;
+}
+
+LogEvent::~LogEvent() {
+    if (slot_) Logger::publish(slot_, pos_);
+}
+
+bool LogEvent::raw(std::string_view s) {
+    if (s.size() > kCapacity - slot_->len) return false;
+    std::memcpy(slot_->text + slot_->len, s.data(), s.size());
+    slot_->len += s.size();
+    return true;
+}
+
+// reserve: room the value needs after the key.
+bool LogEvent::key(const char* k, size_t reserve) {
+    size_t n = std::strlen(k);
+    if (n + 4 + reserve > kCapacity - slot_->len) return false;
+    raw(",\"");
+    raw({k, n});
+    raw("\":");
+    return true;
+}
+
+// JSON-escaped and cut to what fits: room for the longest escape (6), the
+// "..." marker and the closing quote is kept at every step.
+LogEvent& LogEvent::str(const char* k, std::string_view value) {
+    static constexpr size_t kTail = 6 + 3 + 1;
+    if (!slot_ || !key(k, 1 + kTail)) return *this;
+    raw("\"");
+    static constexpr char kHex[] = "0123456789abcdef";
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (slot_->len + kTail > kCapacity) {
+            raw("...");
+            break;
+        }
+        unsigned char c = (unsigned char)value[i];
+        if (c == '"' || c == '\\') {
+            char esc[2] = {'\\', (char)c};
+            raw({esc, 2});
+        } else if (c == '\n') {
+            raw("\\n");
+        } else if (c < 0x20) {
+            char esc[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15]};
+            raw({esc, 6});
+        } else {
+            slot_->text[slot_->len++] = (char)c;
+        }
+    }
+    raw("\"");
+    return *this;
+}
+
+LogEvent& LogEvent::num(const char* k, int64_t value) {
+    if (!slot_) return *this;
+    char buf[24];
+    std::string_view v(buf, (size_t)(std::to_chars(buf, buf + sizeof(buf), value).ptr - buf));
+    if (key(k, v.size())) raw(v);
+    return *this;
+}
+
+LogEvent& LogEvent::num(const char* k, uint64_t value) {
+    if (!slot_) return *this;
+    char buf[24];
+    std::string_view v(buf, (size_t)(std::to_chars(buf, buf + sizeof(buf), value).ptr - buf));
+    if (key(k, v.size())) raw(v);
+    return *this;
+}
+
+// NaN and infinities have no JSON spelling: null.
+LogEvent& LogEvent::num(const char* k, double value) {
+    if (!slot_) return *this;
+    char buf[32];
+    std::string_view v = std::isfinite(value)
+        ? std::string_view(buf, (size_t)(std::to_chars(buf, buf + sizeof(buf), value).ptr - buf))
+        : std::string_view("null");
+    if (key(k, v.size())) raw(v);
+    return *this;
+}
+
+LogEvent& LogEvent::flag(const char* k, bool value) {
+    if (!slot_) return *this;
+    std::string_view v = value ? "true" : "false";
+    if (key(k, v.size())) raw(v);
+    return *this;
+}
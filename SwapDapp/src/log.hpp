@@ -0,0 +1,88 @@
+/*
+ * File:        log.hpp
+ * Created on:  2026-10-17
+ * Description: Level-gated asynchronous structured logger (JSON lines).
+ *
+ *              LOG_EVENT(LogLevel::Debug, "rpc.send").str("url", url).num("bytes", n);
+ *
+ *              - Compile time: levels below WEB3_LOG_MIN_LEVEL fold to a
+ *                constant false and the whole statement disappears.
+ *              - Run time: one relaxed atomic load (WEB3_LOG_LEVEL, default
+ *                info) guards everything else; disabled events never format.
+ *              - Enabled events are formatted straight into a slot of a
+ *                bounded lock-free ring (claimed with one CAS) and written
+ *                out by a background thread. A full ring drops the event
+ *                and counts it rather than blocking the caller.
+ *
+ *              One line per event:
+ *              {"ts_us":..,"level":"debug","thread":3,"event":"rpc.send","url":"..","bytes":120}
+ *              to stderr, or to the file named by WEB3_LOG_FILE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class LogLevel : int { Trace, Debug, Info, Warn, Error, Off };
+
+#ifndef WEB3_LOG_MIN_LEVEL
+#define WEB3_LOG_MIN_LEVEL 0   // Trace: every level compiled in
+#endif
+
+// Runtime threshold; initialized from WEB3_LOG_LEVEL at startup.
+extern std::atomic<int> g_log_level;
+
+inline bool log_enabled(LogLevel level) {
+    return (int)level >= WEB3_LOG_MIN_LEVEL && (int)level >= g_log_level.load(std::memory_order_relaxed);
+}
+
+void set_log_level(LogLevel level);
+LogLevel log_level();
+const char* log_level_name(LogLevel level);
+
+// Events lost to a full ring since start.
+uint64_t log_dropped();
+
+// Blocks until everything logged so far has been written.
+void log_flush();
+
+// -----------------------------------------------------------------------------
+// LogEvent: builder over one ring slot, published when it goes out of scope
+// -----------------------------------------------------------------------------
+class LogEvent {
+public:
+    // Fixed slot payload; longer strings are cut and end in "...".
+    static constexpr size_t kCapacity = 1000;
+
+    LogEvent(LogLevel level, const char* event);
+    ~LogEvent();
+
+    LogEvent(const LogEvent&) = delete;
+    LogEvent& operator=(const LogEvent&) = delete;
+
+    LogEvent& str(const char* key, std::string_view value);
+    LogEvent& num(const char* key, int64_t value);
+    LogEvent& num(const char* key, uint64_t value);
+    LogEvent& num(const char* key, int value) { return num(key, (int64_t)value); }
+    LogEvent& num(const char* key, unsigned value) { return num(key, (uint64_t)value); }
+    LogEvent& num(const char* key, double value);
+    LogEvent& flag(const char* key, bool value);
+
+private:
+    // False (and nothing written) when it does not fit; fields that do not
+    // fit are left out whole, so every line stays valid JSON.
+    bool key(const char* k, size_t reserve = 0);
+    bool raw(std::string_view s);
+
+    size_t pos_;              // ring position, set by the claim below
+    struct LogSlot* slot_;    // nullptr when the ring was full
+};
+
+// Expands to an if/else: as the body of another `if`, put it in braces.
+#define LOG_EVENT(level, event) \
+    if (!log_enabled(level)) {  \
+    } else                      \
+        LogEvent((level), (event))
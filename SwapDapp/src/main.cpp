@@ -7,9 +7,26 @@
  *              eth_call, then BUILDS (but does not sign) the approve + swap txs.
  *              You submit these with a browser wallet (MetaMask/Coinbase Wallet).
  *              This pattern works on any public RPC without server-side private keys.
+ *              With ETH_KEYSTORE (+ ETH_KEYSTORE_PASSWORD) set, the txs are instead
+ *              signed in-process (EIP-1559) and sent via eth_sendRawTransaction.
  *              This code was created with help of Copilot AI
  */
 
+#include "abi.hpp"
+#include "eth_tx.hpp"
+#include "eth_types.hpp"
+#include "keystore.hpp"
+#include "nonce_manager.hpp"
+#include "poll_policy.hpp"
+#include "receipt.hpp"
+#include "rpc_batch.hpp"
+#include "rpc_client.hpp"
+#include "metrics_server.hpp"
+#include "rpc_metrics.hpp"
+#include "rpc_retry.hpp"
+#include "rpc_template.hpp"
+#include "uint256.hpp"
+
 #include <iostream>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
@@ -18,26 +35,34 @@
 #include <thread>
 #include <chrono>
 #include <stdexcept>
-#include <cctype>
 #include <cstdlib>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Contract ABI
+// -----------------------------------------------------------------------------
+using Approve = abi::Function<"approve(address,uint256)">;
+using Allowance = abi::Function<"allowance(address,address)">;
+using SwapExactInSingle = abi::Function<"swapExactInSingle(address,address,uint24,uint256,uint256)">;
 
 // -----------------------------------------------------------------------------
 // Forward declarations
 // -----------------------------------------------------------------------------
-nlohmann::json wait_receipt(const std::string& url, const std::string& txhash);
-std::string pad_to_32bytes(const std::string& input);
-size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
-std::optional<std::string> rpc_call(const std::string& url, const nlohmann::json& j);
-static std::string strip0x(std::string s);
-static uint64_t hex_to_u64(std::string s);
+static std::optional<uint64_t> result_u64(const RpcResult& r);
+static std::string result_text(const RpcResult& r);
 
 // Simple helpers for env/config
 static std::string env_or(const char* key, const std::string& fallback);
-static std::string ensure_hex_0x(std::string s);
 
-// Convenience RPCs
-static std::optional<std::string> rpc_chainId(const std::string& url);
-static std::optional<std::string> rpc_estimateGas(const std::string& url, const nlohmann::json& callObj);
+// Local signing path (ETH_KEYSTORE)
+struct SignedTxPlan {
+    Address to;
+    std::string data;
+    uint64_t gas;
+    const char* label;
+};
+static int send_signed(RpcClient& client, const Secp256k1Key& key, uint64_t chainId,
+                       const std::vector<SignedTxPlan>& txs);
 
 // -----------------------------------------------------------------------------
 // Main
@@ -72,98 +97,143 @@ int main() {
     std::cout << "IN:     " << tokenIn  << "\n";
     std::cout << "OUT:    " << tokenOut << "\n";
 
-    // 2) Show chain id (11155111 expected for Sepolia)
-    if (auto cid = rpc_chainId(url)) {
-        std::cout << "chainId: " << *cid << " (hex)\n";
-    } else {
-        std::cout << "Warning: could not fetch chainId.\n";
-    }
-
-    // 3) Build ERC-20 approve calldata: approve(spender, amount)
-    std::string approveSelector = "095ea7b3"; // keccak("approve(address,uint256)") first 4 bytes
-    std::string approveData = "0x" + approveSelector + pad_to_32bytes(executor) + pad_to_32bytes(amountInHex);
-    if (approveData.rfind("0x095ea7b3", 0) != 0 || approveData.size() != 138) {
-        std::cerr << "approveData failed: size = " << approveData.size() << " data = " << approveData << "\n";
+    // One pooled client for the whole run: connections and TLS sessions are reused.
+    RpcClientOptions clientOpts;
+    clientOpts.hedge = hedge_options_from_env();   // WEB3_RPC_HEDGE
+    clientOpts.router.limits = limiter_options_from_env();   // WEB3_RPC_RATE
+    RpcClient client(url, clientOpts);
+    MetricsReporter reporter(RpcMetrics::global(), metrics_interval_from_env());   // WEB3_METRICS_INTERVAL_MS
+    MetricsServer metrics(RpcMetrics::global(), metrics_port_from_env(), &client.router());   // WEB3_METRICS_PORT
+
+    // 2) Calldata is ABI-encoded from typed arguments; selectors are computed
+    //    from the signatures at compile time (see abi.hpp).
+    std::optional<Address> fromAddr     = Address::from_hex(from);
+    std::optional<Address> executorAddr = Address::from_hex(executor);
+    std::optional<Address> tokenInAddr  = Address::from_hex(tokenIn);
+    std::optional<Address> tokenOutAddr = Address::from_hex(tokenOut);
+    std::optional<uint256> fee      = uint256::from_hex(feeHex);
+    std::optional<uint256> amountIn = uint256::from_hex(amountInHex);
+    std::optional<uint256> minOut   = uint256::from_hex(minOutHex);
+    if (!fromAddr || !executorAddr || !tokenInAddr || !tokenOutAddr) {
+        std::cerr << "ERROR: FROM, EXECUTOR, TOKEN_IN and TOKEN_OUT must be 20-byte hex addresses.\n";
+        curl_global_cleanup();
+        return 1;
     }
-
-    // 4) Try allowance via eth_call: allowance(owner, spender)
-    std::string allowanceSelector = "dd62ed3e"; // keccak("allowance(address,address)") first 4 bytes
-    std::string allowanceData = "0x" + allowanceSelector + pad_to_32bytes(from) + pad_to_32bytes(executor);
-
-    nlohmann::json allowCall = {
-        {"jsonrpc", "2.0"},
-        {"id", 2001},
-        {"method", "eth_call"},
-        {"params", nlohmann::json::array({
-            {
-                {"to", tokenIn},
-                {"data", allowanceData}
-            },
-            "latest"
-        })}
-    };
-
-    std::optional<std::string> allowResp = rpc_call(url, allowCall);
-    if (!allowResp) {
-        std::cerr << "allowance: no response\n";
+    if (!fee || !amountIn || !minOut || *fee > uint256(0xffffff)) {
+        std::cerr << "ERROR: FEE_HEX, AMOUNT_IN_HEX and MIN_OUT_HEX must be hex quantities (FEE_HEX at most 0xffffff).\n";
         curl_global_cleanup();
         return 1;
     }
-    std::cout << "\n--- allowance raw ---\n" << *allowResp << "\n";
 
-    nlohmann::json allowJson = nlohmann::json::parse(*allowResp);
-    std::string allowHex = allowJson.value("result", "0x0");
-    uint64_t allowU64 = hex_to_u64(allowHex);
-    uint64_t amountInU64 = hex_to_u64(amountInHex);
-    std::cout << "allowance(u64) = " << allowU64 << " ; amountIn(u64) = " << amountInU64 << "\n";
+    // approve(spender, amount)
+    std::string approveData = Approve::encode_hex(*executorAddr, *amountIn);
 
-    if (allowU64 >= amountInU64) {
-        std::cout << "allowance is sufficient.\n";
-    } else {
-        std::cout << "allowance is insufficient. You must send APPROVE first.\n";
-    }
+    // 3) Allowance calldata for eth_call: allowance(owner, spender)
+    std::string allowanceData = Allowance::encode_hex(*fromAddr, *executorAddr);
 
-    // 5) Build your swap calldata: swapExactInSingle(tokenIn, tokenOut, fee, amountIn, minOut)
-    //    Function selector must match your deployed SwapExecutorV3.
-    std::string swapSelector = "43ecfa0a";
-    std::string swapData = "0x" + swapSelector
-                         + pad_to_32bytes(tokenIn)
-                         + pad_to_32bytes(tokenOut)
-                         + pad_to_32bytes(feeHex)
-                         + pad_to_32bytes(amountInHex)
-                         + pad_to_32bytes(minOutHex);
-
-    if (swapData.rfind("0x43ecfa0a", 0) != 0 || swapData.size() != 330) {
-        std::cerr << "swap data failed: size = " << swapData.size() << " data = " << swapData << "\n";
-    }
+    // 4) swapExactInSingle(tokenIn, tokenOut, fee, amountIn, minOut)
+    //    The signature must match your deployed SwapExecutorV3.
+    std::string swapData = SwapExactInSingle::encode_hex(*tokenInAddr, *tokenOutAddr, *fee, *amountIn, *minOut);
 
-    // 6) Prepare TX objects (NO signing here; for public RPC you must sign in the wallet)
+    // 5) Prepare TX objects (NO signing here; for public RPC you must sign in the wallet)
     nlohmann::json approveTxObj = {
-        {"from",  ensure_hex_0x(from)},
-        {"to",    ensure_hex_0x(tokenIn)},
+        {"from",  fromAddr->hex_string()},
+        {"to",    tokenInAddr->hex_string()},
         {"data",  approveData},
         {"value", "0x0"}
     };
 
     nlohmann::json swapTxObj = {
-        {"from",  ensure_hex_0x(from)},
-        {"to",    ensure_hex_0x(executor)},
+        {"from",  fromAddr->hex_string()},
+        {"to",    executorAddr->hex_string()},
         {"data",  swapData},
         {"value", "0x0"}
     };
 
-    // 7) Optional: ask node for a gas estimate (just informative; wallets will also estimate)
-    if (auto g1 = rpc_estimateGas(url, approveTxObj)) {
-        std::cout << "approve eth_estimateGas: " << *g1 << "\n";
+    // 6) None of the reads depend on each other: chain id, allowance and both gas
+    //    estimates (informative only; wallets also estimate) go out as one batch.
+    RpcBatch batch;
+    size_t chainSlot    = batch.add("eth_chainId");
+    size_t allowSlot    = batch.add("eth_call", nlohmann::json::array({
+                              {{"to", tokenInAddr->hex_string()}, {"data", allowanceData}},
+                              "latest"
+                          }));
+    size_t approveGasSlot = batch.add("eth_estimateGas", nlohmann::json::array({approveTxObj}));
+    size_t swapGasSlot    = batch.add("eth_estimateGas", nlohmann::json::array({swapTxObj}));
+
+    if (!rpc_call_batch(client, batch)) {
+        std::cerr << "batch: no response\n";
+        curl_global_cleanup();
+        return 1;
+    }
+
+    // Chain id (11155111 expected for Sepolia)
+    if (batch[chainSlot].ok()) {
+        std::cout << "chainId: " << result_text(batch[chainSlot]) << " (hex)\n";
+    } else {
+        std::cout << "Warning: could not fetch chainId.\n";
+    }
+
+    const RpcResult& allowRes = batch[allowSlot];
+    if (!allowRes.ok()) {
+        std::cerr << "allowance error: " << allowRes.error->dump() << "\n";
+        curl_global_cleanup();
+        return 1;
+    }
+    std::cout << "\n--- allowance raw ---\n" << allowRes.result->dump() << "\n";
+
+    std::string allowHex = allowRes.result->is_string() ? allowRes.result->get<std::string>() : "0x0";
+    uint256 allowance = uint256::from_hex(allowHex).value_or(uint256());
+    std::cout << "allowance = " << to_string(allowance) << " ; amountIn = " << to_string(*amountIn) << "\n";
+
+    if (allowance >= *amountIn) {
+        std::cout << "allowance is sufficient.\n";
+    } else {
+        std::cout << "allowance is insufficient. You must send APPROVE first.\n";
+    }
+
+    if (batch[approveGasSlot].ok()) {
+        std::cout << "approve eth_estimateGas: " << result_text(batch[approveGasSlot]) << "\n";
     } else {
         std::cout << "approve eth_estimateGas: (no response)\n";
     }
-    if (auto g2 = rpc_estimateGas(url, swapTxObj)) {
-        std::cout << "swap    eth_estimateGas: " << *g2 << "\n";
+    if (batch[swapGasSlot].ok()) {
+        std::cout << "swap    eth_estimateGas: " << result_text(batch[swapGasSlot]) << "\n";
     } else {
         std::cout << "swap    eth_estimateGas: (no response)\n";
     }
 
+    // 7) Local signing: no wallet round trip, no unlocked node account
+    std::string keystorePath = env_or("ETH_KEYSTORE", "");
+    if (!keystorePath.empty()) {
+        std::optional<Secp256k1Key> key = load_keystore(keystorePath, env_or("ETH_KEYSTORE_PASSWORD", ""));
+        std::optional<uint64_t> chainId = result_u64(batch[chainSlot]);
+        if (!key || !chainId) {
+            std::cerr << "ERROR: could not load keystore or chain id; nothing sent.\n";
+            curl_global_cleanup();
+            return 1;
+        }
+        if (Address(key->address()) != *fromAddr) {
+            std::cerr << "ERROR: keystore address " << Address(key->address()) << " is not FROM " << *fromAddr << "\n";
+            curl_global_cleanup();
+            return 1;
+        }
+        // Signed transactions must only go to nodes of the chain they are signed for.
+        if (client.router().size() > 1) client.check_chain_id(*chainId);
+
+        // Estimates when the node gave them; the swap cannot be estimated before
+        // the approve is mined, so it falls back to a fixed limit.
+        uint64_t approveGas = result_u64(batch[approveGasSlot]).value_or(100000);
+        uint64_t swapGas = result_u64(batch[swapGasSlot]).value_or(500000);
+        std::vector<SignedTxPlan> plan;
+        if (allowance < *amountIn) plan.push_back({*tokenInAddr, approveData, approveGas + approveGas / 5, "approve"});
+        plan.push_back({*executorAddr, swapData, swapGas + swapGas / 5, "swap"});
+
+        int rc = send_signed(client, *key, *chainId, plan);
+        curl_global_cleanup();
+        return rc;
+    }
+
     // 8) Print ready-to-send payloads + browser snippet for MetaMask/Coinbase Wallet
     std::cout << "\n================== COPY BELOW INTO YOUR BROWSER CONSOLE ==================\n";
     std::cout << "/* 1) Approve (only if allowance is insufficient) */\n";
@@ -183,171 +253,96 @@ int main() {
 }
 
 // -----------------------------------------------------------------------------
-// JSON-RPC helpers
+// Utilities
 // -----------------------------------------------------------------------------
-std::optional<std::string> rpc_call(const std::string& url, const nlohmann::json& j) {
-    if (url.empty()) {
-        std::cerr << "Error::URL is empty\n";
-        return std::nullopt;
-    }
-
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        std::cerr << "Error::Failed to initialize CURL\n";
-        return std::nullopt;
-    }
-
-    std::string body = j.dump();
-    std::cout << "\n--- SENDING ---\n" << body << "\n--------------\n";
-    if (body.empty()) {
-        std::cerr << "Error::Request body is empty\n";
-        curl_easy_cleanup(curl);
-        return std::nullopt;
-    }
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, body.size());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    // Verbose for debugging
-    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
-    curl_easy_setopt(curl, CURLOPT_STDERR, stderr);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        std::cerr << "Error::" << curl_easy_strerror(res) << "\n";
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-        return std::nullopt;
-    }
-
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (response.empty()) {
-        std::cerr << "Error::Response is empty\n";
-        return std::nullopt;
-    }
-    return response;
+// Hex quantity result that must fit 64 bits (chain id, gas); nullopt otherwise
+static std::optional<uint64_t> result_u64(const RpcResult& r) {
+    if (!r.ok() || !r.result->is_string()) return std::nullopt;
+    std::optional<uint256> v = uint256::from_hex(r.result->get<std::string>());
+    if (!v || !v->fits_u64()) return std::nullopt;
+    return v->low_u64();
 }
 
-static std::optional<std::string> rpc_chainId(const std::string& url) {
-    nlohmann::json req = {
-        {"jsonrpc","2.0"},
-        {"id",1},
-        {"method","eth_chainId"},
-        {"params", nlohmann::json::array()}
-    };
-    if (auto raw = rpc_call(url, req)) {
-        try {
-            nlohmann::json j = nlohmann::json::parse(*raw);
-            if (j.contains("result")) return j["result"].get<std::string>();
-        } catch (...) {}
-    }
-    return std::nullopt;
+// Result for printing: the string itself, or its JSON when a node returns
+// something else (null, an object).
+static std::string result_text(const RpcResult& r) {
+    return r.result->is_string() ? r.result->get<std::string>() : r.result->dump();
 }
 
-static std::optional<std::string> rpc_estimateGas(const std::string& url, const nlohmann::json& callObj) {
-    nlohmann::json req = {
-        {"jsonrpc","2.0"},
-        {"id",42},
-        {"method","eth_estimateGas"},
-        {"params", nlohmann::json::array({callObj})}
-    };
-    if (auto raw = rpc_call(url, req)) {
-        try {
-            nlohmann::json j = nlohmann::json::parse(*raw);
-            if (j.contains("result")) return j["result"].get<std::string>();
-        } catch (...) {}
+// Signs each planned tx with consecutive nonces, submits them back-to-back via
+// eth_sendRawTransaction, then waits for all receipts.
+static int send_signed(RpcClient& client, const Secp256k1Key& key, uint64_t chainId,
+                       const std::vector<SignedTxPlan>& txs) {
+    std::optional<FeeQuote> fees = quote_fees(client);
+    if (!fees) {
+        std::cerr << "ERROR: could not quote EIP-1559 fees\n";
+        return 1;
     }
-    return std::nullopt;
-}
-
-// -----------------------------------------------------------------------------
-// Receipt polling (kept in case you later switch to programmatic signing)
-// -----------------------------------------------------------------------------
-nlohmann::json wait_receipt(const std::string& url, const std::string& txhash) {
-    for (int i = 0; i < 40; ++i) {
-        nlohmann::json req = {
-            {"jsonrpc","2.0"},
-            {"id", 1000 + i},
-            {"method","eth_getTransactionReceipt"},
-            {"params", nlohmann::json::array({txhash})}
-        };
-        std::optional<std::string> raw = rpc_call(url, req);
-        if (raw) {
-            nlohmann::json resp = nlohmann::json::parse(*raw);
-            if (!resp.contains("error") && !resp["result"].is_null()) {
-                return resp["result"];
-            }
+    const Address sender = key.address();
+    std::cout << "\nsigning as " << sender << " (chainId " << chainId << ", maxFee "
+              << fees->max_fee_per_gas << " wei, tip " << fees->max_priority_fee_per_gas << " wei)\n";
+
+    NonceManager nonces(client);
+    std::vector<std::pair<Hash32, uint64_t>> sent;   // tx hash, nonce
+    std::string body;                                // request buffer reused across sends
+    for (const SignedTxPlan& p : txs) {
+        std::optional<uint64_t> nonce = nonces.reserve(sender);
+        std::optional<Bytes> data = from_hex(p.data);
+        if (!nonce || !data) {
+            std::cerr << "ERROR: " << p.label << ": bad nonce/calldata\n";
+            return 1;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(300));
-    }
-    throw std::runtime_error("timeout waiting for receipt");
-}
-
-// -----------------------------------------------------------------------------
-// Utilities
-// -----------------------------------------------------------------------------
-size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
-    std::string* out = static_cast<std::string*>(userdata);
-    if (!out) {
-        std::cerr << "ERROR::Uploaded data pointer is null\n";
-        return 0;
-    }
-    out->append(ptr, size * nmemb);
-    return size * nmemb;
-}
 
-// Left-pad a hex string (address/uint) to 32 bytes (64 hex chars). Accepts "0x" prefix.
-std::string pad_to_32bytes(const std::string& input) {
-    std::string hex = input;
-    if (hex.rfind("0x", 0) == 0 || hex.rfind("0X", 0) == 0) {
-        hex = hex.substr(2);
-    }
-    // lowercase normalize (optional)
-    for (char &c : hex) c = std::tolower(static_cast<unsigned char>(c));
-    while (hex.length() < 64) {
-        hex = "0" + hex;
-    }
-    return hex;
-}
+        Eip1559Tx tx;
+        tx.chain_id = chainId;
+        tx.nonce = *nonce;
+        tx.max_priority_fee_per_gas = fees->max_priority_fee_per_gas;
+        tx.max_fee_per_gas = fees->max_fee_per_gas;
+        tx.gas_limit = p.gas;
+        tx.to = p.to.bytes();
+        tx.data = std::move(*data);
+        std::optional<SignedTx> signedTx = sign_eip1559(tx, key);
+        if (!signedTx) {
+            std::cerr << "ERROR: " << p.label << ": signing failed\n";
+            return 1;
+        }
 
-// Strip 0x if present
-static std::string strip0x(std::string s) {
-    if (s.rfind("0x", 0) == 0 || s.rfind("0X", 0) == 0) {
-        return s.substr(2);
+        // Resent on transient failures; the tx hash keeps a resend from
+        // counting twice.
+        static const RpcTemplate kSendRaw("eth_sendRawTransaction", R"(["$0"])");
+        RpcErrorKind kind = RpcErrorKind::None;
+        RpcResult r = rpc_call_retry(client, kSendRaw.render(body, 1, {signedTx->raw}), {}, &kind);
+        if (!r.ok()) {
+            std::cerr << p.label << " rejected (" << rpc_error_kind_name(kind) << "): " << r.error->dump() << "\n";
+            if (kind == RpcErrorKind::NonceTooLow) nonces.reset(sender);
+            else nonces.release(sender, *nonce);
+            return 1;
+        }
+        Hash32 hash = r.result->is_string() ? Hash32::from_hex(r.result->get<std::string>()).value_or(signedTx->hash)
+                                            : signedTx->hash;
+        nonces.submitted(sender, *nonce, hash);
+        std::cout << p.label << " tx: " << hash << " (nonce " << *nonce << ")\n";
+        sent.emplace_back(hash, *nonce);
     }
-    return s;
-}
 
-// Ensure 0x prefix for JSON tx fields
-static std::string ensure_hex_0x(std::string s) {
-    if (s.rfind("0x", 0) == 0 || s.rfind("0X", 0) == 0) return s;
-    return "0x" + s;
-}
-
-// Very small hex->u64 (truncates beyond 64 bits; fine for demo amounts)
-static uint64_t hex_to_u64(std::string s) {
-    s = strip0x(s);
-    if (s.size() > 16) {
-        s = s.substr(s.size() - 16);
-    }
-    uint64_t value = 0;
-    for (char c : s) {
-        value <<= 4;
-        if (c >= '0' && c <= '9') value |= (uint64_t)(c - '0');
-        else if (c >= 'a' && c <= 'f') value |= (uint64_t)(10 + c - 'a');
-        else if (c >= 'A' && c <= 'F') value |= (uint64_t)(10 + c - 'A');
+    BlockClock clock;
+    learn_block_time(client, clock);
+    AdaptivePollPolicy policy(clock);
+    int rc = 0;
+    for (size_t i = 0; i < sent.size(); ++i) {
+        try {
+            ReceiptWaitStats stats;
+            nlohmann::json rcpt = wait_receipt(client, sent[i].first.hex_string(), policy, nullptr, kPolicyReceiptTimeout, &stats);
+            nonces.confirmed(sender, sent[i].second);
+            std::cout << txs[i].label << " status: " << rcpt.value("status", "0x?")
+                      << " (" << stats.polls << " polls, " << stats.elapsed.count() << " ms)\n";
+            if (rcpt.value("status", "0x?") != "0x1") rc = 1;
+        } catch (const std::exception& e) {
+            std::cerr << txs[i].label << ": " << e.what() << "\n";
+            rc = 1;
+        }
     }
-    return value;
+    return rc;
 }
 
 // Read env or fallback
@@ -0,0 +1,275 @@
+/*
+ * File:        metrics_server.cpp
+ * Created on:  2026-10-17
+ * Description: Prometheus scrape endpoint (see metrics_server.hpp).
+ */
+
+#include "metrics_server.hpp"
+#include "log.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Exposition
+// -----------------------------------------------------------------------------
+static std::string label_value(std::string_view v) {
+    std::string out;
+    out.reserve(v.size());
+    for (char c : v) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+static void header(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+static void sample(std::string& out, const char* name, const std::string& labels, double value) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), " %.9g\n", value);
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += buf;
+}
+
+static std::string call_labels(const CallStats& s) {
+    return "endpoint=\"" + label_value(s.endpoint) + "\",method=\"" + label_value(s.method) + "\"";
+}
+
+static constexpr double kQuantiles[] = {0.5, 0.9, 0.99};
+
+static void summary(std::string& out, const char* name, const std::string& labels, const LatencyHistogram& h) {
+    std::string base = name;
+    for (double q : kQuantiles) {
+        char ql[32];
+        std::snprintf(ql, sizeof(ql), ",quantile=\"%g\"", q);
+        sample(out, name, labels + ql, (double)h.percentile(q) / 1e6);
+    }
+    sample(out, (base + "_sum").c_str(), labels, (double)h.sum_us() / 1e6);
+    sample(out, (base + "_count").c_str(), labels, (double)h.count());
+}
+
+static void endpoint_text(std::string& out, const RpcRouter& router) {
+    std::vector<EndpointHealth> health = router.health();
+    auto each = [&](const char* name, const char* type, const char* help, auto value) {
+        header(out, name, type, help);
+        for (const EndpointHealth& h : health) {
+            sample(out, name, "endpoint=\"" + label_value(h.url) + "\"", (double)value(h));
+        }
+    };
+    each("web3_rpc_endpoint_up", "gauge", "1 while the endpoint is in rotation with its breaker closed.",
+         [](const EndpointHealth& h) { return h.enabled && h.state == BreakerState::Closed; });
+    each("web3_rpc_endpoint_in_flight", "gauge", "Requests routed to the endpoint and not finished.",
+         [](const EndpointHealth& h) { return h.outstanding; });
+    each("web3_rpc_endpoint_concurrency_limit", "gauge", "Adaptive (AIMD) cap on requests in flight.",
+         [](const EndpointHealth& h) { return h.concurrency_limit; });
+    each("web3_rpc_endpoint_rate_limit", "gauge", "Token bucket rate in requests per second (0 = none).",
+         [](const EndpointHealth& h) { return h.rate_limit; });
+    each("web3_rpc_endpoint_retry_after_seconds", "gauge", "Time left of the last HTTP 429's Retry-After.",
+         [](const EndpointHealth& h) { return (double)h.retry_after.count() / 1e3; });
+    each("web3_rpc_endpoint_throttled_total", "counter", "HTTP 429 responses.",
+         [](const EndpointHealth& h) { return h.throttled; });
+}
+
+std::string prometheus_text(const RpcMetrics& metrics, const RpcRouter* router) {
+    std::string out;
+    std::vector<const CallStats*> entries = metrics.entries();
+
+    header(out, "web3_rpc_request_duration_seconds", "summary", "JSON-RPC round trip, as timed by curl.");
+    for (const CallStats* s : entries) {
+        summary(out, "web3_rpc_request_duration_seconds", call_labels(*s), s->phase(CallPhase::Total));
+    }
+
+    header(out, "web3_rpc_phase_duration_seconds", "summary",
+           "Round trip split into dns, connect, tls (new connections only), server and transfer.");
+    for (const CallStats* s : entries) {
+        for (size_t p = (size_t)CallPhase::Dns; p < (size_t)CallPhase::Count; ++p) {
+            const LatencyHistogram& h = s->phases[p];
+            if (h.count() == 0) continue;
+            summary(out, "web3_rpc_phase_duration_seconds",
+                    call_labels(*s) + ",phase=\"" + call_phase_name((CallPhase)p) + "\"", h);
+        }
+    }
+
+    struct Counter {
+        const char* name;
+        const char* help;
+        const ShardedCounter CallStats::*field;
+    };
+    static constexpr Counter kCounters[] = {
+        {"web3_rpc_requests_total", "Requests sent.", &CallStats::calls},
+        {"web3_rpc_errors_total", "Requests that failed in curl or got HTTP >= 400.", &CallStats::errors},
+        {"web3_rpc_retries_total", "Requests sent again after a failure.", &CallStats::retries},
+        {"web3_rpc_hedges_total", "Duplicates of slow reads sent to this endpoint.", &CallStats::hedges},
+        {"web3_rpc_hedge_wins_total", "Hedged duplicates that answered first.", &CallStats::hedge_wins},
+        {"web3_rpc_sent_bytes_total", "Request body bytes.", &CallStats::bytes_sent},
+        {"web3_rpc_received_bytes_total", "Response body bytes.", &CallStats::bytes_received},
+    };
+    for (const Counter& c : kCounters) {
+        header(out, c.name, "counter", c.help);
+        for (const CallStats* s : entries) sample(out, c.name, call_labels(*s), (double)(s->*c.field).value());
+    }
+
+    const ClientCounters& k = metrics.counters();
+    header(out, "web3_rpc_in_flight", "gauge", "Requests sent and not yet answered.");
+    sample(out, "web3_rpc_in_flight", "", (double)k.in_flight.gauge());
+    header(out, "web3_pending_transactions", "gauge", "Transactions waiting for a receipt.");
+    sample(out, "web3_pending_transactions", "", (double)k.pending_txs.gauge());
+
+    header(out, "web3_receipt_polls_total", "counter", "Requests made while waiting for receipts.");
+    sample(out, "web3_receipt_polls_total", "source=\"wait_receipt\"", (double)k.receipt_polls_wait.value());
+    sample(out, "web3_receipt_polls_total", "source=\"coroutine\"", (double)k.receipt_polls_coro.value());
+    sample(out, "web3_receipt_polls_total", "source=\"tracker\"", (double)k.receipt_polls_tracker.value());
+
+    // Hit rate: rate(...{result="hit"}) / rate(...) summed over result.
+    header(out, "web3_cache_lookups_total", "counter", "Cache lookups by cache and outcome.");
+    sample(out, "web3_cache_lookups_total", "cache=\"connection\",result=\"hit\"", (double)k.connections_reused.value());
+    sample(out, "web3_cache_lookups_total", "cache=\"connection\",result=\"miss\"", (double)k.connections_new.value());
+    sample(out, "web3_cache_lookups_total", "cache=\"nonce\",result=\"hit\"", (double)k.nonce_hits.value());
+    sample(out, "web3_cache_lookups_total", "cache=\"nonce\",result=\"miss\"", (double)k.nonce_misses.value());
+    sample(out, "web3_cache_lookups_total", "cache=\"single_flight\",result=\"hit\"", (double)k.coalesce_joins.value());
+    sample(out, "web3_cache_lookups_total", "cache=\"single_flight\",result=\"miss\"", (double)k.coalesce_leads.value());
+    if (router) endpoint_text(out, *router);
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Server
+// -----------------------------------------------------------------------------
+MetricsServer::MetricsServer(RpcMetrics& metrics, uint16_t port, const RpcRouter* router)
+    : metrics_(metrics), router_(router) {
+    if (port == 0) return;
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_EVENT(LogLevel::Error, "metrics.socket").str("error", std::strerror(errno));
+        return;
+    }
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // never exposed off the host
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 8) != 0 ||
+        ::pipe2(wake_, O_CLOEXEC) != 0) {
+        LOG_EVENT(LogLevel::Error, "metrics.listen").num("port", (int64_t)port).str("error", std::strerror(errno));
+        ::close(fd);
+        return;
+    }
+    listen_fd_ = fd;
+    thread_ = std::thread(&MetricsServer::run, this);
+}
+
+MetricsServer::~MetricsServer() {
+    if (thread_.joinable()) {
+        char b = 0;
+        (void)!::write(wake_[1], &b, 1);
+        thread_.join();
+    }
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+    for (int fd : wake_) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+void MetricsServer::run() {
+    for (;;) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG_EVENT(LogLevel::Error, "metrics.poll").str("error", std::strerror(errno));
+            return;
+        }
+        if (fds[1].revents) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        serve(fd);
+        ::close(fd);
+    }
+}
+
+static bool send_all(int fd, const std::string& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = ::send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        off += (size_t)n;
+    }
+    return true;
+}
+
+// HTTP/1.0-style: one request, then close. A slow client gets a second before
+// it is dropped so it cannot hold the loop.
+void MetricsServer::serve(int fd) {
+    timeval tv{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::string req;
+    char buf[1024];
+    while (req.find("\r\n\r\n") == std::string::npos && req.size() < 8192) {
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        req.append(buf, (size_t)n);
+    }
+
+    std::string body;
+    const char* status = "200 OK";
+    const char* type = "text/plain; version=0.0.4; charset=utf-8";
+    if (req.rfind("GET /metrics ", 0) == 0 || req.rfind("GET /metrics?", 0) == 0) {
+        body = prometheus_text(metrics_, router_);
+    } else if (req.rfind("GET ", 0) == 0) {
+        status = "404 Not Found";
+        type = "text/plain";
+        body = "see /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+        type = "text/plain";
+    }
+    char head[256];
+    std::snprintf(head, sizeof(head), "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                  status, type, body.size());
+    if (send_all(fd, head)) send_all(fd, body);
+}
+
+uint16_t metrics_port_from_env() {
+    const char* v = std::getenv("WEB3_METRICS_PORT");
+    if (!v) return 0;
+    char* end = nullptr;
+    long port = std::strtol(v, &end, 10);
+    if (end == v || port <= 0 || port > 65535) {
+        LOG_EVENT(LogLevel::Error, "config.invalid").str("var", "WEB3_METRICS_PORT").str("value", v);
+        return 0;
+    }
+    return (uint16_t)port;
+}
@@ -0,0 +1,57 @@
+/*
+ * File:        metrics_server.hpp
+ * Created on:  2026-10-17
+ * Description: Prometheus scrape endpoint for a long-running client.
+ *
+ *              MetricsServer listens on 127.0.0.1:<port> and answers
+ *              GET /metrics with prometheus_text(): RPC latency quantiles per
+ *              endpoint, method and phase, call / error / byte counters, and
+ *              the ClientCounters gauges (in-flight requests, pending
+ *              transactions, receipt polls, connection and nonce cache hits).
+ *              Given the client's RpcRouter it adds per-endpoint routing
+ *              state: breaker, requests in flight, the adaptive concurrency
+ *              limit, the rate limit and 429s.
+ *
+ *                  MetricsServer server(RpcMetrics::global(), metrics_port_from_env(), &client.router());
+ *
+ *              The server only reads; everything is recorded by the
+ *              transports and the receipt machinery through RpcMetrics.
+ *              Scrapes are served one at a time on the server's own thread.
+ */
+
+#pragma once
+
+#include "rpc_metrics.hpp"
+#include "rpc_router.hpp"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Prometheus text exposition format (0.0.4).
+std::string prometheus_text(const RpcMetrics& metrics, const RpcRouter* router = nullptr);
+
+class MetricsServer {
+public:
+    // Port 0 leaves the server off.
+    MetricsServer(RpcMetrics& metrics, uint16_t port, const RpcRouter* router = nullptr);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool listening() const { return listen_fd_ >= 0; }
+
+private:
+    void run();
+    void serve(int fd);
+
+    RpcMetrics& metrics_;
+    const RpcRouter* router_;
+    int listen_fd_ = -1;
+    int wake_[2] = {-1, -1};   // pipe: written to stop the accept loop
+    std::thread thread_;
+};
+
+// WEB3_METRICS_PORT, or 0 (off).
+uint16_t metrics_port_from_env();
@@ -0,0 +1,146 @@
+/*
+ * File:        nonce_manager.cpp
+ * Created on:  2026-10-17
+ * Description: Per-sender nonce allocation (see nonce_manager.hpp).
+ */
+
+#include "nonce_manager.hpp"
+#include "hex_codec.hpp"
+#include "json_extract.hpp"
+#include "log.hpp"
+#include "rpc_arena.hpp"
+#include "rpc_batch.hpp"
+#include "rpc_metrics.hpp"
+#include "rpc_template.hpp"
+
+#include <iterator>
+
+NonceManager::Account& NonceManager::account(const Address& sender) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::unique_ptr<Account>& a = accounts_[sender];
+    if (!a) a = std::make_unique<Account>();
+    return *a;
+}
+
+std::optional<uint64_t> NonceManager::fetch_count(const Address& sender, const char* tag) {
+    static const RpcTemplate kTxCount("eth_getTransactionCount", R"(["$0","$1"])");
+    thread_local std::string body;
+    ArenaScope arena;
+    std::pmr::string response(arena.resource());
+    std::optional<uint64_t> count = rpc_result_quantity(client_.post(kTxCount.render(body, 1, {sender, tag}), response));
+    if (!count) {
+        LOG_EVENT(LogLevel::Error, "nonce.fetch").str("sender", sender.hex()).str("tag", tag);
+    }
+    return count;
+}
+
+std::optional<uint64_t> NonceManager::reserve(const Address& sender) {
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);   // also serializes the one-time fetch
+    (a.loaded ? RpcMetrics::global().counters().nonce_hits : RpcMetrics::global().counters().nonce_misses).add();
+    if (!a.loaded) {
+        std::optional<uint64_t> pending = fetch_count(sender, "pending");
+        if (!pending) return std::nullopt;
+        a.next = *pending;
+        a.loaded = true;
+    }
+    if (!a.gaps.empty()) {
+        uint64_t n = *a.gaps.begin();
+        a.gaps.erase(a.gaps.begin());
+        return n;
+    }
+    return a.next++;
+}
+
+void NonceManager::submitted(const Address& sender, uint64_t nonce, const Hash32& txhash) {
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);
+    a.flight[nonce] = txhash;
+}
+
+void NonceManager::release(const Address& sender, uint64_t nonce) {
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);
+    if (!a.loaded || nonce >= a.next) return;
+    a.flight.erase(nonce);
+    if (nonce + 1 == a.next) {
+        // Top of the range: shrink it, along with any gaps now at the top.
+        --a.next;
+        while (!a.gaps.empty() && *a.gaps.rbegin() + 1 == a.next) {
+            a.gaps.erase(std::prev(a.gaps.end()));
+            --a.next;
+        }
+    } else {
+        a.gaps.insert(nonce);
+    }
+}
+
+void NonceManager::confirmed(const Address& sender, uint64_t nonce) {
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);
+    a.flight.erase(nonce);
+}
+
+std::vector<uint64_t> NonceManager::resync(const Address& sender) {
+    std::optional<uint64_t> mined = fetch_count(sender, "latest");
+    if (!mined) return {};
+
+    std::vector<std::pair<uint64_t, Hash32>> check;
+    {
+        Account& a = account(sender);
+        std::lock_guard<std::mutex> lock(a.mu);
+        a.flight.erase(a.flight.begin(), a.flight.lower_bound(*mined));
+        a.gaps.erase(a.gaps.begin(), a.gaps.lower_bound(*mined));
+        if (a.loaded && a.next < *mined) a.next = *mined;   // someone else sent from this account
+        check.assign(a.flight.begin(), a.flight.end());
+    }
+    if (check.empty()) return {};
+
+    RpcBatch batch;
+    for (const auto& c : check) batch.add("eth_getTransactionByHash", nlohmann::json::array({c.second.hex_string()}));
+    rpc_call_batch(client_, batch);
+
+    std::vector<uint64_t> dropped;
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);
+    for (size_t i = 0; i < check.size(); ++i) {
+        const RpcResult& r = batch[i];
+        if (!r.ok() || !r.result->is_null()) continue;   // known (or unknown status): leave it
+        auto it = a.flight.find(check[i].first);
+        // Skip nonces replaced or retired while the batch was out.
+        if (it == a.flight.end() || it->second != check[i].second) continue;
+        dropped.push_back(check[i].first);
+    }
+    return dropped;
+}
+
+void NonceManager::reset(const Address& sender) {
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);
+    a.loaded = false;
+    a.next = 0;
+    a.gaps.clear();
+    a.flight.clear();
+}
+
+size_t NonceManager::in_flight(const Address& sender) const {
+    Account& a = account(sender);
+    std::lock_guard<std::mutex> lock(a.mu);
+    return a.flight.size();
+}
+
+// -----------------------------------------------------------------------------
+// Error classification
+// -----------------------------------------------------------------------------
+static bool message_contains(const nlohmann::json& error, const char* needle) {
+    if (!error.is_object() || !error.contains("message") || !error["message"].is_string()) return false;
+    return to_lower_ascii(error["message"].get<std::string>()).find(needle) != std::string::npos;
+}
+
+bool is_nonce_too_low(const nlohmann::json& error) {
+    return message_contains(error, "nonce too low") || message_contains(error, "already been used");
+}
+
+bool is_replacement_underpriced(const nlohmann::json& error) {
+    return message_contains(error, "underpriced");
+}
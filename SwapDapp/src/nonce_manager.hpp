@@ -0,0 +1,86 @@
+/*
+ * File:        nonce_manager.hpp
+ * Created on:  2026-10-17
+ * Description: Per-sender nonce allocation for pipelined submission. The pending
+ *              nonce is fetched once per sender. After that, nonces are handed
+ *              out locally, so dependent transactions (approve then swap, or a
+ *              chain of transfers) can go out back-to-back and be confirmed in
+ *              the same block instead of one block time apart.
+ *
+ *              Gaps: a nonce whose submission never reached the node is
+ *              release()d and handed out again before any new one.
+ *              Replacements: submitted() with an already-recorded nonce swaps
+ *              the tracked hash.
+ *              Drops: resync() compares the in-flight set with the chain and
+ *              returns the nonces the node has lost, for the caller to resubmit.
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "rpc_client.hpp"
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class NonceManager {
+public:
+    explicit NonceManager(RpcClient& client) : client_(client) {}
+
+    NonceManager(const NonceManager&) = delete;
+    NonceManager& operator=(const NonceManager&) = delete;
+
+    // Next nonce for sender. The first call per sender (and the first after
+    // reset()) fetches eth_getTransactionCount(sender, "pending"); nullopt if
+    // that fails.
+    std::optional<uint64_t> reserve(const Address& sender);
+
+    // The tx with this nonce was accepted by the node. Calling it again for the
+    // same nonce records a replacement (speed-up or cancel).
+    void submitted(const Address& sender, uint64_t nonce, const Hash32& txhash);
+
+    // Submission failed before the node accepted it: the nonce is reused first.
+    void release(const Address& sender, uint64_t nonce);
+
+    // Receipt seen; the nonce is no longer in flight.
+    void confirmed(const Address& sender, uint64_t nonce);
+
+    // Re-reads the chain. In-flight nonces below the mined count are retired;
+    // in-flight txs the node no longer knows are returned (lowest first) so the
+    // caller can resubmit them with the same nonce or release() them.
+    std::vector<uint64_t> resync(const Address& sender);
+
+    // Forget everything about sender, e.g. after "nonce too low" from a tx sent
+    // outside this manager. The next reserve() refetches.
+    void reset(const Address& sender);
+
+    size_t in_flight(const Address& sender) const;
+
+private:
+    struct Account {
+        std::mutex mu;
+        bool loaded = false;
+        uint64_t next = 0;                       // next never-used nonce
+        std::set<uint64_t> gaps;                 // released, below next
+        std::map<uint64_t, Hash32> flight;       // nonce -> latest tx hash
+    };
+
+    Account& account(const Address& sender) const;
+    std::optional<uint64_t> fetch_count(const Address& sender, const char* tag);
+
+    RpcClient& client_;
+    mutable std::mutex mu_;   // guards accounts_ (not the accounts themselves)
+    mutable std::unordered_map<Address, std::unique_ptr<Account>> accounts_;
+};
+
+// Node error messages that mean the nonce itself was wrong, not the tx.
+bool is_nonce_too_low(const nlohmann::json& error);
+bool is_replacement_underpriced(const nlohmann::json& error);
@@ -0,0 +1,131 @@
+/*
+ * File:        poll_policy.cpp
+ * Created on:  2026-10-17
+ * Description: Receipt/tip polling strategies (see poll_policy.hpp).
+ */
+
+#include "poll_policy.hpp"
+#include "json_extract.hpp"
+#include "rpc_coalesce.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+// -----------------------------------------------------------------------------
+// BlockClock
+// -----------------------------------------------------------------------------
+void BlockClock::observe(const nlohmann::json& header) {
+    if (!header.is_object() || !header.contains("number") || !header.contains("timestamp")) return;
+    std::optional<uint64_t> number = json_quantity_of(header["number"]);
+    std::optional<uint64_t> ts = json_quantity_of(header["timestamp"]);
+    if (number && ts) observe(*number, *ts);
+}
+
+void BlockClock::observe(uint64_t number, uint64_t timestamp_sec) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (last_header_number_ != 0 && number > last_header_number_ && timestamp_sec >= last_timestamp_) {
+        // Header timestamps have 1 s resolution, so single-block samples on
+        // sub-second chains are 0 or 1000; the average still converges.
+        double sample = 1000.0 * (double)(timestamp_sec - last_timestamp_) / (double)(number - last_header_number_);
+        double weight = std::min(1.0, 0.2 * (double)(number - last_header_number_));
+        interval_ms_ = interval_ms_ == 0 ? sample : interval_ms_ + weight * (sample - interval_ms_);
+    }
+    if (number > last_header_number_) {
+        last_header_number_ = number;
+        last_timestamp_ = timestamp_sec;
+    }
+    anchor(number, std::chrono::system_clock::time_point(std::chrono::seconds(timestamp_sec)));
+}
+
+void BlockClock::observe_tip(uint64_t number) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto now = std::chrono::system_clock::now();
+    if (last_number_ != 0 && interval_ms_ >= 1 && number > last_number_) {
+        // Keep the phase of the last real header: anchoring at "now" would make
+        // every poll land later after the block than the one before.
+        auto at = last_at_ + std::chrono::milliseconds(
+            (int64_t)std::llround(interval_ms_ * (double)(number - last_number_)));
+        anchor(number, std::min(at, now));
+        return;
+    }
+    anchor(number, now);
+}
+
+void BlockClock::anchor(uint64_t number, std::chrono::system_clock::time_point at) {
+    if (number > last_number_ || (number == last_number_ && at < last_at_)) {
+        last_number_ = number;
+        last_at_ = at;
+    }
+}
+
+std::optional<std::chrono::milliseconds> BlockClock::interval() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (interval_ms_ < 1) return std::nullopt;
+    return std::chrono::milliseconds((int64_t)std::llround(interval_ms_));
+}
+
+std::optional<std::chrono::milliseconds> BlockClock::until_next_block() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (interval_ms_ < 1 || last_number_ == 0) return std::nullopt;
+    double since = (double)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now() - last_at_).count();
+    // Blocks that should have landed since the anchor are skipped over: wait
+    // for the next slot, not one that is already in the past.
+    double slots = std::floor(std::max(0.0, since) / interval_ms_) + 1;
+    return std::chrono::milliseconds((int64_t)std::llround(slots * interval_ms_ - since));
+}
+
+static std::optional<nlohmann::json> fetch_header(RpcClient& client, const std::string& tag) {
+    RpcResult r = rpc_call_coalesced(client, "eth_getBlockByNumber", nlohmann::json::array({tag, false}));
+    if (!r.ok() || !r.result->is_object()) return std::nullopt;
+    return std::move(*r.result);
+}
+
+bool learn_block_time(RpcClient& client, BlockClock& clock, uint64_t span) {
+    std::optional<nlohmann::json> latest = fetch_header(client, "latest");
+    if (!latest) return false;
+    std::optional<uint64_t> tip = json_quantity_of((*latest)["number"]);
+    if (!tip) return false;
+
+    uint64_t back = std::min(span, *tip);
+    if (back > 0) {
+        char tag[24];
+        std::snprintf(tag, sizeof(tag), "0x%llx", (unsigned long long)(*tip - back));
+        if (std::optional<nlohmann::json> older = fetch_header(client, tag)) clock.observe(*older);
+    }
+    clock.observe(*latest);
+    return clock.interval().has_value();
+}
+
+// -----------------------------------------------------------------------------
+// AdaptivePollPolicy
+// -----------------------------------------------------------------------------
+std::chrono::milliseconds AdaptivePollPolicy::next_delay(int attempt) const {
+    thread_local std::mt19937 rng{std::random_device{}()};
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    double delay;
+    std::optional<std::chrono::milliseconds> interval = clock_.interval();
+    std::optional<std::chrono::milliseconds> until = clock_.until_next_block();
+    if (interval && until) {
+        // Just after the next block; jitter only ever pushes later so a poll
+        // never lands before the block it is waiting for.
+        double block = (double)interval->count();
+        delay = (double)until->count() + block * (opts_.grace + opts_.jitter * unit(rng));
+        if (attempt > opts_.patience) {
+            // Congestion: the tx keeps missing blocks, so stop checking every one.
+            double backoff = block * std::pow(opts_.backoff, attempt - opts_.patience);
+            delay = std::max(delay, backoff * (1.0 + opts_.jitter * (2 * unit(rng) - 1)));
+        }
+    } else {
+        delay = (double)opts_.fallback_interval.count();
+        if (attempt > opts_.patience) delay *= std::pow(opts_.backoff, attempt - opts_.patience);
+        delay *= 1.0 + opts_.jitter * (2 * unit(rng) - 1);
+    }
+
+    delay = std::clamp(delay, (double)opts_.min_delay.count(), (double)opts_.max_delay.count());
+    return std::chrono::milliseconds((int64_t)delay);
+}
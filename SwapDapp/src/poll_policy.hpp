@@ -0,0 +1,101 @@
+/*
+ * File:        poll_policy.hpp
+ * Created on:  2026-10-17
+ * Description: Pluggable polling strategies for receipt and block-tip waits.
+ *              FixedPollPolicy is the old behaviour, a constant interval.
+ *              AdaptivePollPolicy reads a BlockClock, which learns the chain's
+ *              block interval from recent headers. It sleeps until just after
+ *              the next block is expected, backs off with jitter when several
+ *              blocks pass without a result, and never polls faster than the
+ *              chain produces blocks.
+ */
+
+#pragma once
+
+#include "rpc_client.hpp"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+// -----------------------------------------------------------------------------
+// PollPolicy
+// -----------------------------------------------------------------------------
+class PollPolicy {
+public:
+    virtual ~PollPolicy() = default;
+
+    // Delay before the next poll, after `attempt` polls (>= 1) came back empty.
+    // Must be safe to call from several threads at once.
+    virtual std::chrono::milliseconds next_delay(int attempt) const = 0;
+};
+
+class FixedPollPolicy : public PollPolicy {
+public:
+    explicit FixedPollPolicy(std::chrono::milliseconds interval) : interval_(interval) {}
+    std::chrono::milliseconds next_delay(int) const override { return interval_; }
+
+private:
+    std::chrono::milliseconds interval_;
+};
+
+// -----------------------------------------------------------------------------
+// BlockClock: block interval and the time of the latest block (thread-safe)
+// -----------------------------------------------------------------------------
+class BlockClock {
+public:
+    // Header as returned by eth_getBlockByNumber or pushed by newHeads
+    // ({"number": "0x..", "timestamp": "0x.."}). Ignores anything else.
+    void observe(const nlohmann::json& header);
+    void observe(uint64_t number, uint64_t timestamp_sec);
+
+    // A block number seen without its header (eth_blockNumber): re-anchors the
+    // next-block estimate to now without touching the learned interval.
+    void observe_tip(uint64_t number);
+
+    std::optional<std::chrono::milliseconds> interval() const;
+
+    // Time left until the next block is expected; nullopt until an interval is known.
+    std::optional<std::chrono::milliseconds> until_next_block() const;
+
+private:
+    void anchor(uint64_t number, std::chrono::system_clock::time_point at);
+
+    mutable std::mutex mu_;
+    uint64_t last_number_ = 0;
+    std::chrono::system_clock::time_point last_at_{};
+    uint64_t last_timestamp_ = 0;   // seconds, of the last header (not tip) seen
+    uint64_t last_header_number_ = 0;
+    double interval_ms_ = 0;        // EWMA; 0 until learned
+};
+
+// Learns the block interval from the latest header and the one `span` blocks
+// back. false when the node does not answer.
+bool learn_block_time(RpcClient& client, BlockClock& clock, uint64_t span = 10);
+
+// -----------------------------------------------------------------------------
+// AdaptivePollPolicy
+// -----------------------------------------------------------------------------
+struct AdaptivePollOptions {
+    std::chrono::milliseconds fallback_interval{1000};   // until the clock has learned anything
+    std::chrono::milliseconds min_delay{100};
+    std::chrono::milliseconds max_delay{30000};
+    double grace = 0.15;    // poll this fraction of a block after the expected time
+    int patience = 3;       // polls at block pace before backing off
+    double backoff = 1.5;   // per further empty poll, in block intervals
+    double jitter = 0.1;    // random spread, as a fraction of a block (or of the backoff)
+};
+
+class AdaptivePollPolicy : public PollPolicy {
+public:
+    explicit AdaptivePollPolicy(const BlockClock& clock, AdaptivePollOptions opts = {})
+        : clock_(clock), opts_(opts) {}
+
+    std::chrono::milliseconds next_delay(int attempt) const override;
+
+private:
+    const BlockClock& clock_;
+    AdaptivePollOptions opts_;
+};
@@ -0,0 +1,87 @@
+/*
+ * File:        receipt.cpp
+ * Created on:  2026-10-17
+ * Description: Transaction receipt waits (see receipt.hpp).
+ */
+
+#include "receipt.hpp"
+#include "json_extract.hpp"
+#include "rpc_arena.hpp"
+#include "rpc_metrics.hpp"
+#include "rpc_retry.hpp"
+#include "rpc_template.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+// A failed lookup (node behind, 5xx, rate limited, dropped connection) is
+// retried within a few hundred ms rather than left to the next poll.
+static const RetryOptions kReceiptRetry{3, std::chrono::milliseconds(25), std::chrono::milliseconds(250),
+                                        std::chrono::milliseconds(1000)};
+
+std::optional<nlohmann::json> fetch_receipt(RpcClient& client, const std::string& txhash, int id) {
+    static const RpcTemplate kReceipt("eth_getTransactionReceipt", R"(["$0"])");
+    thread_local std::string body;
+    // A pending tx (most polls) answers null: decided on the arena copy of the
+    // body, without a heap allocation or a DOM.
+    ArenaScope arena;
+    std::pmr::string response(arena.resource());
+    kReceipt.render(body, (uint64_t)id, {txhash});
+    RpcRetry retry("eth_getTransactionReceipt", kReceiptRetry);
+    RpcTransport transport;
+    for (RpcRetry::Next next = retry.start(); next == RpcRetry::Next::Send;) {
+        if (retry.attempts() > 0) rpc_retry_wait(client, retry, transport);
+        std::optional<std::string_view> raw = client.post(body, response, &transport);
+        std::optional<RpcView> v = raw ? rpc_extract(*raw) : std::nullopt;
+        if (v && v->error.empty() && !v->result.empty()) {
+            if (json_is_null(v->result)) return std::nullopt;
+            nlohmann::json rcpt = nlohmann::json::parse(v->result.begin(), v->result.end(), nullptr, false);
+            if (rcpt.is_discarded()) return std::nullopt;
+            return rcpt;
+        }
+        next = retry.on_answer(rpc_result_from(raw ? std::optional<std::string>(*raw) : std::nullopt), &transport);
+    }
+    return std::nullopt;
+}
+
+nlohmann::json wait_receipt(RpcClient& client, const std::string& txhash, const PollPolicy& policy,
+                            HeadSubscriber* heads, std::chrono::milliseconds timeout,
+                            ReceiptWaitStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + timeout;
+    ReceiptWaitStats local;
+    ReceiptWaitStats& st = stats ? *stats : local;
+    st = ReceiptWaitStats{};
+    GaugeScope pending(RpcMetrics::global().counters().pending_txs);
+    auto finish = [&](bool confirmed) {
+        st.confirmed = confirmed;
+        st.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    for (;;) {
+        ++st.polls;
+        RpcMetrics::global().counters().receipt_polls_wait.add();
+        if (auto rcpt = fetch_receipt(client, txhash, 1000 + st.polls)) {
+            finish(true);
+            return *rcpt;
+        }
+
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) break;
+
+        // Push: sleep until the next block. Otherwise (or if the socket just
+        // dropped) the policy paces the next poll.
+        if (heads && heads->connected() && heads->wait_next_head(left)) continue;
+        std::this_thread::sleep_for(std::min(left, policy.next_delay(st.polls)));
+    }
+    finish(false);
+    throw std::runtime_error("timeout waiting for receipt");
+}
+
+nlohmann::json wait_receipt(RpcClient& client, const std::string& txhash,
+                            HeadSubscriber* heads, std::chrono::milliseconds timeout) {
+    static const FixedPollPolicy legacy(kReceiptPollInterval);
+    return wait_receipt(client, txhash, legacy, heads, timeout);
+}
@@ -0,0 +1,50 @@
+/*
+ * File:        receipt.hpp
+ * Created on:  2026-10-17
+ * Description: Transaction receipt waits shared by both clients. With a connected
+ *              HeadSubscriber the receipt is fetched once per new block; without
+ *              one (or while the WebSocket is down) it polls
+ *              eth_getTransactionReceipt, paced by a PollPolicy: the legacy
+ *              fixed 300 ms, or AdaptivePollPolicy which waits for the next
+ *              expected block and backs off under congestion.
+ */
+
+#pragma once
+
+#include "poll_policy.hpp"
+#include "rpc_client.hpp"
+#include "ws_transport.hpp"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <optional>
+#include <string>
+
+// Legacy polling budget: 40 polls x 300 ms.
+inline constexpr std::chrono::milliseconds kReceiptTimeout{12000};
+inline constexpr std::chrono::milliseconds kReceiptPollInterval{300};
+// Deadline for policy-paced waits: long enough to ride out a congested mempool.
+inline constexpr std::chrono::milliseconds kPolicyReceiptTimeout{120000};
+
+// How a wait went; filled in on success and on timeout.
+struct ReceiptWaitStats {
+    int polls = 0;                         // eth_getTransactionReceipt requests made
+    std::chrono::milliseconds elapsed{0};
+    bool confirmed = false;
+};
+
+// One eth_getTransactionReceipt; nullopt while the tx is still pending.
+std::optional<nlohmann::json> fetch_receipt(RpcClient& client, const std::string& txhash, int id = 1000);
+
+// Blocks until the receipt is available; throws std::runtime_error on timeout.
+// With heads connected it checks once per pushed block; otherwise `policy`
+// decides how long to sleep between polls.
+nlohmann::json wait_receipt(RpcClient& client, const std::string& txhash, const PollPolicy& policy,
+                            HeadSubscriber* heads = nullptr,
+                            std::chrono::milliseconds timeout = kPolicyReceiptTimeout,
+                            ReceiptWaitStats* stats = nullptr);
+
+// Legacy pacing: FixedPollPolicy(kReceiptPollInterval) within kReceiptTimeout.
+nlohmann::json wait_receipt(RpcClient& client, const std::string& txhash,
+                            HeadSubscriber* heads = nullptr,
+                            std::chrono::milliseconds timeout = kReceiptTimeout);
@@ -0,0 +1,50 @@
+/*
+ * File:        rlp.cpp
+ * Created on:  2026-10-17
+ * Description: Recursive Length Prefix encoding (see rlp.hpp).
+ */
+
+#include "rlp.hpp"
+
+// Short form for payloads under 56 bytes, else offset+55+len(len) then len.
+static void rlp_header(Bytes& out, uint8_t offset, size_t len) {
+    if (len < 56) {
+        out.push_back((uint8_t)(offset + len));
+        return;
+    }
+    uint8_t be[sizeof(size_t)];
+    int n = 0;
+    for (size_t v = len; v; v >>= 8) be[n++] = (uint8_t)(v & 0xff);
+    out.push_back((uint8_t)(offset + 55 + n));
+    while (n) out.push_back(be[--n]);
+}
+
+void rlp_bytes(Bytes& out, const uint8_t* data, size_t len) {
+    if (len == 1 && data[0] < 0x80) {
+        out.push_back(data[0]);
+        return;
+    }
+    rlp_header(out, 0x80, len);
+    out.insert(out.end(), data, data + len);
+}
+
+void rlp_uint(Bytes& out, uint64_t v) {
+    uint8_t be[8];
+    int n = 0;
+    for (; v; v >>= 8) be[7 - n++] = (uint8_t)(v & 0xff);
+    rlp_bytes(out, be + 8 - n, (size_t)n);
+}
+
+void rlp_list(Bytes& out, const Bytes& payload) {
+    rlp_header(out, 0xc0, payload.size());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+std::optional<Bytes> quantity_bytes(std::string_view hex) {
+    std::optional<Bytes> b = from_hex(hex);
+    if (!b) return std::nullopt;
+    size_t lead = 0;
+    while (lead < b->size() && (*b)[lead] == 0) ++lead;
+    b->erase(b->begin(), b->begin() + (std::ptrdiff_t)lead);
+    return b;
+}
@@ -0,0 +1,29 @@
+/*
+ * File:        rlp.hpp
+ * Created on:  2026-10-17
+ * Description: Recursive Length Prefix encoding, the serialization used for
+ *              signed transactions. Items are appended to a caller-owned buffer.
+ *              A list is built by encoding its items into a scratch buffer and
+ *              then wrapping that buffer with rlp_list().
+ */
+
+#pragma once
+
+#include "hex_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte string item (a single byte below 0x80 encodes as itself).
+void rlp_bytes(Bytes& out, const uint8_t* data, size_t len);
+inline void rlp_bytes(Bytes& out, const Bytes& b) { rlp_bytes(out, b.data(), b.size()); }
+
+// Unsigned integer: big-endian with no leading zeros (0 is the empty string).
+void rlp_uint(Bytes& out, uint64_t v);
+
+// Wraps already-encoded items as one list.
+void rlp_list(Bytes& out, const Bytes& payload);
+
+// Big-endian bytes without leading zeros, for integers wider than 64 bits
+// given as a hex quantity ("0x0" -> empty). nullopt if not hex.
+std::optional<Bytes> quantity_bytes(std::string_view hex);
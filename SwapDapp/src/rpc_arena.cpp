@@ -0,0 +1,50 @@
+/*
+ * File:        rpc_arena.cpp
+ * Created on:  2026-10-17
+ * Description: Per-thread round-trip arena (see rpc_arena.hpp).
+ */
+
+#include "rpc_arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+void* RpcArena::Upstream::do_allocate(size_t bytes, size_t align) {
+    requested += bytes;
+    return ::operator new(bytes, std::align_val_t(align));
+}
+
+void RpcArena::Upstream::do_deallocate(void* p, size_t bytes, size_t align) {
+    ::operator delete(p, bytes, std::align_val_t(align));
+}
+
+RpcArena::RpcArena()
+    : block_(new std::byte[kInitialBytes]),
+      blockSize_(kInitialBytes) {
+    mono_.emplace(block_.get(), blockSize_, &upstream_);
+}
+
+RpcArena& RpcArena::local() {
+    thread_local RpcArena arena;
+    return arena;
+}
+
+void RpcArena::reset() {
+    mono_->release();
+    if (upstream_.requested == 0) return;
+
+    // The round trip spilled: retain a block that would have held it.
+    ++spills_;
+    size_t want = std::min(kMaxRetainedBytes, blockSize_ + upstream_.requested);
+    upstream_.requested = 0;
+    if (want <= blockSize_) return;
+    size_t grown = blockSize_;
+    while (grown < want) grown *= 2;
+    grown = std::min(grown, kMaxRetainedBytes);
+
+    // mono_ points at the old block: rebuild it over the new one.
+    mono_.reset();
+    block_.reset(new std::byte[grown]);
+    blockSize_ = grown;
+    mono_.emplace(block_.get(), blockSize_, &upstream_);
+}
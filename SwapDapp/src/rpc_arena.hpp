@@ -0,0 +1,87 @@
+/*
+ * File:        rpc_arena.hpp
+ * Created on:  2026-10-17
+ * Description: Per-thread monotonic arena for one request/response round
+ *              trip. The response body lands in arena memory (RpcClient::post
+ *              into a std::pmr::string), json_extract returns views into it and
+ *              the typed decoders produce stack values, so a round trip makes
+ *              no heap allocation and threads never meet in the allocator.
+ *
+ *              An ArenaScope marks the round trip; the outermost scope resets
+ *              the arena when it ends. The first block is owned by the thread
+ *              and grows (up to kMaxRetainedBytes) after a round trip spills
+ *              past it, so steady-state traffic stays off the heap.
+ *
+ *              {
+ *                  ArenaScope arena;
+ *                  std::pmr::string response(arena.resource());
+ *                  auto raw = client.post(body, response);
+ *                  ...   // views into response die with the scope
+ *              }
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+class RpcArena {
+public:
+    static constexpr size_t kInitialBytes = 64 * 1024;
+    static constexpr size_t kMaxRetainedBytes = 4 * 1024 * 1024;
+
+    // The calling thread's arena.
+    static RpcArena& local();
+
+    std::pmr::memory_resource* resource() { return &*mono_; }
+
+    // Drops everything allocated since the last reset.
+    void reset();
+
+    size_t block_size() const { return blockSize_; }
+    // Round trips that outgrew the retained block and went to the heap.
+    uint64_t spills() const { return spills_; }
+
+private:
+    // Counts what the monotonic resource asks of the heap beyond the block.
+    class Upstream : public std::pmr::memory_resource {
+    public:
+        size_t requested = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t align) override;
+        void do_deallocate(void* p, size_t bytes, size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    RpcArena();
+
+    Upstream upstream_;
+    std::unique_ptr<std::byte[]> block_;
+    size_t blockSize_;
+    std::optional<std::pmr::monotonic_buffer_resource> mono_;   // rebuilt when the block grows
+    uint64_t spills_ = 0;
+
+    friend class ArenaScope;
+    unsigned depth_ = 0;
+};
+
+// One round trip on the calling thread. Nested scopes share the outer one.
+class ArenaScope {
+public:
+    ArenaScope() : arena_(RpcArena::local()) { ++arena_.depth_; }
+    ~ArenaScope() {
+        if (--arena_.depth_ == 0) arena_.reset();
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    std::pmr::memory_resource* resource() const { return arena_.resource(); }
+
+private:
+    RpcArena& arena_;
+};
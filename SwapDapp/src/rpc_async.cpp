@@ -0,0 +1,337 @@
+/*
+ * File:        rpc_async.cpp
+ * Created on:  2026-10-17
+ * Description: Asynchronous JSON-RPC engine (see rpc_async.hpp).
+ */
+
+#include "rpc_async.hpp"
+#include "log.hpp"
+#include "rpc_metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <iostream>
+
+// -----------------------------------------------------------------------------
+// Construction / teardown
+// -----------------------------------------------------------------------------
+AsyncRpcEngine::AsyncRpcEngine(RpcClient& client, AsyncRpcOptions opts)
+    : client_(client), opts_(opts) {
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        std::cerr << "Error::Failed to initialize CURL multi handle\n";
+        return;
+    }
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, opts_.max_host_connections);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, opts_.max_total_connections);
+    thread_ = std::thread(&AsyncRpcEngine::loop, this);
+}
+
+AsyncRpcEngine::~AsyncRpcEngine() {
+    stop_.store(true);
+    if (multi_) curl_multi_wakeup(multi_);
+    if (thread_.joinable()) thread_.join();
+
+    // Whatever is left never completes: fail it so no future is left hanging.
+    for (auto& kv : active_) {
+        curl_multi_remove_handle(multi_, kv.second->handle);
+        finish(kv.second.get(), std::nullopt);
+    }
+    active_.clear();
+    for (auto& req : waiting_) finish(req.get(), std::nullopt);
+    waiting_.clear();
+    for (auto& req : submitted_) finish(req.get(), std::nullopt);
+    submitted_.clear();
+    timers_.clear();   // never fired
+    if (multi_) curl_multi_cleanup(multi_);
+}
+
+// -----------------------------------------------------------------------------
+// Submission (any thread)
+// -----------------------------------------------------------------------------
+uint64_t AsyncRpcEngine::submit(std::string body, RpcCallback cb) {
+    auto req = std::make_unique<Request>();
+    req->id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    req->body = std::move(body);
+    req->cb = std::move(cb);
+    uint64_t id = req->id;
+
+    if (!multi_ || req->body.empty()) {
+        std::cerr << "Error::async request rejected\n";
+        if (!req->cb) return id;
+        // Still answered from the loop thread, never from inside submit();
+        // without a loop (no multi handle) there is no other thread to use.
+        if (!multi_) {
+            req->cb(std::nullopt);
+            return id;
+        }
+        schedule_after(std::chrono::milliseconds(0), [cb = std::move(req->cb)] { cb(std::nullopt); });
+        return id;
+    }
+
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    if (client_.options().metrics) RpcMetrics::global().counters().in_flight.add();
+    {
+        std::lock_guard<std::mutex> lock(queue_mu_);
+        submitted_.push_back(std::move(req));
+    }
+    curl_multi_wakeup(multi_);
+    return id;
+}
+
+uint64_t AsyncRpcEngine::call_async(const nlohmann::json& j, RpcCallback cb) {
+    return submit(j.dump(), std::move(cb));
+}
+
+std::future<std::optional<std::string>> AsyncRpcEngine::call_async(const nlohmann::json& j) {
+    auto promise = std::make_shared<std::promise<std::optional<std::string>>>();
+    std::future<std::optional<std::string>> fut = promise->get_future();
+    submit(j.dump(), [promise](std::optional<std::string> r) { promise->set_value(std::move(r)); });
+    return fut;
+}
+
+void AsyncRpcEngine::cancel(uint64_t id) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mu_);
+        cancelled_.push_back(id);
+    }
+    if (multi_) curl_multi_wakeup(multi_);
+}
+
+void AsyncRpcEngine::schedule_after(std::chrono::milliseconds delay, std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mu_);
+        timers_.push_back({std::chrono::steady_clock::now() + delay, timer_seq_++, std::move(fn)});
+        std::push_heap(timers_.begin(), timers_.end(), std::greater<Timer>());
+    }
+    if (multi_) curl_multi_wakeup(multi_);
+}
+
+// -----------------------------------------------------------------------------
+// Event loop (engine thread)
+// -----------------------------------------------------------------------------
+void AsyncRpcEngine::loop() {
+    while (!stop_.load()) {
+        run_timers();
+        start_pending();
+        apply_cancels();
+
+        int running = 0;
+        CURLMcode mc = curl_multi_perform(multi_, &running);
+        if (mc != CURLM_OK) {
+            std::cerr << "Error::curl_multi_perform: " << curl_multi_strerror(mc) << "\n";
+        }
+        drain_completions();
+        if (!waiting_.empty() && active_.size() < opts_.max_active &&
+            std::chrono::steady_clock::now() >= admit_at_) {
+            continue;   // refill now
+        }
+
+        curl_multi_poll(multi_, nullptr, 0, next_wait_ms(), nullptr);
+    }
+}
+
+void AsyncRpcEngine::run_timers() {
+    std::vector<std::function<void()>> due;
+    {
+        std::lock_guard<std::mutex> lock(queue_mu_);
+        auto now = std::chrono::steady_clock::now();
+        while (!timers_.empty() && timers_.front().due <= now) {
+            std::pop_heap(timers_.begin(), timers_.end(), std::greater<Timer>());
+            due.push_back(std::move(timers_.back().fn));
+            timers_.pop_back();
+        }
+    }
+    for (auto& fn : due) fn();   // outside the lock: timers may schedule more work
+}
+
+int AsyncRpcEngine::next_wait_ms() {
+    std::lock_guard<std::mutex> lock(queue_mu_);
+    if (timers_.empty()) return opts_.poll_timeout_ms;
+    auto left = std::chrono::ceil<std::chrono::milliseconds>(
+        timers_.front().due - std::chrono::steady_clock::now()).count();
+    return (int)std::clamp<long long>(left, 0, opts_.poll_timeout_ms);
+}
+
+// The share handle owns the connection cache, so curl's per-host limits do not
+// bound sockets here; the engine caps attached handles itself instead.
+void AsyncRpcEngine::start_pending() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mu_);
+        for (auto& req : submitted_) waiting_.push_back(std::move(req));
+        submitted_.clear();
+    }
+    while (!waiting_.empty() && active_.size() < opts_.max_active) {
+        auto now = std::chrono::steady_clock::now();
+        if (now < admit_at_) return;
+        std::chrono::microseconds wait{0};
+        std::optional<size_t> ep = client_.route(waiting_.front()->tried, &wait);
+        if (!ep && wait.count() > 0) {
+            // Rate or concurrency limited: leave the queue as is and come back.
+            admit_at_ = now + wait;
+            schedule_after(std::chrono::ceil<std::chrono::milliseconds>(wait), [] {});
+            return;
+        }
+        std::unique_ptr<Request> req = std::move(waiting_.front());
+        waiting_.pop_front();
+        if (!ep) {
+            std::cerr << "Error::No RPC endpoint available\n";
+            finish(req.get(), std::nullopt);
+            continue;
+        }
+        req->endpoint = *ep;
+        req->routed = true;
+        CURL* h = client_.acquire(*ep);
+        if (!h) {
+            std::cerr << "Error::Failed to initialize CURL\n";
+            finish(req.get(), std::nullopt);
+            continue;
+        }
+        req->handle = h;
+        curl_easy_setopt(h, CURLOPT_POSTFIELDS, req->body.c_str());
+        curl_easy_setopt(h, CURLOPT_POSTFIELDSIZE, (long)req->body.size());
+        curl_easy_setopt(h, CURLOPT_WRITEDATA, &req->response);
+        curl_easy_setopt(h, CURLOPT_PRIVATE, req.get());
+
+        LOG_EVENT(LogLevel::Debug, "rpc.send")
+            .num("req", req->id)
+            .str("url", client_.router().url(*ep))
+            .num("bytes", req->body.size())
+            .str("body", req->body);
+        if (curl_multi_add_handle(multi_, h) != CURLM_OK) {
+            finish(req.get(), std::nullopt);
+            continue;
+        }
+        uint64_t id = req->id;
+        active_.emplace(id, std::move(req));
+    }
+}
+
+void AsyncRpcEngine::apply_cancels() {
+    std::vector<uint64_t> ids;
+    std::vector<std::unique_ptr<Request>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(queue_mu_);
+        ids.swap(cancelled_);
+        // Submitted and cancelled since start_pending() drained the queue.
+        for (uint64_t id : ids) {
+            auto it = std::find_if(submitted_.begin(), submitted_.end(),
+                                   [id](const std::unique_ptr<Request>& r) { return r->id == id; });
+            if (it == submitted_.end()) continue;
+            dropped.push_back(std::move(*it));
+            submitted_.erase(it);
+        }
+    }
+    for (auto& req : dropped) finish(req.get(), std::nullopt);
+    for (uint64_t id : ids) {
+        auto it = active_.find(id);
+        if (it != active_.end()) {
+            curl_multi_remove_handle(multi_, it->second->handle);
+            finish(it->second.get(), std::nullopt);
+            active_.erase(it);
+            continue;
+        }
+        for (auto w = waiting_.begin(); w != waiting_.end(); ++w) {
+            if ((*w)->id != id) continue;
+            finish(w->get(), std::nullopt);
+            waiting_.erase(w);
+            break;
+        }
+        // Otherwise it already finished.
+    }
+}
+
+void AsyncRpcEngine::drain_completions() {
+    int left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi_, &left)) {
+        if (msg->msg != CURLMSG_DONE) continue;
+
+        Request* req = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&req));
+        CURLcode res = msg->data.result;
+        curl_multi_remove_handle(multi_, msg->easy_handle);
+        if (!req) continue;
+
+        RpcClient::Resend again = client_.finished(req->endpoint, msg->easy_handle, res, req->body);
+        req->routed = false;
+        admit_at_ = {};   // a slot just freed up
+        if (log_enabled(LogLevel::Debug)) {
+            curl_off_t total_us = 0;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_TOTAL_TIME_T, &total_us);
+            LogEvent(LogLevel::Debug, "rpc.recv")
+                .num("req", req->id)
+                .num("curl_code", (int)res)
+                .num("bytes", req->response.size())
+                .num("total_us", (int64_t)total_us);
+        }
+
+        uint64_t id = req->id;
+        bool resend = false;
+        if (again == RpcClient::Resend::Elsewhere) {
+            req->tried |= uint64_t(1) << req->endpoint;
+            resend = (size_t)std::popcount(req->tried) < client_.router().size();
+            if (resend) {
+                LOG_EVENT(LogLevel::Warn, "rpc.failover")
+                    .num("req", id)
+                    .str("url", client_.router().url(req->endpoint))
+                    .str("error", curl_easy_strerror(res));
+            }
+        } else if (again == RpcClient::Resend::Later) {
+            resend = req->throttled++ < client_.options().max_throttled_resends;
+            if (!resend) {
+                std::cerr << "Error::rate limited (HTTP 429) by " << client_.router().url(req->endpoint) << "\n";
+                req->response.clear();
+            } else if (client_.options().metrics) {
+                RpcMetrics::global().record_retry(client_.router().url(req->endpoint), rpc_method_of(req->body));
+            }
+        }
+        if (resend) {
+            // Back ahead of new work; start_pending() routes it again once
+            // the limiter admits it.
+            curl_easy_setopt(req->handle, CURLOPT_WRITEDATA, nullptr);
+            curl_easy_setopt(req->handle, CURLOPT_PRIVATE, nullptr);
+            client_.release(req->handle, req->endpoint);
+            req->handle = nullptr;
+            req->response.clear();
+            auto it = active_.find(id);
+            waiting_.push_front(std::move(it->second));
+            active_.erase(it);
+            continue;
+        }
+
+        std::optional<std::string> result;
+        if (res != CURLE_OK) {
+            std::cerr << "Error::" << curl_easy_strerror(res) << "\n";
+        } else if (req->response.empty()) {
+            std::cerr << "Error::Response is empty\n";
+        } else {
+            result = std::move(req->response);
+        }
+        finish(req, std::move(result));
+        active_.erase(id);
+    }
+}
+
+// Returns the handle to the client pool and fires the callback exactly once.
+void AsyncRpcEngine::finish(Request* req, std::optional<std::string> result) {
+    if (req->handle) {
+        curl_easy_setopt(req->handle, CURLOPT_WRITEDATA, nullptr);
+        curl_easy_setopt(req->handle, CURLOPT_PRIVATE, nullptr);
+        client_.release(req->handle, req->endpoint);
+        req->handle = nullptr;
+    }
+    if (req->routed) {
+        client_.abandoned(req->endpoint);
+        req->routed = false;
+    }
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    if (client_.options().metrics) RpcMetrics::global().counters().in_flight.sub();
+    RpcCallback cb = std::move(req->cb);
+    if (cb) cb(std::move(result));
+}
+
+std::future<std::optional<std::string>> rpc_call_async(AsyncRpcEngine& engine, const nlohmann::json& j) {
+    return engine.call_async(j);
+}
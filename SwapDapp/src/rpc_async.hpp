@@ -0,0 +1,119 @@
+/*
+ * File:        rpc_async.hpp
+ * Created on:  2026-10-17
+ * Description: Asynchronous JSON-RPC engine on top of curl_multi. One event-loop
+ *              thread drives every in-flight request, so thousands of calls can be
+ *              outstanding at once without a thread per call. Handles come from the
+ *              RpcClient pool and share its DNS/TLS/connection caches; over HTTP/2
+ *              requests to the same host are multiplexed onto one connection.
+ *
+ *              Callbacks and timers run on the event-loop thread and must not block.
+ */
+
+#pragma once
+
+#include "rpc_client.hpp"
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using RpcCallback = std::function<void(std::optional<std::string>)>;
+
+// -----------------------------------------------------------------------------
+// Engine options
+// -----------------------------------------------------------------------------
+struct AsyncRpcOptions {
+    size_t max_active          = 128;   // handles attached to the multi; the rest wait in order
+    long max_host_connections  = 32;
+    long max_total_connections = 64;
+    int  poll_timeout_ms       = 1000;  // upper bound on one idle wait of the loop
+};
+
+// -----------------------------------------------------------------------------
+// AsyncRpcEngine
+// -----------------------------------------------------------------------------
+class AsyncRpcEngine {
+public:
+    explicit AsyncRpcEngine(RpcClient& client, AsyncRpcOptions opts = {});
+    ~AsyncRpcEngine();
+
+    AsyncRpcEngine(const AsyncRpcEngine&) = delete;
+    AsyncRpcEngine& operator=(const AsyncRpcEngine&) = delete;
+
+    // Thread-safe. Returns a request id usable with cancel().
+    uint64_t submit(std::string body, RpcCallback cb);
+    uint64_t call_async(const nlohmann::json& j, RpcCallback cb);
+    std::future<std::optional<std::string>> call_async(const nlohmann::json& j);
+
+    // Aborts a request that has not completed yet; its callback gets nullopt.
+    void cancel(uint64_t id);
+
+    // Thread-safe. Runs fn on the event-loop thread once delay has elapsed;
+    // the loop sleeps in curl_multi_poll until then, so no thread is parked.
+    void schedule_after(std::chrono::milliseconds delay, std::function<void()> fn);
+
+    size_t in_flight() const { return in_flight_.load(std::memory_order_relaxed); }
+    RpcClient& client() { return client_; }
+
+private:
+    struct Request {
+        uint64_t id = 0;
+        std::string body;
+        std::string response;
+        RpcCallback cb;
+        CURL* handle = nullptr;
+        size_t endpoint = 0;
+        bool routed = false;    // counted by the router, awaiting finished()/abandoned()
+        uint64_t tried = 0;     // endpoints already failed before sending
+        int throttled = 0;      // HTTP 429s resent so far
+    };
+
+    struct Timer {
+        std::chrono::steady_clock::time_point due;
+        uint64_t seq = 0;                       // FIFO among timers due at the same instant
+        std::function<void()> fn;
+        bool operator>(const Timer& o) const { return due != o.due ? due > o.due : seq > o.seq; }
+    };
+
+    void loop();
+    void run_timers();
+    int next_wait_ms();
+    void start_pending();
+    void apply_cancels();
+    void drain_completions();
+    void finish(Request* req, std::optional<std::string> result);
+
+    RpcClient& client_;
+    AsyncRpcOptions opts_;
+    CURLM* multi_ = nullptr;
+
+    std::mutex queue_mu_;                                   // guards the queues below
+    std::vector<std::unique_ptr<Request>> submitted_;
+    std::vector<uint64_t> cancelled_;
+    std::vector<Timer> timers_;                             // min-heap on due
+    uint64_t timer_seq_ = 0;
+
+    std::deque<std::unique_ptr<Request>> waiting_;                    // loop thread only
+    std::chrono::steady_clock::time_point admit_at_{};                // loop thread only: endpoints at their limits until
+    std::unordered_map<uint64_t, std::unique_ptr<Request>> active_;   // loop thread only
+    std::atomic<uint64_t> next_id_{1};
+    std::atomic<size_t> in_flight_{0};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+// Async variant of rpc_call.
+std::future<std::optional<std::string>> rpc_call_async(AsyncRpcEngine& engine, const nlohmann::json& j);
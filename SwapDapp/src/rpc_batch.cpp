@@ -0,0 +1,102 @@
+/*
+ * File:        rpc_batch.cpp
+ * Created on:  2026-10-17
+ * Description: JSON-RPC 2.0 batch requests (see rpc_batch.hpp).
+ */
+
+#include "rpc_batch.hpp"
+#include "json_extract.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+size_t RpcBatch::add(std::string method, nlohmann::json params) {
+    calls_.push_back({std::move(method), std::move(params)});
+    results_.emplace_back();
+    return calls_.size() - 1;
+}
+
+void RpcBatch::fail_range(size_t begin, size_t end, int code, const std::string& message) {
+    for (size_t i = begin; i < end; ++i) {
+        if (results_[i].result || results_[i].error) continue;
+        results_[i].error = nlohmann::json{{"code", code}, {"message", message}};
+    }
+}
+
+// Ids are slot + 1, so routing a response back is a range check, not a lookup.
+void RpcBatch::send_chunk(RpcClient& client, size_t begin, size_t end, bool& any_ok) {
+    nlohmann::json body = nlohmann::json::array();
+    for (size_t i = begin; i < end; ++i) {
+        body.push_back({
+            {"jsonrpc", "2.0"},
+            {"id", i + 1},
+            {"method", calls_[i].method},
+            {"params", calls_[i].params}
+        });
+    }
+    // A batch of one goes out as a plain request for nodes without batch support.
+    std::optional<std::string> raw = rpc_call(client, end - begin == 1 ? body[0] : body);
+    if (!raw) {
+        fail_range(begin, end, kTransportErrorCode, "no response");
+        return;
+    }
+
+    // Each element is walked once for its id; only result / error become a DOM.
+    std::optional<std::vector<std::string_view>> items;
+    std::optional<RpcView> single;
+    if ((single = rpc_extract(*raw))) {
+        items.emplace(1, std::string_view(*raw));
+    } else {
+        items = json_elements(*raw);
+    }
+    if (!items) {
+        fail_range(begin, end, kTransportErrorCode, "malformed response");
+        return;
+    }
+    any_ok = true;
+
+    // Nodes reject a whole batch with one error object (e.g. batch too large).
+    if (single && (single->id.empty() || json_is_null(single->id))) {
+        std::string msg = single->error.empty() ? "batch rejected" : std::string(single->error);
+        fail_range(begin, end, kTransportErrorCode, msg);
+        return;
+    }
+
+    for (std::string_view item : *items) {
+        std::optional<RpcView> v = rpc_extract(item);
+        std::optional<uint64_t> id = v ? json_uint(v->id) : std::nullopt;
+        if (!id) continue;
+        size_t slot = (size_t)*id - 1;
+        if (slot < begin || slot >= end) {
+            std::cerr << "Error::batch response id out of range: " << v->id << "\n";
+            continue;
+        }
+        std::string_view member = v->error.empty() ? v->result : v->error;
+        if (member.empty()) continue;
+        nlohmann::json j = nlohmann::json::parse(member.begin(), member.end(), nullptr, false);
+        if (j.is_discarded()) continue;
+        RpcResult& r = results_[slot];
+        if (!v->error.empty()) {
+            r.error = std::move(j);
+        } else {
+            r.result = std::move(j);
+        }
+    }
+    // Anything the node silently dropped.
+    fail_range(begin, end, kTransportErrorCode, "missing from batch response");
+}
+
+bool RpcBatch::send(RpcClient& client) {
+    for (auto& r : results_) r = RpcResult{};
+
+    size_t limit = std::max<size_t>(1, client.options().max_batch_size);
+    bool any_ok = false;
+    for (size_t begin = 0; begin < calls_.size(); begin += limit) {
+        send_chunk(client, begin, std::min(calls_.size(), begin + limit), any_ok);
+    }
+    return any_ok || calls_.empty();
+}
+
+bool rpc_call_batch(RpcClient& client, RpcBatch& batch) {
+    return batch.send(client);
+}
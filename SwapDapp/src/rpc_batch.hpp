@@ -0,0 +1,50 @@
+/*
+ * File:        rpc_batch.hpp
+ * Created on:  2026-10-17
+ * Description: JSON-RPC 2.0 batch requests. Independent calls are queued into an
+ *              RpcBatch, sent as one JSON array POST (split into chunks of
+ *              RpcClientOptions::max_batch_size), and each response is routed back
+ *              to its slot by id. Errors are reported per slot, so one failing
+ *              call does not poison the rest of the batch.
+ */
+
+#pragma once
+
+#include "rpc_client.hpp"
+
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// RpcBatch
+// -----------------------------------------------------------------------------
+class RpcBatch {
+public:
+    // Queue a call; the returned slot indexes results() after send.
+    size_t add(std::string method, nlohmann::json params = nlohmann::json::array());
+
+    size_t size() const { return calls_.size(); }
+    bool empty() const { return calls_.empty(); }
+
+    const RpcResult& operator[](size_t slot) const { return results_.at(slot); }
+    const std::vector<RpcResult>& results() const { return results_; }
+
+    // Sends every queued call. Returns false only if no chunk got a response at all.
+    bool send(RpcClient& client);
+
+private:
+    struct Call {
+        std::string method;
+        nlohmann::json params;
+    };
+
+    void send_chunk(RpcClient& client, size_t begin, size_t end, bool& any_ok);
+    void fail_range(size_t begin, size_t end, int code, const std::string& message);
+
+    std::vector<Call> calls_;
+    std::vector<RpcResult> results_;
+};
+
+bool rpc_call_batch(RpcClient& client, RpcBatch& batch);
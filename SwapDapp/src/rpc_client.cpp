@@ -0,0 +1,600 @@
+/*
+ * File:        rpc_client.cpp
+ * Created on:  2026-10-17
+ * Description: Pooled JSON-RPC client (see rpc_client.hpp).
+ */
+
+#include "rpc_client.hpp"
+#include "json_extract.hpp"
+#include "log.hpp"
+#include "rpc_coalesce.hpp"
+#include "rpc_hedge.hpp"
+#include "rpc_metrics.hpp"
+#include "rpc_template.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+// -----------------------------------------------------------------------------
+// Construction / teardown
+// -----------------------------------------------------------------------------
+static std::vector<std::string> split_urls(const std::string& list) {
+    std::vector<std::string> urls;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        size_t b = list.find_first_not_of(" \t", start);
+        size_t e = list.find_last_not_of(" \t", comma - 1);
+        if (b != std::string::npos && b < comma && e != std::string::npos && e >= b) urls.push_back(list.substr(b, e - b + 1));
+        start = comma + 1;
+    }
+    return urls;
+}
+
+RpcClient::RpcClient(std::string url, RpcClientOptions opts) : RpcClient(split_urls(url), opts) {}
+
+RpcClient::RpcClient(std::vector<std::string> urls, RpcClientOptions opts)
+    : opts_(opts), router_(std::move(urls), opts.router), hedge_budget_(opts.hedge.budget_ratio, opts.hedge.budget_burst),
+      single_flight_(std::make_unique<RpcSingleFlight>()) {
+    for (size_t i = 0; i < router_.size(); ++i) pools_.push_back(std::make_unique<Pool>());
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &RpcClient::share_lock);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &RpcClient::share_unlock);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    } else {
+        std::cerr << "Error::Failed to initialize CURL share handle\n";
+    }
+    headers_ = curl_slist_append(headers_, "Content-Type: application/json");
+}
+
+RpcClient::~RpcClient() {
+    for (auto& pool : pools_) {
+        for (CURL* h : pool->idle) curl_easy_cleanup(h);
+        pool->idle.clear();
+    }
+    if (share_) curl_share_cleanup(share_);
+    curl_slist_free_all(headers_);
+}
+
+const std::string& RpcClient::url() const {
+    static const std::string none;
+    return router_.size() ? router_.url(0) : none;
+}
+
+void RpcClient::share_lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<RpcClient*>(userptr)->share_mu_[data].lock();
+}
+
+void RpcClient::share_unlock(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<RpcClient*>(userptr)->share_mu_[data].unlock();
+}
+
+// -----------------------------------------------------------------------------
+// Handle pool
+// -----------------------------------------------------------------------------
+// Only curl's own messages and headers; bodies are logged by perform().
+static int curlDebugCallback(CURL*, curl_infotype type, char* data, size_t size, void*) {
+    const char* dir = type == CURLINFO_TEXT ? "info" : type == CURLINFO_HEADER_IN ? "header_in"
+                    : type == CURLINFO_HEADER_OUT ? "header_out" : nullptr;
+    if (!dir) return 0;
+    while (size > 0 && (data[size - 1] == '\n' || data[size - 1] == '\r')) --size;
+    LOG_EVENT(LogLevel::Trace, "curl").str("kind", dir).str("text", std::string_view(data, size));
+    return 0;
+}
+
+CURL* RpcClient::make_handle(size_t endpoint) {
+    CURL* h = curl_easy_init();
+    if (!h) return nullptr;
+
+    // Everything that does not change between calls is set exactly once.
+    const std::string& url = router_.url(endpoint);
+    curl_easy_setopt(h, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(h, CURLOPT_HTTPHEADER, headers_);
+    curl_easy_setopt(h, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(h, CURLOPT_CONNECTTIMEOUT_MS, opts_.connect_timeout_ms);
+    curl_easy_setopt(h, CURLOPT_TIMEOUT_MS, opts_.timeout_ms);
+    curl_easy_setopt(h, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(h, CURLOPT_NOSIGNAL, 1L);
+    if (share_) curl_easy_setopt(h, CURLOPT_SHARE, share_);
+    if (opts_.http2) {
+        curl_easy_setopt(h, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+        // Prefer multiplexing over a new connection. Only h2 (TLS) can multiplex;
+        // on plain HTTP waiting would just stall behind busy connections.
+        if (url.rfind("https://", 0) == 0) curl_easy_setopt(h, CURLOPT_PIPEWAIT, 1L);
+    }
+
+    // Wire-level tracing goes through the logger, never straight to stderr.
+    if (opts_.verbose) {
+        curl_easy_setopt(h, CURLOPT_VERBOSE, 1L);
+        curl_easy_setopt(h, CURLOPT_DEBUGFUNCTION, curlDebugCallback);
+    }
+    return h;
+}
+
+CURL* RpcClient::acquire(size_t endpoint) {
+    Pool& pool = *pools_[endpoint];
+    {
+        std::lock_guard<std::mutex> lock(pool.mu);
+        if (!pool.idle.empty()) {
+            CURL* h = pool.idle.back();
+            pool.idle.pop_back();
+            return h;
+        }
+    }
+    return make_handle(endpoint);
+}
+
+void RpcClient::release(CURL* h, size_t endpoint) {
+    Pool& pool = *pools_[endpoint];
+    {
+        std::lock_guard<std::mutex> lock(pool.mu);
+        if (pool.idle.size() < opts_.max_idle_handles) {
+            pool.idle.push_back(h);
+            return;
+        }
+    }
+    curl_easy_cleanup(h);
+}
+
+// -----------------------------------------------------------------------------
+// Routing feedback
+// -----------------------------------------------------------------------------
+// Failures that happen before the request is written: resending cannot
+// duplicate anything, even for eth_sendRawTransaction.
+static bool never_sent(CURL* h, CURLcode res) {
+    switch (res) {
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_COULDNT_CONNECT:
+    case CURLE_SSL_CONNECT_ERROR:
+        return true;
+    case CURLE_OPERATION_TIMEDOUT: {
+        curl_off_t pre = 0;
+        curl_easy_getinfo(h, CURLINFO_PRETRANSFER_TIME_T, &pre);
+        return pre == 0;
+    }
+    default:
+        return false;
+    }
+}
+
+// The endpoint did not answer: transport failure, rate limited or broken.
+// Any other response, JSON-RPC errors included, is an answer.
+static bool endpoint_failed(CURL* h, CURLcode res) {
+    long status = 0;
+    curl_easy_getinfo(h, CURLINFO_RESPONSE_CODE, &status);
+    return res != CURLE_OK || status == 429 || status >= 500;
+}
+
+static bool throttled(CURL* h) {
+    long status = 0;
+    curl_easy_getinfo(h, CURLINFO_RESPONSE_CODE, &status);
+    return status == 429;
+}
+
+RpcClient::Resend RpcClient::finished(size_t endpoint, CURL* h, CURLcode res, std::string_view body) {
+    curl_off_t total = 0;
+    curl_easy_getinfo(h, CURLINFO_TOTAL_TIME_T, &total);
+    if (opts_.metrics) RpcMetrics::global().record(h, res, router_.url(endpoint), body);
+    if (res == CURLE_OK && throttled(h)) {
+        curl_off_t retryAfter = 0;   // seconds; curl parses both header forms
+        curl_easy_getinfo(h, CURLINFO_RETRY_AFTER, &retryAfter);
+        router_.finish(endpoint, RouteOutcome::Throttled, std::chrono::microseconds(total),
+                       std::chrono::seconds(retryAfter));
+        return Resend::Later;
+    }
+    RouteOutcome outcome = endpoint_failed(h, res) ? RouteOutcome::Failure : RouteOutcome::Success;
+    router_.finish(endpoint, outcome, std::chrono::microseconds(total));
+    return res != CURLE_OK && never_sent(h, res) ? Resend::Elsewhere : Resend::No;
+}
+
+void RpcClient::abandoned(size_t endpoint) {
+    router_.finish(endpoint, RouteOutcome::Cancelled, std::chrono::microseconds(0));
+}
+
+// -----------------------------------------------------------------------------
+// Calls
+// -----------------------------------------------------------------------------
+std::optional<std::string> RpcClient::call(const nlohmann::json& j) {
+    return post(j.dump());
+}
+
+static void log_recv(CURL* h, CURLcode res) {
+    if (!log_enabled(LogLevel::Debug)) return;
+    curl_off_t total_us = 0, down = 0;
+    long status = 0;
+    curl_easy_getinfo(h, CURLINFO_TOTAL_TIME_T, &total_us);
+    curl_easy_getinfo(h, CURLINFO_SIZE_DOWNLOAD_T, &down);
+    curl_easy_getinfo(h, CURLINFO_RESPONSE_CODE, &status);
+    LogEvent(LogLevel::Debug, "rpc.recv")
+        .num("curl_code", (int)res)
+        .num("http_status", (int64_t)status)
+        .num("bytes", (int64_t)down)
+        .num("total_us", (int64_t)total_us);
+}
+
+std::optional<size_t> RpcClient::admit(uint64_t tried, std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+        std::chrono::microseconds wait{0};
+        std::optional<size_t> ep = router_.pick(tried, &wait);
+        if (ep) return ep;
+        if (wait.count() == 0) {
+            std::cerr << "Error::No RPC endpoint available\n";
+            return std::nullopt;
+        }
+        if (std::chrono::steady_clock::now() + wait > deadline) {
+            std::cerr << "Error::RPC endpoints rate limited past the request timeout\n";
+            return std::nullopt;
+        }
+        router_.wait_for_capacity(wait);
+    }
+}
+
+// A 429 body is the gateway's, not the node's: keep it from the caller.
+struct ThrottleFilter {
+    CURL* h;
+    curl_write_callback write;
+    void* userdata;
+};
+
+static size_t throttleFilterCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    ThrottleFilter* f = static_cast<ThrottleFilter*>(userdata);
+    if (throttled(f->h)) return size * nmemb;
+    return f->write(ptr, size, nmemb, f->userdata);
+}
+
+// A request that never reached its endpoint moves on to the next one, one
+// that was throttled is resent once the limiter allows; anything else is
+// returned as is, since the server may already have acted on it.
+std::optional<CURLcode> RpcClient::perform(const std::string& body, curl_write_callback write, void* userdata,
+                                           std::optional<size_t> only, RpcTransport* transport) {
+    if (transport) *transport = RpcTransport{};
+    if (router_.size() == 0) {
+        std::cerr << "Error::URL is empty\n";
+        return std::nullopt;
+    }
+
+    if (body.empty()) {
+        std::cerr << "Error::Request body is empty\n";
+        return std::nullopt;
+    }
+
+    if (opts_.hedge.enabled && !only && router_.size() > 1) {
+        std::string_view method = rpc_method_of(body);
+        if (rpc_method_hedgeable(method)) return perform_hedged(body, method, write, userdata, transport);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opts_.timeout_ms);
+    uint64_t tried = 0;
+    int throttledResends = 0;
+    for (;;) {
+        std::optional<size_t> ep = only;
+        if (ep) router_.claim(*ep);
+        else ep = admit(tried, deadline);
+        if (!ep) return std::nullopt;
+
+        CURL* curl = acquire(*ep);
+        if (!curl) {
+            abandoned(*ep);
+            std::cerr << "Error::Failed to initialize CURL\n";
+            return std::nullopt;
+        }
+
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)body.size());
+        ThrottleFilter filter{curl, write, userdata};
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, throttleFilterCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &filter);
+
+        LOG_EVENT(LogLevel::Debug, "rpc.send").str("url", router_.url(*ep)).num("bytes", body.size()).str("body", body);
+        CURLcode res;
+        if (opts_.metrics) {
+            GaugeScope inFlight(RpcMetrics::global().counters().in_flight);
+            res = curl_easy_perform(curl);
+        } else {
+            res = curl_easy_perform(curl);
+        }
+        Resend again = finished(*ep, curl, res, body);
+        log_recv(curl, res);
+        if (transport) {
+            transport->curl = res;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transport->http_status);
+            transport->sent |= !never_sent(curl, res);
+            transport->endpoint = *ep;
+        }
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+        release(curl, *ep);
+
+        if (again == Resend::No || only) return res;
+        if (again == Resend::Later) {
+            if (throttledResends++ >= opts_.max_throttled_resends) {
+                std::cerr << "Error::rate limited (HTTP 429) by " << router_.url(*ep) << "\n";
+                if (transport) transport->throttle_spent = true;
+                return res;
+            }
+            if (opts_.metrics) RpcMetrics::global().record_retry(router_.url(*ep), rpc_method_of(body));
+            continue;
+        }
+        tried |= uint64_t(1) << *ep;
+        if (std::popcount(tried) >= (int)router_.size()) return res;
+        LOG_EVENT(LogLevel::Warn, "rpc.failover").str("url", router_.url(*ep)).str("error", curl_easy_strerror(res));
+    }
+}
+
+// Both attempts write into their own buffer and the answer used is handed to
+// the caller's callback in one piece. Reads only, so an attempt that failed
+// before the hedge went out is simply sent to the next endpoint.
+std::optional<CURLcode> RpcClient::perform_hedged(const std::string& body, std::string_view method,
+                                                  curl_write_callback write, void* userdata, RpcTransport* transport) {
+    struct Attempt {
+        size_t endpoint = 0;
+        CURL* h = nullptr;
+        std::string response;
+        bool done = false;
+        CURLcode res = CURLE_OK;
+    };
+
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        std::cerr << "Error::Failed to initialize CURL multi handle\n";
+        return std::nullopt;
+    }
+    hedge_budget_.deposit();
+
+    std::array<Attempt, 2> attempts;
+    size_t launched = 0;
+    uint64_t tried = 0;
+    auto launch = [&](std::optional<size_t> ep) -> bool {
+        if (!ep) return false;
+        tried |= uint64_t(1) << *ep;
+        CURL* h = acquire(*ep);
+        if (!h) {
+            abandoned(*ep);
+            return false;
+        }
+        Attempt& a = attempts[launched];
+        a.endpoint = *ep;
+        a.h = h;
+        curl_easy_setopt(h, CURLOPT_POSTFIELDS, body.c_str());
+        curl_easy_setopt(h, CURLOPT_POSTFIELDSIZE, (long)body.size());
+        curl_easy_setopt(h, CURLOPT_WRITEDATA, &a.response);
+        curl_easy_setopt(h, CURLOPT_PRIVATE, &a);
+        ++launched;
+        if (curl_multi_add_handle(multi, h) != CURLM_OK) {
+            a.done = true;
+            a.res = CURLE_FAILED_INIT;
+            abandoned(*ep);
+            return false;
+        }
+        LOG_EVENT(LogLevel::Debug, "rpc.send").str("url", router_.url(*ep)).num("bytes", body.size()).str("body", body);
+        return true;
+    };
+
+    std::optional<GaugeScope> inFlight;
+    if (opts_.metrics) inFlight.emplace(RpcMetrics::global().counters().in_flight);
+
+    Attempt* answer = nullptr;    // first good response
+    Attempt* failed = nullptr;    // last failed one, reported if nothing better comes
+    bool hedged = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opts_.timeout_ms);
+    if (launch(admit(0, deadline))) {
+        const LatencyHistogram& latency =
+            RpcMetrics::global().stats(router_.url(attempts[0].endpoint), method).phase(CallPhase::Total);
+        auto hedgeAt = std::chrono::steady_clock::now() + hedge_delay(opts_.hedge, latency);
+        while (!answer) {
+            int running = 0;
+            curl_multi_perform(multi, &running);
+            int left = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &left)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                Attempt* a = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&a));
+                curl_multi_remove_handle(multi, msg->easy_handle);
+                a->done = true;
+                a->res = msg->data.result;
+                finished(a->endpoint, a->h, a->res, body);
+                log_recv(a->h, a->res);
+                if (throttled(a->h)) a->response.clear();
+                if (!endpoint_failed(a->h, a->res) && !answer) answer = a;
+                else if (!answer) failed = a;
+            }
+            if (answer) break;
+
+            bool pending = false;
+            for (size_t i = 0; i < launched; ++i) pending |= !attempts[i].done;
+            if (!pending) {
+                if (launched < attempts.size() && launch(router_.pick(tried))) {
+                    LOG_EVENT(LogLevel::Warn, "rpc.failover")
+                        .str("url", router_.url(attempts[0].endpoint))
+                        .str("error", curl_easy_strerror(attempts[0].res));
+                    continue;
+                }
+                break;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (launched == 1 && now >= hedgeAt) {
+                if (hedge_budget_.withdraw() && launch(router_.pick(tried))) {
+                    hedged = true;
+                    if (opts_.metrics) RpcMetrics::global().stats(router_.url(attempts[1].endpoint), method).hedges.add();
+                    LOG_EVENT(LogLevel::Debug, "rpc.hedge")
+                        .str("method", method)
+                        .str("slow", router_.url(attempts[0].endpoint))
+                        .str("url", router_.url(attempts[1].endpoint));
+                }
+                hedgeAt = std::chrono::steady_clock::time_point::max();
+            }
+            int waitMs = 1000;
+            if (hedgeAt != std::chrono::steady_clock::time_point::max()) {
+                auto until = std::chrono::duration_cast<std::chrono::milliseconds>(hedgeAt - now).count() + 1;
+                waitMs = (int)std::clamp<int64_t>(until, 0, 1000);
+            }
+            curl_multi_poll(multi, nullptr, 0, waitMs, nullptr);
+        }
+    }
+    if (hedged && answer == &attempts[1] && opts_.metrics) {
+        RpcMetrics::global().stats(router_.url(answer->endpoint), method).hedge_wins.add();
+    }
+
+    Attempt* result = answer ? answer : failed;
+    if (transport && result) {
+        transport->curl = result->res;
+        curl_easy_getinfo(result->h, CURLINFO_RESPONSE_CODE, &transport->http_status);
+        transport->sent = launched > 1 || !never_sent(result->h, result->res);
+        transport->endpoint = result->endpoint;
+    }
+
+    // Cancel the loser; its connection is dropped, the handle goes back.
+    for (size_t i = 0; i < launched; ++i) {
+        Attempt& a = attempts[i];
+        if (!a.done) {
+            curl_multi_remove_handle(multi, a.h);
+            abandoned(a.endpoint);
+        }
+        curl_easy_setopt(a.h, CURLOPT_WRITEDATA, nullptr);
+        curl_easy_setopt(a.h, CURLOPT_PRIVATE, nullptr);
+        release(a.h, a.endpoint);
+    }
+    curl_multi_cleanup(multi);
+
+    if (!result) {
+        if (launched) std::cerr << "Error::No RPC endpoint available\n";   // else admit() said why
+        return std::nullopt;
+    }
+    size_t n = result->response.size();
+    if (n && write(result->response.data(), 1, n, userdata) != n) return CURLE_WRITE_ERROR;
+    return result->res;
+}
+
+std::optional<std::string> RpcClient::post(const std::string& body, RpcTransport* transport) {
+    std::string response;
+    std::optional<CURLcode> res = perform(body, writeCallback, &response, std::nullopt, transport);
+    if (!res) return std::nullopt;
+    if (*res != CURLE_OK) {
+        std::cerr << "Error::" << curl_easy_strerror(*res) << "\n";
+        return std::nullopt;
+    }
+    if (response.empty()) {
+        std::cerr << "Error::Response is empty\n";
+        return std::nullopt;
+    }
+    return response;
+}
+
+static size_t arenaWriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    static_cast<std::pmr::string*>(userdata)->append(ptr, size * nmemb);
+    return size * nmemb;
+}
+
+std::optional<std::string_view> RpcClient::post(const std::string& body, std::pmr::string& response,
+                                                RpcTransport* transport) {
+    response.clear();
+    std::optional<CURLcode> res = perform(body, arenaWriteCallback, &response, std::nullopt, transport);
+    if (!res) return std::nullopt;
+    if (*res != CURLE_OK) {
+        std::cerr << "Error::" << curl_easy_strerror(*res) << "\n";
+        return std::nullopt;
+    }
+    if (response.empty()) {
+        std::cerr << "Error::Response is empty\n";
+        return std::nullopt;
+    }
+    return std::string_view(response);
+}
+
+size_t RpcClient::check_chain_id(uint64_t expected) {
+    static const RpcTemplate chainId("eth_chainId");
+    std::vector<size_t> wrong;
+    for (size_t i = 0; i < router_.size(); ++i) {
+        std::string response;
+        std::optional<CURLcode> res = perform(chainId.render(1, {}), writeCallback, &response, i);
+        std::optional<uint64_t> id =
+            res && *res == CURLE_OK ? rpc_result_quantity(std::optional<std::string_view>(response)) : std::nullopt;
+        if (id && *id != expected) {
+            std::cerr << "Error::" << router_.url(i) << " serves chain " << *id << ", expected " << expected << "\n";
+            wrong.push_back(i);
+        }
+    }
+    // Unreachable endpoints stay: the breaker handles those.
+    if (wrong.size() == router_.size()) return 0;
+    for (size_t i : wrong) router_.disable(i);
+    return router_.size() - wrong.size();
+}
+
+// Runs on the transfer thread: elements are processed while later ones are
+// still on the wire. Returning 0 aborts the transfer on malformed input.
+static size_t streamWriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    RpcStreamParser* parser = static_cast<RpcStreamParser*>(userdata);
+    return parser->feed(ptr, size * nmemb) ? size * nmemb : 0;
+}
+
+bool RpcClient::post_stream(const std::string& body, RpcStreamParser& parser) {
+    std::optional<CURLcode> res = perform(body, streamWriteCallback, &parser);
+    if (!res) return false;
+    if (*res != CURLE_OK) {
+        std::cerr << "Error::" << (*res == CURLE_WRITE_ERROR ? "malformed streamed response" : curl_easy_strerror(*res))
+                  << "\n";
+        return false;
+    }
+    if (!parser.complete()) {
+        std::cerr << "Error::Response is incomplete\n";
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::string> rpc_call(RpcClient& client, const nlohmann::json& j) {
+    return client.call(j);
+}
+
+bool rpc_call_stream(RpcClient& client, const nlohmann::json& j, RpcStreamParser& parser) {
+    return client.post_stream(j.dump(), parser);
+}
+
+// Only the member the caller reads is turned into a DOM; the envelope is
+// walked once by rpc_extract and never materialized.
+RpcResult rpc_result_from(const std::optional<std::string>& raw) {
+    RpcResult r;
+    if (!raw) {
+        r.error = nlohmann::json{{"code", kTransportErrorCode}, {"message", "no response"}};
+        return r;
+    }
+    std::optional<RpcView> v = rpc_extract(*raw);
+    if (!v) {
+        r.error = nlohmann::json{{"code", kTransportErrorCode}, {"message", "malformed response"}};
+        return r;
+    }
+    std::string_view member = v->error.empty() ? v->result : v->error;
+    if (member.empty()) {
+        r.error = nlohmann::json{{"code", kTransportErrorCode}, {"message", "response has no result"}};
+        return r;
+    }
+    nlohmann::json j = nlohmann::json::parse(member.begin(), member.end(), nullptr, false);
+    if (j.is_discarded()) {
+        r.error = nlohmann::json{{"code", kTransportErrorCode}, {"message", "malformed response"}};
+    } else if (!v->error.empty()) {
+        r.error = std::move(j);
+    } else {
+        r.result = std::move(j);
+    }
+    return r;
+}
+
+// -----------------------------------------------------------------------------
+// Utilities
+// -----------------------------------------------------------------------------
+size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    std::string* out = static_cast<std::string*>(userdata);
+    if (!out) {
+        std::cerr << "ERROR::Uploaded data pointer is null\n";
+        return 0;
+    }
+    out->append(ptr, size * nmemb);
+    return size * nmemb;
+}
@@ -0,0 +1,177 @@
+/*
+ * File:        rpc_client.hpp
+ * Created on:  2026-10-17
+ * Description: Pooled JSON-RPC client shared by the SwapDapp and local clients.
+ *              Owns a set of reusable curl easy handles (keep-alive, HTTP/2 where
+ *              the server negotiates it) and a curl share handle so DNS lookups,
+ *              TLS sessions and live connections are reused across calls.
+ *
+ *              The URL may list several endpoints for the same chain,
+ *              separated by commas; every request is then routed by an
+ *              RpcRouter (latency / load / circuit breaker, see
+ *              rpc_router.hpp), and a request that could not even connect is
+ *              sent to the next endpoint instead of failing.
+ */
+
+#pragma once
+
+#include "json_stream.hpp"
+#include "rpc_hedge.hpp"
+#include "rpc_router.hpp"
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Client options
+// -----------------------------------------------------------------------------
+struct RpcClientOptions {
+    size_t max_idle_handles   = 16;     // warm handles kept between calls
+    long   connect_timeout_ms = 10000;
+    long   timeout_ms         = 30000;
+    bool   http2              = true;   // ALPN h2 over TLS, HTTP/1.1 keep-alive otherwise
+    bool   verbose            = false;  // curl wire trace, logged at trace level
+    size_t max_batch_size     = 50;     // JSON-RPC batches above this are split
+    bool   metrics            = true;   // per-call timings into RpcMetrics::global()
+    RouterOptions router;               // multi-endpoint selection, breakers, rate / concurrency limits
+    int    max_throttled_resends = 3;   // HTTP 429s resent (after Retry-After) before giving up
+    HedgeOptions hedge;                 // duplicate slow reads to a second endpoint (off by default)
+    bool   coalesce           = true;   // identical reads in flight share one request (rpc_coalesce.hpp)
+};
+
+// -----------------------------------------------------------------------------
+// Per-call outcome
+// -----------------------------------------------------------------------------
+struct RpcResult {
+    std::optional<nlohmann::json> result;   // "result" member, when present
+    std::optional<nlohmann::json> error;    // JSON-RPC error object (or a synthesized transport error)
+
+    bool ok() const { return result.has_value() && !error; }
+};
+
+// What the wire saw for one post(), so a caller can tell a request that
+// never left from one a node may have acted on.
+struct RpcTransport {
+    CURLcode curl = CURLE_OK;
+    long http_status = 0;                   // last response, 0 if none
+    bool sent = false;                      // may have reached a server
+    std::optional<size_t> endpoint;         // last endpoint tried
+    bool throttle_spent = false;            // 429s already resent max_throttled_resends times
+};
+
+// JSON-RPC "internal error"; used for failures that never reached the server.
+inline constexpr int kTransportErrorCode = -32603;
+
+// Splits a raw single-call response into result / error.
+RpcResult rpc_result_from(const std::optional<std::string>& raw);
+
+class RpcSingleFlight;
+
+// -----------------------------------------------------------------------------
+// RpcClient: one chain's endpoints, many calls, few handshakes
+// -----------------------------------------------------------------------------
+class RpcClient {
+public:
+    // url: one endpoint, or several for the same chain separated by commas.
+    explicit RpcClient(std::string url, RpcClientOptions opts = {});
+    RpcClient(std::vector<std::string> urls, RpcClientOptions opts = {});
+    ~RpcClient();
+
+    RpcClient(const RpcClient&) = delete;
+    RpcClient& operator=(const RpcClient&) = delete;
+
+    // POST a JSON-RPC request object; returns the raw response body.
+    std::optional<std::string> call(const nlohmann::json& j);
+
+    // POST an already serialized body. transport, when given, is filled in
+    // whether or not a response came back.
+    std::optional<std::string> post(const std::string& body, RpcTransport* transport = nullptr);
+
+    // Same, with the body written into response (typically backed by the
+    // thread's RpcArena); the view points into it.
+    std::optional<std::string_view> post(const std::string& body, std::pmr::string& response,
+                                         RpcTransport* transport = nullptr);
+
+    // POST and feed the response to parser chunk by chunk as it arrives,
+    // without buffering the body. False on transport failure, malformed
+    // input or a truncated response.
+    bool post_stream(const std::string& body, RpcStreamParser& parser);
+
+    // First endpoint ("" if none was given).
+    const std::string& url() const;
+    const RpcClientOptions& options() const { return opts_; }
+    RpcRouter& router() { return router_; }
+    // Reads in flight, for rpc_call_coalesced and CoroRpcClient::call.
+    RpcSingleFlight& single_flight() { return *single_flight_; }
+
+    // Asks every endpoint for eth_chainId and takes those serving another
+    // chain out of rotation. Returns how many remain; if none matches, all
+    // are kept and 0 is returned.
+    size_t check_chain_id(uint64_t expected);
+
+    // Routed transfers for transports that drive handles themselves, e.g. the
+    // curl_multi engine: route() picks an endpoint, acquire() / release()
+    // borrow a fully configured handle (URL, headers, share, keep-alive) for
+    // it, and every routed request ends in finished() or abandoned().
+    std::optional<size_t> route(uint64_t exclude = 0, std::chrono::microseconds* wait = nullptr) {
+        return router_.pick(exclude, wait);
+    }
+    CURL* acquire(size_t endpoint);
+    void release(CURL* h, size_t endpoint);
+
+    // Feeds the outcome of a transfer on h to the router and the metrics, and
+    // says whether the request may be sent again.
+    enum class Resend {
+        No,
+        Elsewhere,   // never reached the server: another endpoint, now
+        Later,       // HTTP 429: once the limiter admits it again
+    };
+    Resend finished(size_t endpoint, CURL* h, CURLcode res, std::string_view body);
+    void abandoned(size_t endpoint);
+
+private:
+    struct Pool {
+        std::mutex mu;
+        std::vector<CURL*> idle;
+    };
+
+    CURL* make_handle(size_t endpoint);
+    // Waits for the limiter to admit a request to some endpoint not in
+    // `tried`; nullopt if none will before the deadline.
+    std::optional<size_t> admit(uint64_t tried, std::chrono::steady_clock::time_point deadline);
+    // Shared by post / post_stream; nullopt if the request never went out.
+    // `only` pins the request to one endpoint (no routing, no failover).
+    std::optional<CURLcode> perform(const std::string& body, curl_write_callback write, void* userdata,
+                                    std::optional<size_t> only = std::nullopt, RpcTransport* transport = nullptr);
+    std::optional<CURLcode> perform_hedged(const std::string& body, std::string_view method,
+                                           curl_write_callback write, void* userdata, RpcTransport* transport);
+
+    static void share_lock(CURL* h, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void share_unlock(CURL* h, curl_lock_data data, void* userptr);
+
+    RpcClientOptions opts_;
+    RpcRouter router_;
+    HedgeBudget hedge_budget_;
+    std::vector<std::unique_ptr<Pool>> pools_;   // per endpoint
+    std::unique_ptr<RpcSingleFlight> single_flight_;
+
+    CURLSH* share_ = nullptr;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> share_mu_;
+    curl_slist* headers_ = nullptr;       // built once, shared by every handle
+};
+
+// -----------------------------------------------------------------------------
+// Free-function entry points used by the clients
+// -----------------------------------------------------------------------------
+std::optional<std::string> rpc_call(RpcClient& client, const nlohmann::json& j);
+bool rpc_call_stream(RpcClient& client, const nlohmann::json& j, RpcStreamParser& parser);
+size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
@@ -0,0 +1,123 @@
+/*
+ * File:        rpc_coalesce.cpp
+ * Created on:  2026-10-17
+ * Description: Single-flight coalescing of identical reads (see rpc_coalesce.hpp).
+ */
+
+#include "rpc_coalesce.hpp"
+#include "hex_codec.hpp"
+#include "rpc_hedge.hpp"
+#include "rpc_metrics.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <iterator>
+
+// -----------------------------------------------------------------------------
+// Key
+// -----------------------------------------------------------------------------
+static bool is_block_tag(const std::string& lower) {
+    static constexpr std::string_view kTags[] = {"latest", "pending", "earliest", "safe", "finalized"};
+    return std::find(std::begin(kTags), std::end(kTags), lower) != std::end(kTags);
+}
+
+// Hex is case-insensitive on the wire, so is the key. Other strings
+// (e.g. an ENS-style label in a filter) are left alone.
+static void canonicalize(nlohmann::json& j) {
+    if (j.is_string()) {
+        std::string& s = j.get_ref<std::string&>();
+        bool hex = s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X');
+        std::string lower = to_lower_ascii(s);
+        if (hex || is_block_tag(lower)) s = std::move(lower);
+    } else if (j.is_structured()) {
+        for (auto& v : j) canonicalize(v);   // objects iterate sorted by key already
+    }
+}
+
+// Index of the optional trailing block tag, for the methods that have one.
+static std::optional<size_t> block_tag_index(std::string_view method) {
+    if (method == "eth_call" || method == "eth_estimateGas" || method == "eth_getBalance" || method == "eth_getCode" ||
+        method == "eth_getTransactionCount") {
+        return 1;
+    }
+    if (method == "eth_getStorageAt") return 2;
+    return std::nullopt;
+}
+
+std::optional<std::string> rpc_coalesce_key(std::string_view method, const nlohmann::json& params) {
+    if (!rpc_method_hedgeable(method)) return std::nullopt;
+    nlohmann::json p = params.is_null() ? nlohmann::json::array() : params;
+    if (std::optional<size_t> tag = block_tag_index(method); tag && p.is_array() && p.size() == *tag) {
+        p.push_back("latest");
+    }
+    canonicalize(p);
+    std::string key(method);
+    key += ' ';
+    key += p.dump();
+    return key;
+}
+
+std::optional<std::string> rpc_rendered_coalesce_key(const std::string& rendered) {
+    if (!rpc_method_hedgeable(rpc_method_of(rendered))) return std::nullopt;
+    size_t id = rendered.rfind(R"(,"id":)");
+    if (id == std::string::npos) return std::nullopt;
+    return rendered.substr(0, id);
+}
+
+// -----------------------------------------------------------------------------
+// RpcSingleFlight
+// -----------------------------------------------------------------------------
+bool RpcSingleFlight::join(const std::string& key, Waiter done) {
+    bool lead;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto [it, inserted] = flights_.try_emplace(key);
+        it->second.push_back(std::move(done));
+        lead = inserted;
+    }
+    ClientCounters& k = RpcMetrics::global().counters();
+    (lead ? k.coalesce_leads : k.coalesce_joins).add();
+    return lead;
+}
+
+void RpcSingleFlight::complete(const std::string& key, RpcResult result) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = flights_.find(key);
+        if (it == flights_.end()) return;
+        waiters = std::move(it->second);
+        flights_.erase(it);
+    }
+    Result shared = std::make_shared<const RpcResult>(std::move(result));
+    for (const Waiter& w : waiters) w(shared);
+}
+
+RpcSingleFlight::Result RpcSingleFlight::run(const std::string& key, const std::function<RpcResult()>& fetch) {
+    std::promise<Result> answer;
+    std::future<Result> ready = answer.get_future();
+    if (join(key, [&answer](const Result& r) { answer.set_value(r); })) {
+        RpcResult result;
+        try {
+            result = fetch();
+        } catch (const std::exception& e) {
+            nlohmann::json error = {{"code", kTransportErrorCode}, {"message", e.what()}};
+            complete(key, RpcResult{std::nullopt, std::move(error)});
+            throw;
+        }
+        complete(key, std::move(result));
+    }
+    return ready.get();
+}
+
+// -----------------------------------------------------------------------------
+// Blocking entry point
+// -----------------------------------------------------------------------------
+RpcResult rpc_call_coalesced(RpcClient& client, std::string_view method, const nlohmann::json& params,
+                             const RetryOptions& opts) {
+    nlohmann::json req = {{"jsonrpc", "2.0"}, {"id", 1}, {"method", method}, {"params", params}};
+    std::optional<std::string> key = client.options().coalesce ? rpc_coalesce_key(method, params) : std::nullopt;
+    if (!key) return rpc_call_retry(client, req, opts);
+    return *client.single_flight().run(*key, [&] { return rpc_call_retry(client, req, opts); });
+}
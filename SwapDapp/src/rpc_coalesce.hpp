@@ -0,0 +1,71 @@
+/*
+ * File:        rpc_coalesce.hpp
+ * Created on:  2026-10-17
+ * Description: Single-flight coalescing of identical reads. While a request
+ *              is on the wire, every other caller asking the same thing
+ *              (eth_chainId, a token's decimals(), an allowance for the
+ *              shared executor at the same block tag) joins it instead of
+ *              sending its own: one round trip, one parsed RpcResult handed
+ *              to all of them. Nothing is cached once the answer is in; the
+ *              next caller sends again.
+ *
+ *              The key is the method plus its params in canonical form: hex
+ *              strings and block tags lower-cased (checksummed and plain
+ *              addresses match), object members in sorted order, and the
+ *              default "latest" written out where a method's block tag is
+ *              optional. Only reads (rpc_method_hedgeable) get a key; a write
+ *              is never shared.
+ *
+ *              RpcClient owns one table, so blocking callers
+ *              (rpc_call_coalesced) and coroutines (CoroRpcClient::call) on
+ *              the same client share each other's requests.
+ */
+
+#pragma once
+
+#include "rpc_client.hpp"
+#include "rpc_retry.hpp"
+
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Canonical "method params" key; nullopt for calls that must not be shared.
+std::optional<std::string> rpc_coalesce_key(std::string_view method, const nlohmann::json& params);
+// Same for a body rendered by RpcTemplate: the text before the trailing id.
+// Not canonicalized, so it joins identical template calls only, never a
+// call() with the same params.
+std::optional<std::string> rpc_rendered_coalesce_key(const std::string& rendered);
+
+class RpcSingleFlight {
+public:
+    using Result = std::shared_ptr<const RpcResult>;
+    using Waiter = std::function<void(const Result&)>;
+
+    // Registers done for key's answer. Returns true if the caller leads: it
+    // sends the request and must call complete(key, ...) exactly once.
+    bool join(const std::string& key, Waiter done);
+    // Hands the answer to every waiter of key, the leader's included, and
+    // forgets the key. Waiters run on this thread, outside the lock.
+    void complete(const std::string& key, RpcResult result);
+
+    // Blocking: runs fetch() on this thread unless an identical call is in
+    // flight, in which case waits for that one's answer. If fetch() throws,
+    // the waiters get a transport error and the exception goes to the leader.
+    Result run(const std::string& key, const std::function<RpcResult()>& fetch);
+
+private:
+    std::mutex mu_;
+    std::unordered_map<std::string, std::vector<Waiter>> flights_;
+};
+
+// Read through client's single-flight table (with rpc_call_retry's retries
+// for the leader); plain rpc_call_retry for writes or with coalescing off.
+RpcResult rpc_call_coalesced(RpcClient& client, std::string_view method, const nlohmann::json& params,
+                             const RetryOptions& opts = {});
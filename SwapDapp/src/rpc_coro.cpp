@@ -0,0 +1,192 @@
+/*
+ * File:        rpc_coro.cpp
+ * Created on:  2026-10-17
+ * Description: C++20 coroutine interface over AsyncRpcEngine (see rpc_coro.hpp).
+ */
+
+#include "rpc_coro.hpp"
+#include "rpc_coalesce.hpp"
+#include "rpc_metrics.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// -----------------------------------------------------------------------------
+// ThreadPool
+// -----------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(&ThreadPool::worker, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void ThreadPool::post(std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        queue_.push_back(std::move(fn));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::worker() {
+    for (;;) {
+        std::function<void()> fn;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;   // stopping and drained
+            fn = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        fn();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Awaitables: the engine completes them, the pool resumes them
+// -----------------------------------------------------------------------------
+void CoroRpcClient::CallAwaitable::await_suspend(std::coroutine_handle<> h) {
+    if (key.empty()) {
+        rpc.engine().submit(std::move(body), [this, h](std::optional<std::string> raw) {
+            result = rpc_result_from(raw);
+            rpc.pool().post([h]() { h.resume(); });
+        });
+        return;
+    }
+    // The leader's response is parsed once; each waiter gets a copy.
+    RpcSingleFlight& flights = rpc.engine().client().single_flight();
+    bool lead = flights.join(key, [this, h](const RpcSingleFlight::Result& r) {
+        result = *r;
+        rpc.pool().post([h]() { h.resume(); });
+    });
+    if (!lead) return;
+    rpc.engine().submit(std::move(body), [&flights, key = key](std::optional<std::string> raw) {
+        flights.complete(key, rpc_result_from(raw));
+    });
+}
+
+void CoroRpcClient::SleepAwaitable::await_suspend(std::coroutine_handle<> h) {
+    CoroRpcClient& r = rpc;
+    r.engine().schedule_after(delay, [&r, h]() { r.pool().post([h]() { h.resume(); }); });
+}
+
+void CoroRpcClient::HeadAwaitable::await_suspend(std::coroutine_handle<> h) {
+    CoroRpcClient& r = rpc;
+    heads.on_next_head([this, &r, h](bool arrived) {
+        got = arrived;
+        r.pool().post([h]() { h.resume(); });
+    }, timeout);
+}
+
+void CoroRpcClient::TrackedReceiptAwaitable::await_suspend(std::coroutine_handle<> h) {
+    CoroRpcClient& r = rpc;
+    tracker.track(txhash, [this, &r, h](std::optional<nlohmann::json> rcpt) {
+        receipt = std::move(rcpt);
+        r.pool().post([h]() { h.resume(); });
+    }, timeout);
+}
+
+nlohmann::json CoroRpcClient::TrackedReceiptAwaitable::await_resume() {
+    if (!valid) throw std::invalid_argument("not a transaction hash");
+    if (!receipt) throw std::runtime_error("timeout waiting for receipt");
+    return std::move(*receipt);
+}
+
+CoroRpcClient::CallAwaitable CoroRpcClient::call(const std::string& method, nlohmann::json params) {
+    std::optional<std::string> key =
+        engine_.client().options().coalesce ? rpc_coalesce_key(method, params) : std::nullopt;
+    nlohmann::json req = {
+        {"jsonrpc", "2.0"},
+        {"id", next_id_.fetch_add(1, std::memory_order_relaxed)},
+        {"method", method},
+        {"params", std::move(params)}
+    };
+    return CallAwaitable{*this, req.dump(), {}, key.value_or(std::string())};
+}
+
+CoroRpcClient::CallAwaitable CoroRpcClient::call(const RpcTemplate& tmpl, std::initializer_list<RpcArg> args) {
+    std::string body = tmpl.render(next_id_.fetch_add(1, std::memory_order_relaxed), args);
+    std::optional<std::string> key =
+        engine_.client().options().coalesce ? rpc_rendered_coalesce_key(body) : std::nullopt;
+    return CallAwaitable{*this, std::move(body), {}, key.value_or(std::string())};
+}
+
+// -----------------------------------------------------------------------------
+// Retried calls
+// -----------------------------------------------------------------------------
+// Outside the coroutine, like receipt_call below.
+static std::optional<Hash32> sent_tx(const std::string& method, const nlohmann::json& params) {
+    if (method != "eth_sendRawTransaction" || !params.is_array() || params.empty() || !params[0].is_string()) {
+        return std::nullopt;
+    }
+    return rpc_raw_tx_hash(params[0].get<std::string>());
+}
+
+// The engine already fails over and waits out 429s per attempt; this adds
+// the classified, jittered retries on top. Each attempt gets a fresh id.
+Task<RpcResult> CoroRpcClient::call_retry(std::string method, nlohmann::json params, RetryOptions opts) {
+    RpcRetry retry(method, opts, sent_tx(method, params));
+    for (RpcRetry::Next next = retry.start(); next != RpcRetry::Next::Done;) {
+        if (next == RpcRetry::Next::Lookup) {
+            next = retry.on_lookup(co_await call_retry("eth_getTransactionByHash", rpc_tx_lookup_params(*retry.tx()), opts));
+            continue;
+        }
+        co_await sleep_for(retry.delay());
+        next = retry.on_answer(co_await call(method, params));
+    }
+    co_return retry.take_result();
+}
+
+// -----------------------------------------------------------------------------
+// Receipt polling
+// -----------------------------------------------------------------------------
+// Outside the coroutine: GCC 12 mis-compiles initializer lists in coroutine frames.
+static CoroRpcClient::CallAwaitable receipt_call(CoroRpcClient& rpc, const std::string& txhash) {
+    static const RpcTemplate kReceipt("eth_getTransactionReceipt", R"(["$0"])");
+    return rpc.call(kReceipt, {txhash});
+}
+
+Task<nlohmann::json> CoroRpcClient::receipt(std::string txhash, HeadSubscriber* heads,
+                                            std::chrono::milliseconds timeout) {
+    static const FixedPollPolicy legacy(kReceiptPollInterval);
+    co_return co_await receipt(std::move(txhash), legacy, heads, timeout);
+}
+
+Task<nlohmann::json> CoroRpcClient::receipt(std::string txhash, const PollPolicy& policy,
+                                            HeadSubscriber* heads, std::chrono::milliseconds timeout,
+                                            ReceiptWaitStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + timeout;
+    ReceiptWaitStats local;
+    ReceiptWaitStats& st = stats ? *stats : local;
+    st = ReceiptWaitStats{};
+    GaugeScope pending(RpcMetrics::global().counters().pending_txs);
+    for (;;) {
+        ++st.polls;
+        RpcMetrics::global().counters().receipt_polls_coro.add();
+        RpcResult r = co_await receipt_call(*this, txhash);
+        if (r.ok() && !r.result->is_null()) {
+            st.confirmed = true;
+            st.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            co_return std::move(*r.result);
+        }
+
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) break;
+        if (heads && heads->connected() && co_await next_head(*heads, left)) continue;
+        co_await sleep_for(std::min(left, policy.next_delay(st.polls)));
+    }
+    st.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    throw std::runtime_error("timeout waiting for receipt");
+}
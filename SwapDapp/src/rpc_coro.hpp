@@ -0,0 +1,296 @@
+/*
+ * File:        rpc_coro.hpp
+ * Created on:  2026-10-17
+ * Description: C++20 coroutine interface over AsyncRpcEngine. A workflow such as
+ *              approve -> receipt -> allowance -> swap reads like blocking code
+ *              (co_await rpc.call(...), co_await rpc.receipt(hash)) but never parks
+ *              a thread: requests and sleeps are driven by the engine loop and the
+ *              coroutine resumes on a small ThreadPool. Hundreds of flows can be
+ *              interleaved on a handful of threads.
+ */
+
+#pragma once
+
+#include "receipt.hpp"
+#include "rpc_async.hpp"
+#include "rpc_client.hpp"
+#include "rpc_retry.hpp"
+#include "rpc_template.hpp"
+#include "tx_tracker.hpp"
+#include "ws_transport.hpp"
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// ThreadPool: where coroutine bodies run between awaits
+// -----------------------------------------------------------------------------
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = 2);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void post(std::function<void()> fn);
+
+private:
+    void worker();
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+// -----------------------------------------------------------------------------
+// Task<T>: lazily started, awaitable coroutine result
+// -----------------------------------------------------------------------------
+template <typename T = void>
+class [[nodiscard]] Task;
+
+namespace coro_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Symmetric transfer back to whoever awaited us.
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            if (auto c = h.promise().continuation) return c;
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace coro_detail
+
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = coro_detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit Task(handle_type h) : h_(h) {}
+    Task(Task&& o) noexcept : h_(std::exchange(o.h_, {})) {}
+    Task& operator=(Task&& o) noexcept {
+        if (this != &o) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(o.h_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if (h_) h_.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        h_.promise().continuation = awaiting;
+        return h_;
+    }
+    T await_resume() { return h_.promise().take(); }
+
+private:
+    handle_type h_;
+};
+
+namespace coro_detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Fire-and-forget frame that owns a Task until it completes.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+template <typename T>
+Detached run_detached(Task<T> task, std::shared_ptr<std::promise<T>> out) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            out->set_value();
+        } else {
+            out->set_value(co_await task);
+        }
+    } catch (...) {
+        out->set_exception(std::current_exception());
+    }
+}
+
+} // namespace coro_detail
+
+// Starts a task on the pool; the future completes when the coroutine does.
+template <typename T>
+std::future<T> spawn(ThreadPool& pool, Task<T> task) {
+    auto out = std::make_shared<std::promise<T>>();
+    std::future<T> fut = out->get_future();
+    auto holder = std::make_shared<Task<T>>(std::move(task));
+    pool.post([holder, out]() { coro_detail::run_detached(std::move(*holder), out); });
+    return fut;
+}
+
+// Blocks the calling thread (e.g. main) until the task finishes.
+template <typename T>
+T sync_wait(ThreadPool& pool, Task<T> task) {
+    return spawn(pool, std::move(task)).get();
+}
+
+// -----------------------------------------------------------------------------
+// CoroRpcClient
+// -----------------------------------------------------------------------------
+class CoroRpcClient {
+public:
+    CoroRpcClient(AsyncRpcEngine& engine, ThreadPool& pool) : engine_(engine), pool_(pool) {}
+
+    // co_await rpc.call("eth_call", params) -> RpcResult. Reads join an
+    // identical request already in flight on the client (rpc_coalesce.hpp).
+    struct CallAwaitable {
+        CoroRpcClient& rpc;
+        std::string body;
+        RpcResult result;
+        std::string key;    // single-flight key; empty = always sent
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h);
+        RpcResult await_resume() { return std::move(result); }
+    };
+
+    // co_await rpc.sleep_for(ms) without blocking a pool thread.
+    struct SleepAwaitable {
+        CoroRpcClient& rpc;
+        std::chrono::milliseconds delay;
+
+        bool await_ready() const noexcept { return delay.count() <= 0; }
+        void await_suspend(std::coroutine_handle<> h);
+        void await_resume() const noexcept {}
+    };
+
+    // co_await rpc.next_head(heads, timeout) -> true on a new block, false on
+    // timeout or when the subscription is down.
+    struct HeadAwaitable {
+        CoroRpcClient& rpc;
+        HeadSubscriber& heads;
+        std::chrono::milliseconds timeout;
+        bool got = false;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h);
+        bool await_resume() const noexcept { return got; }
+    };
+
+    // co_await rpc.receipt(hash, tracker) -> receipt; resolved by the tracker's
+    // per-block sweep. Throws std::runtime_error on timeout and
+    // std::invalid_argument for a malformed hex hash.
+    struct TrackedReceiptAwaitable {
+        CoroRpcClient& rpc;
+        TxTracker& tracker;
+        Hash32 txhash;
+        bool valid;
+        std::optional<std::chrono::milliseconds> timeout;
+        std::optional<nlohmann::json> receipt;
+
+        bool await_ready() const noexcept { return !valid; }
+        void await_suspend(std::coroutine_handle<> h);
+        nlohmann::json await_resume();
+    };
+
+    CallAwaitable call(const std::string& method, nlohmann::json params = nlohmann::json::array());
+    // Fixed-shape requests: no json tree, only the id and arguments are written.
+    // Reads join identical template calls in flight (rpc_rendered_coalesce_key).
+    CallAwaitable call(const RpcTemplate& tmpl, std::initializer_list<RpcArg> args = {});
+    // Same, resent after transient failures as RpcRetry allows: reads and
+    // eth_sendRawTransaction (deduplicated by tx hash); other writes only if
+    // they were refused as rate limited.
+    Task<RpcResult> call_retry(std::string method, nlohmann::json params = nlohmann::json::array(),
+                               RetryOptions opts = {});
+    SleepAwaitable sleep_for(std::chrono::milliseconds delay) { return {*this, delay}; }
+    HeadAwaitable next_head(HeadSubscriber& heads, std::chrono::milliseconds timeout) { return {*this, heads, timeout}; }
+
+    // Same policy as wait_receipt (per-block with heads, polling otherwise), but
+    // suspends between checks. Throws std::runtime_error on timeout.
+    Task<nlohmann::json> receipt(std::string txhash, HeadSubscriber* heads = nullptr,
+                                 std::chrono::milliseconds timeout = kReceiptTimeout);
+    // `policy` and `stats` must outlive the returned task.
+    Task<nlohmann::json> receipt(std::string txhash, const PollPolicy& policy,
+                                 HeadSubscriber* heads = nullptr,
+                                 std::chrono::milliseconds timeout = kPolicyReceiptTimeout,
+                                 ReceiptWaitStats* stats = nullptr);
+    TrackedReceiptAwaitable receipt(const Hash32& txhash, TxTracker& tracker,
+                                    std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+        return {*this, tracker, txhash, true, timeout, std::nullopt};
+    }
+    TrackedReceiptAwaitable receipt(std::string_view txhash, TxTracker& tracker,
+                                    std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+        std::optional<Hash32> h = Hash32::from_hex(txhash);
+        return {*this, tracker, h.value_or(Hash32()), h.has_value(), timeout, std::nullopt};
+    }
+
+    AsyncRpcEngine& engine() { return engine_; }
+    ThreadPool& pool() { return pool_; }
+
+private:
+    AsyncRpcEngine& engine_;
+    ThreadPool& pool_;
+    std::atomic<int64_t> next_id_{1};
+};
@@ -0,0 +1,65 @@
+/*
+ * File:        rpc_hedge.cpp
+ * Created on:  2026-10-17
+ * Description: Hedged read policy (see rpc_hedge.hpp).
+ */
+
+#include "rpc_hedge.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+bool rpc_method_hedgeable(std::string_view method) {
+    static constexpr std::string_view kReads[] = {
+        "eth_blockNumber",          "eth_call",
+        "eth_chainId",              "eth_estimateGas",
+        "eth_feeHistory",           "eth_gasPrice",
+        "eth_getBalance",           "eth_getBlockByHash",
+        "eth_getBlockByNumber",     "eth_getBlockReceipts",
+        "eth_getCode",              "eth_getLogs",
+        "eth_getStorageAt",         "eth_getTransactionByHash",
+        "eth_getTransactionCount",  "eth_getTransactionReceipt",
+        "eth_maxPriorityFeePerGas", "net_version",
+    };
+    return std::find(std::begin(kReads), std::end(kReads), method) != std::end(kReads);
+}
+
+std::chrono::microseconds hedge_delay(const HedgeOptions& opts, const LatencyHistogram& latency) {
+    using std::chrono::microseconds;
+    if (latency.count() < opts.min_samples) return opts.initial_delay;
+    microseconds d((int64_t)latency.percentile(opts.percentile));
+    return std::clamp<microseconds>(d, opts.min_delay, opts.max_delay);
+}
+
+// -----------------------------------------------------------------------------
+// HedgeBudget
+// -----------------------------------------------------------------------------
+HedgeBudget::HedgeBudget(double ratio, double burst) : ratio_(ratio), burst_(burst), tokens_(burst) {}
+
+void HedgeBudget::deposit() {
+    std::lock_guard<std::mutex> lock(mu_);
+    tokens_ = std::min(burst_, tokens_ + ratio_);
+}
+
+bool HedgeBudget::withdraw() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+HedgeOptions hedge_options_from_env() {
+    HedgeOptions opts;
+    const char* v = std::getenv("WEB3_RPC_HEDGE");
+    if (!v) return opts;
+    char* end = nullptr;
+    double x = std::strtod(v, &end);
+    if (end == v || x < 0 || x > 1) {
+        LOG_EVENT(LogLevel::Error, "config.invalid").str("var", "WEB3_RPC_HEDGE").str("value", v);
+        return opts;
+    }
+    opts.enabled = x > 0;
+    if (x > 0 && x < 1) opts.percentile = x;
+    return opts;
+}
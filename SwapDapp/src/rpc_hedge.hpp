@@ -0,0 +1,70 @@
+/*
+ * File:        rpc_hedge.hpp
+ * Created on:  2026-10-17
+ * Description: Hedged reads. With several endpoints configured, a read-only
+ *              request (eth_call, eth_getTransactionReceipt, eth_chainId,
+ *              ...) that has not been answered after the endpoint's learned
+ *              latency percentile for that method is sent once more to a
+ *              second endpoint; the first good answer is used and the other
+ *              transfer is cancelled. p99 then tracks the faster of two nodes
+ *              instead of the slower.
+ *
+ *              The percentile comes from RpcMetrics' per endpoint/method
+ *              total-latency histogram (so RpcClientOptions::metrics must be
+ *              on to learn it); until min_samples calls are recorded the
+ *              delay is initial_delay. Cancelled attempts are not recorded,
+ *              which biases the percentile low; the budget bounds the cost.
+ *
+ *              HedgeBudget caps the extra load: every hedgeable request
+ *              earns `ratio` of a token (up to `burst`), every hedge spends
+ *              one, so in the long run at most ratio x requests are
+ *              duplicated however slow the endpoints get.
+ *
+ *              Off by default; WEB3_RPC_HEDGE=1 (or a percentile such as
+ *              0.9) turns it on through hedge_options_from_env().
+ */
+
+#pragma once
+
+#include "rpc_metrics.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+
+struct HedgeOptions {
+    bool enabled = false;
+    double percentile = 0.95;                       // hedge when slower than this share of past calls
+    size_t min_samples = 20;                        // below this, wait initial_delay
+    std::chrono::milliseconds initial_delay{250};
+    std::chrono::milliseconds min_delay{5};
+    std::chrono::milliseconds max_delay{2000};
+    double budget_ratio = 0.05;                     // long-run hedges per hedgeable request
+    double budget_burst = 5;                        // hedges available at once
+};
+
+// Methods safe to send twice: reads with no side effects on the node.
+bool rpc_method_hedgeable(std::string_view method);
+
+// How long to wait for the first attempt given the endpoint/method's
+// latency so far.
+std::chrono::microseconds hedge_delay(const HedgeOptions& opts, const LatencyHistogram& latency);
+
+class HedgeBudget {
+public:
+    HedgeBudget(double ratio, double burst);
+
+    void deposit();    // one hedgeable request
+    bool withdraw();   // one hedge; false when over budget
+
+private:
+    std::mutex mu_;
+    double ratio_;
+    double burst_;
+    double tokens_;
+};
+
+// WEB3_RPC_HEDGE: unset or 0 = off, 1 = on with defaults, 0 < p < 1 = on
+// with that percentile.
+HedgeOptions hedge_options_from_env();
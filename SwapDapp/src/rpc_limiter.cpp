@@ -0,0 +1,95 @@
+/*
+ * File:        rpc_limiter.cpp
+ * Created on:  2026-10-17
+ * Description: Token bucket and AIMD concurrency limit (see rpc_limiter.hpp).
+ */
+
+#include "rpc_limiter.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// -----------------------------------------------------------------------------
+// TokenBucket
+// -----------------------------------------------------------------------------
+TokenBucket::TokenBucket(double rate, double burst)
+    : rate_(rate), burst_(std::max(1.0, burst)), tokens_(burst_), last_(LimiterClock::now()) {}
+
+void TokenBucket::refill(LimiterClock::time_point now) {
+    if (now <= last_) return;
+    double secs = std::chrono::duration<double>(now - last_).count();
+    tokens_ = std::min(burst_, tokens_ + secs * rate_);
+    last_ = now;
+}
+
+bool TokenBucket::take(LimiterClock::time_point now) {
+    if (rate_ <= 0) return true;
+    refill(now);
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+std::chrono::microseconds TokenBucket::wait(LimiterClock::time_point now) const {
+    if (rate_ <= 0) return std::chrono::microseconds(0);
+    double secs = now > last_ ? std::chrono::duration<double>(now - last_).count() : 0.0;
+    double have = std::min(burst_, tokens_ + secs * rate_);
+    if (have >= 1.0) return std::chrono::microseconds(0);
+    return std::chrono::microseconds((int64_t)std::ceil((1.0 - have) / rate_ * 1e6));
+}
+
+// -----------------------------------------------------------------------------
+// AimdLimiter
+// -----------------------------------------------------------------------------
+AimdLimiter::AimdLimiter(const LimiterOptions& opts)
+    : min_(std::max(1.0, opts.min_concurrency)),
+      max_(std::max(min_, opts.max_concurrency)),
+      factor_(opts.decrease),
+      growth_(opts.latency_growth),
+      slack_us_((double)std::chrono::duration_cast<std::chrono::microseconds>(opts.latency_slack).count()),
+      limit_(std::clamp(opts.initial_concurrency, min_, max_)) {}
+
+void AimdLimiter::on_answer(double latency_us, uint32_t in_flight, LimiterClock::time_point now) {
+    // The baseline forgets a fast outlier over a few hundred answers, so a
+    // route change does not leave the limiter convinced it is congested.
+    baseline_us_ = baseline_us_ == 0 ? latency_us : std::min(latency_us, baseline_us_ * 1.005);
+    // Smoothed, so one slow answer (GC pause, a heavy eth_call) is not
+    // taken for a queue building up at the node.
+    smoothed_us_ = smoothed_us_ == 0 ? latency_us : 0.8 * smoothed_us_ + 0.2 * latency_us;
+    // Only a limit that is being used can be what the node is queueing on.
+    bool busy = (double)in_flight + 1 >= limit_ / 2;
+    if (growth_ > 0 && busy && smoothed_us_ > growth_ * baseline_us_ && smoothed_us_ - baseline_us_ > slack_us_) {
+        decrease(now, smoothed_us_);
+        return;
+    }
+    if (busy) limit_ = std::min(max_, limit_ + 1.0 / limit_);
+}
+
+void AimdLimiter::on_throttled(LimiterClock::time_point now) {
+    decrease(now, baseline_us_);
+}
+
+// One cut per round trip: the answers already in flight all carry the same
+// news.
+void AimdLimiter::decrease(LimiterClock::time_point now, double round_trip_us) {
+    if (now < cooldown_until_) return;
+    limit_ = std::max(min_, limit_ * factor_);
+    cooldown_until_ = now + std::chrono::microseconds((int64_t)std::max(round_trip_us, 1000.0));
+}
+
+LimiterOptions limiter_options_from_env() {
+    LimiterOptions opts;
+    const char* v = std::getenv("WEB3_RPC_RATE");
+    if (!v) return opts;
+    char* end = nullptr;
+    double rate = std::strtod(v, &end);
+    if (end == v || rate < 0) {
+        LOG_EVENT(LogLevel::Error, "config.invalid").str("var", "WEB3_RPC_RATE").str("value", v);
+        return opts;
+    }
+    opts.rate = rate;
+    opts.burst = std::max(1.0, std::min(opts.burst, rate));
+    return opts;
+}
@@ -0,0 +1,92 @@
+/*
+ * File:        rpc_limiter.hpp
+ * Created on:  2026-10-17
+ * Description: Client-side admission control for one RPC endpoint, so
+ *              public nodes that throttle (HTTP 429) see a steady client
+ *              instead of bursts followed by bans.
+ *
+ *              TokenBucket caps the request rate at a configured number of
+ *              requests per second (the provider's published limit).
+ *
+ *              AimdLimiter caps requests in flight and finds the sustainable
+ *              level by itself: each answered request raises the cap by
+ *              1/cap (about +1 per round trip at full load) while at least
+ *              half of it is in use; a 429, or smoothed round trips
+ *              latency_growth times the baseline (and latency_slack above
+ *              it) at that load, multiplies it by `decrease`, at most once
+ *              per round trip.
+ *              A 429 also stops the endpoint for its Retry-After (or
+ *              default_retry_after when the header is missing).
+ *
+ *              Both are plain state with no lock: RpcRouter owns one of each
+ *              per endpoint and drives them under its mutex.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+struct LimiterOptions {
+    double rate = 0;                                        // requests/s per endpoint, 0 = unlimited
+    double burst = 10;                                      // requests the bucket can send at once
+    double initial_concurrency = 16;
+    double min_concurrency = 1;
+    double max_concurrency = 256;
+    double decrease = 0.7;                                  // multiplicative decrease
+    double latency_growth = 3.0;                            // round trip above this x baseline = congestion,
+    std::chrono::milliseconds latency_slack{20};            // ... and at least this much above it
+    std::chrono::milliseconds default_retry_after{1000};    // 429 without a Retry-After header
+    std::chrono::milliseconds max_retry_after{60000};
+};
+
+using LimiterClock = std::chrono::steady_clock;
+
+class TokenBucket {
+public:
+    TokenBucket(double rate, double burst);
+
+    // Takes a token if one is there; otherwise how long until one is.
+    bool take(LimiterClock::time_point now);
+    std::chrono::microseconds wait(LimiterClock::time_point now) const;
+
+    double rate() const { return rate_; }
+
+private:
+    void refill(LimiterClock::time_point now);
+
+    double rate_;
+    double burst_;
+    double tokens_;
+    LimiterClock::time_point last_;
+};
+
+class AimdLimiter {
+public:
+    explicit AimdLimiter(const LimiterOptions& opts);
+
+    bool admits(uint32_t in_flight) const { return (double)in_flight < limit_; }
+
+    // in_flight: requests outstanding besides this one.
+    void on_answer(double latency_us, uint32_t in_flight, LimiterClock::time_point now);
+    void on_throttled(LimiterClock::time_point now);
+
+    double limit() const { return limit_; }
+
+private:
+    void decrease(LimiterClock::time_point now, double round_trip_us);
+
+    double min_;
+    double max_;
+    double factor_;
+    double growth_;
+    double slack_us_;
+    double limit_;
+    double baseline_us_ = 0;            // lowest recent round trip, drifts up slowly
+    double smoothed_us_ = 0;            // EWMA of round trips
+    LimiterClock::time_point cooldown_until_{};
+};
+
+// WEB3_RPC_RATE: requests per second per endpoint (unset = no rate cap; the
+// concurrency limit adapts either way).
+LimiterOptions limiter_options_from_env();
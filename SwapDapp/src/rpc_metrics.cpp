@@ -0,0 +1,306 @@
+/*
+ * File:        rpc_metrics.cpp
+ * Created on:  2026-10-17
+ * Description: Per-call instrumentation (see rpc_metrics.hpp).
+ */
+
+#include "rpc_metrics.hpp"
+#include "json_extract.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// -----------------------------------------------------------------------------
+// ShardedCounter
+// -----------------------------------------------------------------------------
+unsigned next_metric_shard() {
+    static std::atomic<unsigned> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ShardedCounter::value() const {
+    uint64_t sum = 0;
+    for (const Shard& s : shards_) sum += s.v.load(std::memory_order_relaxed);
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+// LatencyHistogram
+// -----------------------------------------------------------------------------
+size_t LatencyHistogram::bucket_of(uint64_t us) {
+    if (us < (1u << kSubBits)) return (size_t)us;
+    unsigned e = 63 - (unsigned)__builtin_clzll(us);
+    if (e >= kMaxBits) return kBuckets - 1;
+    return ((size_t)(e - kSubBits + 1) << kSubBits) | (size_t)((us >> (e - kSubBits)) & ((1u << kSubBits) - 1));
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t bucket) {
+    if (bucket < (1u << kSubBits)) return bucket;
+    size_t group = bucket >> kSubBits;
+    uint64_t sub = bucket & ((1u << kSubBits) - 1);
+    unsigned shift = (unsigned)group - 1;
+    return (((1u << kSubBits) + sub) << shift) + ((uint64_t)1 << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    buckets_[metric_shard() % kShards][bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+    sum_.add(us);
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (us > seen && !max_.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::bucket_count(size_t bucket) const {
+    uint64_t n = 0;
+    for (const auto& shard : buckets_) n += shard[bucket].load(std::memory_order_relaxed);
+    return n;
+}
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t n = 0;
+    for (size_t b = 0; b < kBuckets; ++b) n += bucket_count(b);
+    return n;
+}
+
+double LatencyHistogram::mean_us() const {
+    uint64_t n = count();
+    return n ? (double)sum_us() / (double)n : 0.0;
+}
+
+// Buckets are read without a snapshot, so under concurrent recording the
+// answer can be off by the values that landed mid-walk.
+uint64_t LatencyHistogram::percentile(double q) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+    uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(std::clamp(q, 0.0, 1.0) * (double)n));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+        seen += bucket_count(b);
+        if (seen >= target) return std::min(bucket_upper(b), max_us());
+    }
+    return max_us();
+}
+
+// -----------------------------------------------------------------------------
+// CallStats helpers
+// -----------------------------------------------------------------------------
+const char* call_phase_name(CallPhase p) {
+    switch (p) {
+    case CallPhase::Total:    return "total";
+    case CallPhase::Dns:      return "dns";
+    case CallPhase::Connect:  return "connect";
+    case CallPhase::Tls:      return "tls";
+    case CallPhase::Server:   return "server";
+    case CallPhase::Transfer: return "transfer";
+    default:                  return "?";
+    }
+}
+
+std::string_view rpc_method_of(std::string_view body) {
+    size_t i = body.find_first_not_of(" \t\r\n");
+    if (i != std::string_view::npos && body[i] == '[') return "batch";
+    std::optional<std::string_view> member = json_member(body, "method");
+    std::optional<std::string_view> method = member ? json_string(*member) : std::nullopt;
+    return method ? *method : "unknown";
+}
+
+// -----------------------------------------------------------------------------
+// RpcMetrics
+// -----------------------------------------------------------------------------
+RpcMetrics& RpcMetrics::global() {
+    static RpcMetrics metrics;
+    return metrics;
+}
+
+static std::atomic<uint64_t> g_registry_ids{1};
+
+RpcMetrics::RpcMetrics() : id_(g_registry_ids.fetch_add(1, std::memory_order_relaxed)) {}
+
+// A thread talks to a handful of endpoint/method pairs; remembering the last
+// few keeps the shared lock off the per-call path.
+CallStats& RpcMetrics::stats(std::string_view endpoint, std::string_view method) {
+    struct Cached {
+        uint64_t registry = 0;
+        CallStats* stats = nullptr;
+    };
+    thread_local std::array<Cached, 8> cache;
+    thread_local size_t victim = 0;
+    for (const Cached& c : cache) {
+        if (c.registry == id_ && c.stats->method == method && c.stats->endpoint == endpoint) return *c.stats;
+    }
+    CallStats& s = stats_locked(endpoint, method);
+    cache[victim++ % cache.size()] = Cached{id_, &s};
+    return s;
+}
+
+CallStats& RpcMetrics::stats_locked(std::string_view endpoint, std::string_view method) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mu_);
+        auto e = endpoints_.find(endpoint);
+        if (e != endpoints_.end()) {
+            auto m = e->second.methods.find(method);
+            if (m != e->second.methods.end()) return *m->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mu_);
+    auto e = endpoints_.find(endpoint);
+    if (e == endpoints_.end()) e = endpoints_.emplace(std::string(endpoint), Endpoint{}).first;
+    auto m = e->second.methods.find(method);
+    if (m == e->second.methods.end()) {
+        m = e->second.methods.emplace(std::string(method),
+                                      std::make_unique<CallStats>(std::string(endpoint), std::string(method))).first;
+    }
+    return *m->second;
+}
+
+static uint64_t elapsed(curl_off_t from, curl_off_t to) { return to > from ? (uint64_t)(to - from) : 0; }
+
+// Handshake phases are recorded only for transfers that opened a connection,
+// so their histograms describe real handshakes rather than mostly zeros.
+void RpcMetrics::record(CURL* h, CURLcode res, std::string_view endpoint, std::string_view body) {
+    CallStats& s = stats(endpoint, rpc_method_of(body));
+
+    curl_off_t dns = 0, connect = 0, tls = 0, pre = 0, start = 0, total = 0, down = 0;
+    long status = 0, connects = 0;
+    curl_easy_getinfo(h, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+    curl_easy_getinfo(h, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(h, CURLINFO_APPCONNECT_TIME_T, &tls);
+    curl_easy_getinfo(h, CURLINFO_PRETRANSFER_TIME_T, &pre);
+    curl_easy_getinfo(h, CURLINFO_STARTTRANSFER_TIME_T, &start);
+    curl_easy_getinfo(h, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(h, CURLINFO_SIZE_DOWNLOAD_T, &down);
+    curl_easy_getinfo(h, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(h, CURLINFO_NUM_CONNECTS, &connects);
+
+    s.calls.add();
+    if (res != CURLE_OK || status >= 400) s.errors.add();
+    s.bytes_sent.add(body.size());
+    s.bytes_received.add((uint64_t)std::max<curl_off_t>(0, down));
+    if (res == CURLE_OK) (connects > 0 ? counters_.connections_new : counters_.connections_reused).add();
+
+    s.phases[(size_t)CallPhase::Total].record((uint64_t)std::max<curl_off_t>(0, total));
+    if (connects > 0) {
+        s.phases[(size_t)CallPhase::Dns].record((uint64_t)std::max<curl_off_t>(0, dns));
+        s.phases[(size_t)CallPhase::Connect].record(elapsed(dns, connect));
+        if (tls > 0) s.phases[(size_t)CallPhase::Tls].record(elapsed(connect, tls));
+    }
+    if (start > 0) {
+        s.phases[(size_t)CallPhase::Server].record(elapsed(pre, start));
+        s.phases[(size_t)CallPhase::Transfer].record(elapsed(start, total));
+    }
+}
+
+void RpcMetrics::record_retry(std::string_view endpoint, std::string_view method) {
+    stats(endpoint, method).retries.add();
+}
+
+std::vector<const CallStats*> RpcMetrics::entries() const {
+    std::shared_lock<std::shared_mutex> lock(mu_);
+    std::vector<const CallStats*> out;
+    for (const auto& [url, e] : endpoints_) {
+        for (const auto& [method, s] : e.methods) out.push_back(s.get());
+    }
+    return out;
+}
+
+static std::string ms(uint64_t us) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.2f", (double)us / 1000.0);
+    return buf;
+}
+
+std::string RpcMetrics::summary() const {
+    std::string out;
+    char line[320];
+    std::snprintf(line, sizeof(line), "%-32s %-28s %7s %6s %6s %9s %9s %9s %9s %9s %9s %10s %10s\n",
+                  "endpoint", "method", "calls", "errors", "retry", "p50 ms", "p90 ms", "p99 ms", "max ms",
+                  "srv p50", "conn p50", "bytes out", "bytes in");
+    out += line;
+    for (const CallStats* s : entries()) {
+        const LatencyHistogram& t = s->phase(CallPhase::Total);
+        std::snprintf(line, sizeof(line), "%-32s %-28s %7llu %6llu %6llu %9s %9s %9s %9s %9s %9s %10llu %10llu\n",
+                      s->endpoint.c_str(), s->method.c_str(),
+                      (unsigned long long)s->calls.value(),
+                      (unsigned long long)s->errors.value(),
+                      (unsigned long long)s->retries.value(),
+                      ms(t.percentile(0.50)).c_str(), ms(t.percentile(0.90)).c_str(),
+                      ms(t.percentile(0.99)).c_str(), ms(t.max_us()).c_str(),
+                      ms(s->phase(CallPhase::Server).percentile(0.50)).c_str(),
+                      ms(s->phase(CallPhase::Connect).percentile(0.50)).c_str(),
+                      (unsigned long long)s->bytes_sent.value(),
+                      (unsigned long long)s->bytes_received.value());
+        out += line;
+    }
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// MetricsReporter
+// -----------------------------------------------------------------------------
+MetricsReporter::MetricsReporter(RpcMetrics& metrics, std::chrono::milliseconds every)
+    : metrics_(metrics), every_(every) {
+    if (every_.count() > 0) thread_ = std::thread(&MetricsReporter::run, this);
+}
+
+MetricsReporter::~MetricsReporter() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    report();
+}
+
+void MetricsReporter::run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!cv_.wait_for(lock, every_, [this] { return stop_; })) {
+        lock.unlock();
+        report();
+        lock.lock();
+    }
+}
+
+// Log keys must outlive the event, hence the literal tables.
+static constexpr const char* kP50Keys[] = {"total_p50_us", "dns_p50_us", "connect_p50_us",
+                                           "tls_p50_us", "server_p50_us", "transfer_p50_us"};
+static constexpr const char* kP99Keys[] = {"total_p99_us", "dns_p99_us", "connect_p99_us",
+                                           "tls_p99_us", "server_p99_us", "transfer_p99_us"};
+
+void MetricsReporter::report() const {
+    for (const CallStats* s : metrics_.entries()) {
+        if (!log_enabled(LogLevel::Info)) return;
+        LogEvent ev(LogLevel::Info, "rpc.stats");
+        ev.str("endpoint", s->endpoint)
+            .str("method", s->method)
+            .num("calls", s->calls.value())
+            .num("errors", s->errors.value())
+            .num("retries", s->retries.value())
+            .num("hedges", s->hedges.value())
+            .num("hedge_wins", s->hedge_wins.value())
+            .num("bytes_sent", s->bytes_sent.value())
+            .num("bytes_received", s->bytes_received.value())
+            .num("total_max_us", s->phase(CallPhase::Total).max_us());
+        for (size_t p = 0; p < (size_t)CallPhase::Count; ++p) {
+            const LatencyHistogram& h = s->phases[p];
+            if (h.count() == 0) continue;
+            ev.num(kP50Keys[p], h.percentile(0.50)).num(kP99Keys[p], h.percentile(0.99));
+        }
+    }
+}
+
+std::chrono::milliseconds metrics_interval_from_env() {
+    const char* v = std::getenv("WEB3_METRICS_INTERVAL_MS");
+    if (!v) return std::chrono::milliseconds(0);
+    char* end = nullptr;
+    long long ms = std::strtoll(v, &end, 10);
+    if (end == v || ms < 0) {
+        LOG_EVENT(LogLevel::Error, "config.invalid").str("var", "WEB3_METRICS_INTERVAL_MS").str("value", v);
+        return std::chrono::milliseconds(0);
+    }
+    return std::chrono::milliseconds(ms);
+}
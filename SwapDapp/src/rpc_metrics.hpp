@@ -0,0 +1,235 @@
+/*
+ * File:        rpc_metrics.hpp
+ * Created on:  2026-10-17
+ * Description: Per-call instrumentation for the JSON-RPC transports.
+ *
+ *              Every finished transfer (RpcClient and AsyncRpcEngine) is
+ *              recorded against its endpoint and JSON-RPC method: the curl
+ *              timing breakdown (CURLINFO_*_TIME_T) split into phases - DNS,
+ *              TCP connect, TLS, server (request sent to first byte) and
+ *              transfer - plus the total, each in its own log-linear
+ *              histogram, and counters for calls, errors, retries, hedges
+ *              and bytes.
+ *
+ *              Read it programmatically (RpcMetrics::entries(), summary()),
+ *              or let a MetricsReporter log an "rpc.stats" line per
+ *              endpoint/method every interval:
+ *
+ *                  MetricsReporter reporter(RpcMetrics::global(), metrics_interval_from_env());
+ *
+ *              Recording is lock-free once an endpoint/method pair has been
+ *              seen on the thread: a per-thread lookup cache, then relaxed
+ *              increments on per-thread counter shards (ShardedCounter).
+ *              ClientCounters holds the process-wide gauges and counters
+ *              (in flight, pending transactions, receipt polls, cache hits)
+ *              that metrics_server.hpp exports alongside.
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// ShardedCounter: per-thread cache lines, summed on read
+// -----------------------------------------------------------------------------
+// The calling thread's shard; threads are handed out round-robin.
+unsigned next_metric_shard();
+inline unsigned metric_shard() {
+    thread_local unsigned shard = next_metric_shard();
+    return shard;
+}
+
+// Up to kShards threads each bump their own cache line, so recording never
+// contends; readers add the shards up. Doubles as a gauge (add / sub): the
+// modular sum is exact even when the add and the sub run on different threads.
+class ShardedCounter {
+public:
+    static constexpr size_t kShards = 16;
+
+    void add(uint64_t n = 1) { shards_[metric_shard() % kShards].v.fetch_add(n, std::memory_order_relaxed); }
+    void sub(uint64_t n = 1) { shards_[metric_shard() % kShards].v.fetch_sub(n, std::memory_order_relaxed); }
+
+    uint64_t value() const;
+    int64_t gauge() const { return (int64_t)value(); }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> v{0};
+    };
+    std::array<Shard, kShards> shards_;
+};
+
+// Holds a gauge up for the lifetime of a scope (a call, a wait).
+class GaugeScope {
+public:
+    explicit GaugeScope(ShardedCounter& gauge) : gauge_(gauge) { gauge_.add(); }
+    ~GaugeScope() { gauge_.sub(); }
+
+    GaugeScope(const GaugeScope&) = delete;
+    GaugeScope& operator=(const GaugeScope&) = delete;
+
+private:
+    ShardedCounter& gauge_;
+};
+
+// -----------------------------------------------------------------------------
+// LatencyHistogram: HDR-style log-linear buckets over microseconds
+// -----------------------------------------------------------------------------
+// Values below 16 us get their own bucket; above that each power of two is
+// split into 16 linear sub-buckets, so a reported percentile is within ~6% of
+// the recorded value. Covers up to 2^40 us; larger values land in the top bucket.
+// Buckets are kept in kShards copies picked by metric_shard(), so threads
+// recording similar latencies do not share a line; readers merge them.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 4;
+    static constexpr unsigned kMaxBits = 40;
+    static constexpr size_t kBuckets = (kMaxBits - kSubBits + 1) << kSubBits;
+    static constexpr size_t kShards = 4;
+
+    void record(uint64_t us);
+
+    uint64_t count() const;
+    uint64_t sum_us() const { return sum_.value(); }
+    uint64_t max_us() const { return max_.load(std::memory_order_relaxed); }
+    double mean_us() const;
+
+    // Upper bound of the bucket holding the q-th value (q in [0, 1]); 0 if empty.
+    uint64_t percentile(double q) const;
+
+    static size_t bucket_of(uint64_t us);
+    static uint64_t bucket_upper(size_t bucket);
+
+private:
+    uint64_t bucket_count(size_t bucket) const;
+
+    std::array<std::array<std::atomic<uint32_t>, kBuckets>, kShards> buckets_{};
+    ShardedCounter sum_;
+    std::atomic<uint64_t> max_{0};
+};
+
+// -----------------------------------------------------------------------------
+// Per endpoint/method statistics
+// -----------------------------------------------------------------------------
+enum class CallPhase { Total, Dns, Connect, Tls, Server, Transfer, Count };
+const char* call_phase_name(CallPhase p);
+
+struct CallStats {
+    CallStats(std::string endpoint, std::string method)
+        : endpoint(std::move(endpoint)), method(std::move(method)) {}
+
+    const std::string endpoint;
+    const std::string method;   // "batch" for JSON-RPC batches
+
+    std::array<LatencyHistogram, (size_t)CallPhase::Count> phases;
+    ShardedCounter calls;
+    ShardedCounter errors;    // curl failures and HTTP status >= 400
+    ShardedCounter retries;
+    ShardedCounter hedges;        // duplicates of slow reads sent here
+    ShardedCounter hedge_wins;    // ... that answered first
+    ShardedCounter bytes_sent;
+    ShardedCounter bytes_received;
+
+    const LatencyHistogram& phase(CallPhase p) const { return phases[(size_t)p]; }
+};
+
+// Process-wide client state outside any one call.
+struct ClientCounters {
+    ShardedCounter in_flight;              // gauge: requests sent and not yet answered
+    ShardedCounter pending_txs;            // gauge: transactions waiting for a receipt
+    ShardedCounter receipt_polls_wait;     // wait_receipt polls
+    ShardedCounter receipt_polls_coro;     // CoroRpcClient::receipt polls
+    ShardedCounter receipt_polls_tracker;  // TxTracker requests (tip, block receipts, by hash)
+    ShardedCounter connections_new;        // transfers that had to connect
+    ShardedCounter connections_reused;     // transfers served from the connection cache
+    ShardedCounter nonce_hits;             // NonceManager::reserve without a fetch
+    ShardedCounter nonce_misses;           // ... that had to fetch eth_getTransactionCount
+    ShardedCounter coalesce_joins;         // reads answered by an identical request already in flight
+    ShardedCounter coalesce_leads;         // ... that had to send their own
+};
+
+// Method of a request body ("batch" for an array, "unknown" if unreadable).
+std::string_view rpc_method_of(std::string_view body);
+
+// -----------------------------------------------------------------------------
+// RpcMetrics: registry of CallStats
+// -----------------------------------------------------------------------------
+class RpcMetrics {
+public:
+    // Shared by every client in the process.
+    static RpcMetrics& global();
+
+    RpcMetrics();
+
+    // Created on first use; the reference stays valid for the registry's life.
+    // Repeat lookups are served from a small per-thread cache without locking.
+    CallStats& stats(std::string_view endpoint, std::string_view method);
+
+    ClientCounters& counters() { return counters_; }
+    const ClientCounters& counters() const { return counters_; }
+
+    // A finished transfer on `h`: timings and sizes come from curl.
+    void record(CURL* h, CURLcode res, std::string_view endpoint, std::string_view body);
+    void record_retry(std::string_view endpoint, std::string_view method);
+
+    std::vector<const CallStats*> entries() const;
+
+    // Human-readable table: one row per endpoint/method.
+    std::string summary() const;
+
+private:
+    struct Endpoint {
+        std::map<std::string, std::unique_ptr<CallStats>, std::less<>> methods;
+    };
+
+    CallStats& stats_locked(std::string_view endpoint, std::string_view method);
+
+    const uint64_t id_;   // tells the per-thread caches of different registries apart
+    mutable std::shared_mutex mu_;
+    std::map<std::string, Endpoint, std::less<>> endpoints_;
+    ClientCounters counters_;
+};
+
+// -----------------------------------------------------------------------------
+// MetricsReporter: periodic "rpc.stats" log lines
+// -----------------------------------------------------------------------------
+// Logs every entry at info level each interval and once more when destroyed.
+// A zero interval makes the reporter inert.
+class MetricsReporter {
+public:
+    MetricsReporter(RpcMetrics& metrics, std::chrono::milliseconds every);
+    ~MetricsReporter();
+
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    void report() const;
+
+private:
+    void run();
+
+    RpcMetrics& metrics_;
+    std::chrono::milliseconds every_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+// WEB3_METRICS_INTERVAL_MS, or 0 (off).
+std::chrono::milliseconds metrics_interval_from_env();
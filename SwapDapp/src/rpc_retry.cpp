@@ -0,0 +1,263 @@
+/*
+ * File:        rpc_retry.cpp
+ * Created on:  2026-10-17
+ * Description: Error-classified retries (see rpc_retry.hpp).
+ */
+
+#include "rpc_retry.hpp"
+#include "hex_codec.hpp"
+#include "keccak.hpp"
+#include "log.hpp"
+#include "nonce_manager.hpp"
+#include "rpc_hedge.hpp"
+#include "rpc_metrics.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+// -----------------------------------------------------------------------------
+// Classification
+// -----------------------------------------------------------------------------
+const char* rpc_error_kind_name(RpcErrorKind kind) {
+    switch (kind) {
+    case RpcErrorKind::None:         return "none";
+    case RpcErrorKind::NotSent:      return "not_sent";
+    case RpcErrorKind::NoAnswer:     return "no_answer";
+    case RpcErrorKind::RateLimited:  return "rate_limited";
+    case RpcErrorKind::ServerError:  return "server_error";
+    case RpcErrorKind::NodeBehind:   return "node_behind";
+    case RpcErrorKind::NonceTooLow:  return "nonce_too_low";
+    case RpcErrorKind::AlreadyKnown: return "already_known";
+    case RpcErrorKind::Underpriced:  return "underpriced";
+    case RpcErrorKind::Reverted:     return "reverted";
+    case RpcErrorKind::Invalid:      return "invalid";
+    case RpcErrorKind::Other:        return "other";
+    }
+    return "other";
+}
+
+static std::string error_message(const nlohmann::json& error) {
+    if (!error.is_object() || !error.contains("message") || !error["message"].is_string()) return {};
+    return to_lower_ascii(error["message"].get<std::string>());
+}
+
+static bool contains(const std::string& haystack, std::initializer_list<const char*> needles) {
+    for (const char* n : needles) {
+        if (haystack.find(n) != std::string::npos) return true;
+    }
+    return false;
+}
+
+// Messages differ between geth, erigon, nethermind and the hosted gateways;
+// the codes are even less consistent, so the text decides where it can.
+RpcErrorKind rpc_classify(const RpcResult& r, const RpcTransport* transport) {
+    if (r.ok()) return RpcErrorKind::None;
+    if (transport) {
+        if (transport->curl != CURLE_OK) return transport->sent ? RpcErrorKind::NoAnswer : RpcErrorKind::NotSent;
+        if (transport->http_status == 429) return RpcErrorKind::RateLimited;
+        if (transport->http_status >= 500) return RpcErrorKind::ServerError;
+    }
+    if (!r.error) return RpcErrorKind::ServerError;   // neither result nor error
+
+    const nlohmann::json& e = *r.error;
+    int code = e.is_object() && e.contains("code") && e["code"].is_number_integer() ? e["code"].get<int>() : 0;
+    std::string m = error_message(e);
+    if (code == kTransportErrorCode && m == "no response") {
+        // Synthesized by rpc_result_from: the transport said why, if anyone.
+        return transport && !transport->sent ? RpcErrorKind::NotSent : RpcErrorKind::NoAnswer;
+    }
+    if (code == -32005 || contains(m, {"rate limit", "too many requests", "request limit", "exceeded the quota"}))
+        return RpcErrorKind::RateLimited;
+    if (contains(m, {"header not found", "missing trie node", "unknown block", "block not found", "syncing"}))
+        return RpcErrorKind::NodeBehind;
+    if (is_nonce_too_low(e)) return RpcErrorKind::NonceTooLow;
+    if (contains(m, {"already known", "known transaction", "alreadyknown"})) return RpcErrorKind::AlreadyKnown;
+    if (is_replacement_underpriced(e) || contains(m, {"fee too low", "less than block base fee"}))
+        return RpcErrorKind::Underpriced;
+    if (code == 3 || contains(m, {"execution reverted"})) return RpcErrorKind::Reverted;
+    if (code == -32700 || code == -32600 || code == -32601 || code == -32602) return RpcErrorKind::Invalid;
+    if (code == kTransportErrorCode) return RpcErrorKind::ServerError;
+    return RpcErrorKind::Other;
+}
+
+bool rpc_retryable(std::string_view method, RpcErrorKind kind) {
+    switch (kind) {
+    case RpcErrorKind::NotSent:
+    case RpcErrorKind::RateLimited:
+        return true;
+    case RpcErrorKind::NoAnswer:
+    case RpcErrorKind::ServerError:
+    case RpcErrorKind::NodeBehind:
+        return rpc_method_hedgeable(method) || method == "eth_sendRawTransaction";
+    default:
+        return false;
+    }
+}
+
+std::optional<Hash32> rpc_raw_tx_hash(std::string_view raw) {
+    std::optional<Bytes> bytes = from_hex(raw);
+    if (!bytes || bytes->empty()) return std::nullopt;
+    return Hash32(keccak256(bytes->data(), bytes->size()));
+}
+
+// -----------------------------------------------------------------------------
+// Sent transactions
+// -----------------------------------------------------------------------------
+// Hashes a node accepted from this process, oldest dropped first. A caller
+// that repeats a whole step gets the hash back without a second broadcast.
+namespace {
+
+class SentTxs {
+public:
+    bool contains(const Hash32& h) {
+        std::lock_guard<std::mutex> lock(mu_);
+        return set_.count(h) != 0;
+    }
+
+    void add(const Hash32& h) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!set_.insert(h).second) return;
+        order_.push_back(h);
+        if (order_.size() > kCapacity) {
+            set_.erase(order_.front());
+            order_.pop_front();
+        }
+    }
+
+private:
+    static constexpr size_t kCapacity = 4096;
+    std::mutex mu_;
+    std::unordered_set<Hash32> set_;
+    std::deque<Hash32> order_;
+};
+
+SentTxs& sent_txs() {
+    static SentTxs txs;
+    return txs;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// RpcRetry
+// -----------------------------------------------------------------------------
+RpcRetry::RpcRetry(std::string_view method, const RetryOptions& opts, std::optional<Hash32> tx)
+    : method_(method), opts_(opts), tx_(tx), start_(std::chrono::steady_clock::now()), prev_(opts.base),
+      rng_(std::random_device{}()) {}
+
+RpcRetry::Next RpcRetry::start() {
+    if (tx_ && sent_txs().contains(*tx_)) {
+        LOG_EVENT(LogLevel::Debug, "rpc.dedupe").str("method", method_).str("tx", tx_->hex_string());
+        return accepted();
+    }
+    delay_ = std::chrono::milliseconds(0);
+    return Next::Send;
+}
+
+RpcRetry::Next RpcRetry::accepted() {
+    kind_ = RpcErrorKind::None;
+    sent_txs().add(*tx_);
+    result_ = RpcResult{nlohmann::json(tx_->hex_string()), std::nullopt};
+    return Next::Done;
+}
+
+// Decorrelated jitter: each wait is drawn from [base, 3 x the last one].
+std::optional<std::chrono::milliseconds> RpcRetry::backoff() {
+    if (attempts_ >= opts_.max_attempts) return std::nullopt;
+    int64_t lo = opts_.base.count();
+    int64_t hi = std::max(lo, std::min<int64_t>(opts_.cap.count(), prev_.count() * 3));
+    std::chrono::milliseconds d(std::uniform_int_distribution<int64_t>(lo, hi)(rng_));
+    prev_ = d;
+    if (std::chrono::steady_clock::now() + d > start_ + opts_.budget) return std::nullopt;
+    return d;
+}
+
+RpcRetry::Next RpcRetry::on_answer(RpcResult r, const RpcTransport* transport) {
+    ++attempts_;
+    kind_ = rpc_classify(r, transport);
+    result_ = std::move(r);
+    if (tx_) {
+        if (kind_ == RpcErrorKind::None) {
+            sent_txs().add(*tx_);
+            return Next::Done;
+        }
+        if (kind_ == RpcErrorKind::AlreadyKnown) return accepted();
+        // Ours, mined, or a different tx with the same nonce: the hash says.
+        if (kind_ == RpcErrorKind::NonceTooLow && maybe_sent_) return Next::Lookup;
+        if (kind_ == RpcErrorKind::NoAnswer || kind_ == RpcErrorKind::ServerError) maybe_sent_ = true;
+    }
+    if (kind_ == RpcErrorKind::None || !rpc_retryable(method_, kind_)) return Next::Done;
+    // The client already waited out Retry-After and resent; more would only
+    // multiply its budget by ours.
+    if (kind_ == RpcErrorKind::RateLimited && transport && transport->throttle_spent) return Next::Done;
+
+    std::optional<std::chrono::milliseconds> d = backoff();
+    if (!d) {
+        if (tx_ && maybe_sent_) return Next::Lookup;
+        return Next::Done;
+    }
+    delay_ = *d;
+    LOG_EVENT(LogLevel::Warn, "rpc.retry")
+        .str("method", method_)
+        .str("kind", rpc_error_kind_name(kind_))
+        .num("attempt", attempts_)
+        .num("delay_ms", (int64_t)delay_.count());
+    return Next::Send;
+}
+
+RpcRetry::Next RpcRetry::on_lookup(const RpcResult& r) {
+    if (r.ok() && !r.result->is_null()) return accepted();
+    return Next::Done;
+}
+
+// -----------------------------------------------------------------------------
+// Blocking entry points
+// -----------------------------------------------------------------------------
+nlohmann::json rpc_tx_lookup_params(const Hash32& tx) {
+    return nlohmann::json::array({tx.hex_string()});
+}
+
+void rpc_retry_wait(RpcClient& client, const RpcRetry& retry, const RpcTransport& failed) {
+    if (client.options().metrics && failed.endpoint) {
+        RpcMetrics::global().record_retry(client.router().url(*failed.endpoint), retry.method());
+    }
+    std::this_thread::sleep_for(retry.delay());
+}
+
+// eth_sendRawTransaction: the hash of params[0]; nullopt for anything else.
+static std::optional<Hash32> sent_tx(std::string_view method, const std::string& body) {
+    if (method != "eth_sendRawTransaction") return std::nullopt;
+    nlohmann::json j = nlohmann::json::parse(body, nullptr, false);
+    if (j.is_discarded() || !j.contains("params") || !j["params"].is_array() || j["params"].empty() ||
+        !j["params"][0].is_string()) {
+        return std::nullopt;
+    }
+    return rpc_raw_tx_hash(j["params"][0].get<std::string>());
+}
+
+RpcResult rpc_call_retry(RpcClient& client, const std::string& body, const RetryOptions& opts, RpcErrorKind* kind) {
+    std::string_view method = rpc_method_of(body);
+    RpcRetry retry(method, opts, sent_tx(method, body));
+    RpcTransport transport;
+    for (RpcRetry::Next next = retry.start(); next != RpcRetry::Next::Done;) {
+        if (next == RpcRetry::Next::Lookup) {
+            nlohmann::json lookup = {
+                {"jsonrpc", "2.0"}, {"id", 1}, {"method", "eth_getTransactionByHash"},
+                {"params", rpc_tx_lookup_params(*retry.tx())}};
+            next = retry.on_lookup(rpc_call_retry(client, lookup.dump(), opts));
+            continue;
+        }
+        if (retry.attempts() > 0) rpc_retry_wait(client, retry, transport);
+        std::optional<std::string> raw = client.post(body, &transport);
+        next = retry.on_answer(rpc_result_from(raw), &transport);
+    }
+    if (kind) *kind = retry.kind();
+    return retry.take_result();
+}
+
+RpcResult rpc_call_retry(RpcClient& client, const nlohmann::json& j, const RetryOptions& opts, RpcErrorKind* kind) {
+    return rpc_call_retry(client, j.dump(), opts, kind);
+}
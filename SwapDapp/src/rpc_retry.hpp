@@ -0,0 +1,138 @@
+/*
+ * File:        rpc_retry.hpp
+ * Created on:  2026-10-17
+ * Description: Error-classified retries. A failed call is sorted into an
+ *              RpcErrorKind from what the transport saw (never sent, sent
+ *              but unanswered, HTTP 429 / 5xx) and from the JSON-RPC error
+ *              (rate limited, header not found, nonce too low, already
+ *              known, underpriced, reverted, ...). Only kinds a later attempt
+ *              can fix are retried, and only where a second copy is harmless:
+ *
+ *              - reads (rpc_method_hedgeable) on any transient kind;
+ *              - eth_sendRawTransaction on any transient kind as well: the
+ *                same signed bytes are the same transaction, so a resend is
+ *                at worst answered "already known" or "nonce too low", and
+ *                both are settled by the tx hash. Hashes accepted in this
+ *                process are remembered and not sent again;
+ *              - anything else (eth_sendTransaction signs a new tx per
+ *                request) only if it never left or was refused as rate
+ *                limited.
+ *
+ *              An HTTP 429 that RpcClient has already resent its own
+ *              max_throttled_resends times is final here: the two budgets
+ *              do not multiply.
+ *
+ *              Waits use decorrelated jitter, min(cap, uniform(base, 3 x
+ *              previous wait)), so callers that failed together do not come
+ *              back together. Every request has its own budget of attempts
+ *              and wall time, so a dead node costs a bounded delay, not a
+ *              failed run.
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "rpc_client.hpp"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+struct RetryOptions {
+    int max_attempts = 4;                       // first attempt included
+    std::chrono::milliseconds base{50};         // shortest wait
+    std::chrono::milliseconds cap{2000};        // longest wait
+    std::chrono::milliseconds budget{10000};    // all attempts and waits of one request
+};
+
+enum class RpcErrorKind {
+    None,           // answered with a result
+    NotSent,        // failed before the request was written
+    NoAnswer,       // sent (or maybe sent), no response: timeout, reset
+    RateLimited,    // HTTP 429, -32005 / "rate limit"
+    ServerError,    // HTTP 5xx, unparsable body, -32603
+    NodeBehind,     // "header not found", "missing trie node", unknown block
+    NonceTooLow,
+    AlreadyKnown,   // the node has this tx already
+    Underpriced,    // fee below the replacement / base fee floor
+    Reverted,       // execution reverted
+    Invalid,        // malformed request, unknown method, bad params
+    Other,
+};
+
+const char* rpc_error_kind_name(RpcErrorKind kind);
+
+// transport: as filled in by RpcClient::post; nullptr when the caller does
+// not know (async engine), in which case a missing response is NoAnswer.
+RpcErrorKind rpc_classify(const RpcResult& r, const RpcTransport* transport = nullptr);
+
+// Whether `method` may be sent again after a failure of `kind`.
+bool rpc_retryable(std::string_view method, RpcErrorKind kind);
+
+// Hash of a signed raw transaction ("0x..." hex); nullopt if not hex.
+std::optional<Hash32> rpc_raw_tx_hash(std::string_view raw);
+
+// -----------------------------------------------------------------------------
+// RpcRetry: one request across its attempts
+// -----------------------------------------------------------------------------
+// Transport-agnostic: the caller sends, reports, and waits. Blocking code
+// uses rpc_call_retry below; CoroRpcClient::call_retry drives the same
+// state with co_await.
+class RpcRetry {
+public:
+    // tx: hash of the signed transaction for eth_sendRawTransaction, which
+    // turns on deduplication.
+    RpcRetry(std::string_view method, const RetryOptions& opts = {}, std::optional<Hash32> tx = std::nullopt);
+
+    enum class Next {
+        Done,       // result() is final
+        Send,       // wait delay(), then send the request (again)
+        Lookup,     // ask eth_getTransactionByHash(tx()) and pass it to on_lookup()
+    };
+
+    Next start();
+    Next on_answer(RpcResult r, const RpcTransport* transport = nullptr);
+    Next on_lookup(const RpcResult& r);
+
+    std::chrono::milliseconds delay() const { return delay_; }
+    RpcErrorKind kind() const { return kind_; }
+    int attempts() const { return attempts_; }
+    const std::string& method() const { return method_; }
+    const std::optional<Hash32>& tx() const { return tx_; }
+    RpcResult take_result() { return std::move(result_); }
+
+private:
+    Next accepted();
+    std::optional<std::chrono::milliseconds> backoff();
+
+    std::string method_;
+    RetryOptions opts_;
+    std::optional<Hash32> tx_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::milliseconds delay_{0};
+    std::chrono::milliseconds prev_;
+    int attempts_ = 0;
+    bool maybe_sent_ = false;       // an earlier attempt may have reached a node
+    RpcErrorKind kind_ = RpcErrorKind::None;
+    RpcResult result_;
+    std::minstd_rand rng_;
+};
+
+// -----------------------------------------------------------------------------
+// Blocking entry points
+// -----------------------------------------------------------------------------
+// rpc_call with classified retries; the same body (and id) is resent. kind,
+// when given, receives the last attempt's classification.
+RpcResult rpc_call_retry(RpcClient& client, const std::string& body, const RetryOptions& opts = {},
+                         RpcErrorKind* kind = nullptr);
+RpcResult rpc_call_retry(RpcClient& client, const nlohmann::json& j, const RetryOptions& opts = {},
+                         RpcErrorKind* kind = nullptr);
+
+// Counts the retry against the endpoint that failed and sleeps retry.delay().
+void rpc_retry_wait(RpcClient& client, const RpcRetry& retry, const RpcTransport& failed);
+
+// eth_getTransactionByHash params for RpcRetry::Next::Lookup.
+nlohmann::json rpc_tx_lookup_params(const Hash32& tx);
@@ -0,0 +1,226 @@
+/*
+ * File:        rpc_router.cpp
+ * Created on:  2026-10-17
+ * Description: Endpoint selection (see rpc_router.hpp).
+ */
+
+#include "rpc_router.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+const char* breaker_state_name(BreakerState s) {
+    switch (s) {
+    case BreakerState::Closed:   return "closed";
+    case BreakerState::Open:     return "open";
+    case BreakerState::HalfOpen: return "half_open";
+    }
+    return "?";
+}
+
+RpcRouter::RpcRouter(std::vector<std::string> urls, RouterOptions opts) : opts_(opts) {
+    if (urls.size() > kMaxEndpoints) {
+        LOG_EVENT(LogLevel::Warn, "rpc.endpoints").num("configured", (uint64_t)urls.size()).num("used", (uint64_t)kMaxEndpoints);
+        urls.resize(kMaxEndpoints);
+    }
+    for (std::string& url : urls) endpoints_.emplace_back(std::move(url), opts_);
+    sticky_.fill(kNoEndpoint);
+}
+
+// -----------------------------------------------------------------------------
+// Selection
+// -----------------------------------------------------------------------------
+bool RpcRouter::available(const Endpoint& e, std::chrono::steady_clock::time_point now) const {
+    if (!e.enabled) return false;
+    switch (e.state) {
+    case BreakerState::Closed:   return true;
+    case BreakerState::Open:     return now >= e.open_until;
+    case BreakerState::HalfOpen: return !e.probing;
+    }
+    return false;
+}
+
+// Unsampled endpoints score near zero, so each gets tried early on.
+double RpcRouter::score(const Endpoint& e) const {
+    double health = std::max(0.05, 1.0 - e.ewma_failure);
+    return (e.ewma_latency_us + 1.0) * (double)(e.outstanding + 1) / health;
+}
+
+std::chrono::microseconds RpcRouter::admission_wait(const Endpoint& e, std::chrono::steady_clock::time_point now) const {
+    using std::chrono::microseconds;
+    if (now < e.blocked_until) return std::chrono::ceil<microseconds>(e.blocked_until - now);
+    if (!e.aimd.admits(e.outstanding)) return kBusyWait;
+    return e.bucket.wait(now);
+}
+
+std::optional<size_t> RpcRouter::pick(uint64_t exclude, std::chrono::microseconds* wait) {
+    size_t slot = std::hash<std::thread::id>{}(std::this_thread::get_id()) % kAffinitySlots;
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mu_);
+    size_t best = kMaxEndpoints;
+    double bestScore = 0;
+    size_t fallback = kMaxEndpoints;   // all open: the one due back first
+    std::chrono::microseconds soonest = std::chrono::microseconds::max();   // all at their limits
+    for (size_t i = 0; i < endpoints_.size(); ++i) {
+        const Endpoint& e = endpoints_[i];
+        if (!e.enabled || (exclude >> i & 1)) continue;
+        if (!available(e, now)) {
+            if (fallback == kMaxEndpoints || e.open_until < endpoints_[fallback].open_until) fallback = i;
+            continue;
+        }
+        std::chrono::microseconds w = admission_wait(e, now);
+        if (w.count() > 0) {
+            soonest = std::min(soonest, w);
+            continue;
+        }
+        double s = score(e);
+        if (best == kMaxEndpoints || s < bestScore) {
+            best = i;
+            bestScore = s;
+        }
+    }
+    if (best == kMaxEndpoints && soonest == std::chrono::microseconds::max() && fallback != kMaxEndpoints) {
+        std::chrono::microseconds w = admission_wait(endpoints_[fallback], now);
+        if (w.count() > 0) soonest = w;
+        else best = fallback;
+    }
+    if (best == kMaxEndpoints) {
+        if (wait) *wait = soonest == std::chrono::microseconds::max() ? std::chrono::microseconds(0) : soonest;
+        return std::nullopt;
+    }
+
+    uint8_t stuck = sticky_[slot];
+    if (stuck != kNoEndpoint && stuck != best && stuck < endpoints_.size() && !(exclude >> stuck & 1) &&
+        available(endpoints_[stuck], now) && admission_wait(endpoints_[stuck], now).count() == 0 &&
+        score(endpoints_[stuck]) <= opts_.sticky_slack * bestScore) {
+        best = stuck;
+    }
+    sticky_[slot] = (uint8_t)best;
+
+    Endpoint& e = endpoints_[best];
+    if (e.state == BreakerState::Open && now >= e.open_until) set_state(e, BreakerState::HalfOpen);
+    if (e.state == BreakerState::HalfOpen) e.probing = true;
+    e.bucket.take(now);
+    ++e.outstanding;
+    ++e.requests;
+    return best;
+}
+
+void RpcRouter::claim(size_t i) {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++endpoints_[i].outstanding;
+    ++endpoints_[i].requests;
+}
+
+void RpcRouter::wait_for_capacity(std::chrono::microseconds wait) {
+    std::unique_lock<std::mutex> lock(mu_);
+    freed_.wait_for(lock, wait);
+}
+
+// -----------------------------------------------------------------------------
+// Feedback
+// -----------------------------------------------------------------------------
+void RpcRouter::finish(size_t i, RouteOutcome outcome, std::chrono::microseconds latency,
+                       std::chrono::seconds retry_after) {
+    std::lock_guard<std::mutex> lock(mu_);
+    Endpoint& e = endpoints_[i];
+    if (e.outstanding) --e.outstanding;
+    freed_.notify_all();
+    if (outcome == RouteOutcome::Cancelled) {
+        if (e.state == BreakerState::HalfOpen) e.probing = false;
+        return;
+    }
+
+    double a = opts_.ewma_alpha;
+    auto now = std::chrono::steady_clock::now();
+    if (outcome == RouteOutcome::Throttled) {
+        // Up, but over its limit: slow down and rank it lower, without
+        // counting towards the breaker.
+        ++e.throttled;
+        e.ewma_failure = a + (1 - a) * e.ewma_failure;
+        e.aimd.on_throttled(now);
+        std::chrono::milliseconds pause = retry_after.count() > 0 ? retry_after : opts_.limits.default_retry_after;
+        pause = std::min(pause, opts_.limits.max_retry_after);
+        e.blocked_until = std::max(e.blocked_until, now + pause);
+        if (e.state == BreakerState::HalfOpen) set_state(e, BreakerState::Closed);
+        e.probing = false;
+        LOG_EVENT(LogLevel::Warn, "rpc.throttled")
+            .str("url", e.url)
+            .num("retry_after_ms", (int64_t)pause.count())
+            .num("concurrency_limit", e.aimd.limit());
+        return;
+    }
+
+    double us = (double)latency.count();
+    if (outcome == RouteOutcome::Failure) {
+        // Failed requests are often fast (connection refused): count them as
+        // slow so a dead endpoint drops out of the ranking before its breaker
+        // trips.
+        us = std::max({us, 2 * e.ewma_latency_us, kFailurePenaltyUs});
+    }
+    e.ewma_latency_us = e.sampled ? a * us + (1 - a) * e.ewma_latency_us : us;
+    e.sampled = true;
+
+    if (outcome == RouteOutcome::Success) {
+        e.ewma_failure *= 1 - a;
+        e.aimd.on_answer((double)latency.count(), e.outstanding, now);
+        e.consecutive_failures = 0;
+        e.cooldown = opts_.breaker_cooldown;
+        if (e.state != BreakerState::Closed) set_state(e, BreakerState::Closed);
+        e.probing = false;
+        return;
+    }
+
+    ++e.failures;
+    e.ewma_failure = a + (1 - a) * e.ewma_failure;
+    ++e.consecutive_failures;
+    if (e.state == BreakerState::HalfOpen) {
+        e.cooldown = std::min(e.cooldown * 2, opts_.breaker_max_cooldown);
+        e.open_until = now + e.cooldown;
+        e.probing = false;
+        set_state(e, BreakerState::Open);
+    } else if (e.state == BreakerState::Closed && e.consecutive_failures >= opts_.breaker_failures) {
+        e.open_until = now + e.cooldown;
+        set_state(e, BreakerState::Open);
+    }
+}
+
+void RpcRouter::set_state(Endpoint& e, BreakerState s) {
+    e.state = s;
+    LOG_EVENT(s == BreakerState::Open ? LogLevel::Warn : LogLevel::Info, "rpc.breaker")
+        .str("url", e.url)
+        .str("state", breaker_state_name(s))
+        .num("cooldown_ms", (int64_t)e.cooldown.count())
+        .num("failures", e.consecutive_failures);
+}
+
+void RpcRouter::disable(size_t i) {
+    std::lock_guard<std::mutex> lock(mu_);
+    endpoints_[i].enabled = false;
+}
+
+std::vector<EndpointHealth> RpcRouter::health() const {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mu_);
+    std::vector<EndpointHealth> out;
+    for (const Endpoint& e : endpoints_) {
+        EndpointHealth h;
+        h.url = e.url;
+        h.enabled = e.enabled;
+        h.state = e.state;
+        h.ewma_latency_us = e.ewma_latency_us;
+        h.ewma_failure = e.ewma_failure;
+        h.outstanding = e.outstanding;
+        h.requests = e.requests;
+        h.failures = e.failures;
+        h.throttled = e.throttled;
+        h.concurrency_limit = e.aimd.limit();
+        h.rate_limit = e.bucket.rate();
+        if (now < e.blocked_until) h.retry_after = std::chrono::ceil<std::chrono::milliseconds>(e.blocked_until - now);
+        out.push_back(std::move(h));
+    }
+    return out;
+}
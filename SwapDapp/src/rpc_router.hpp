@@ -0,0 +1,155 @@
+/*
+ * File:        rpc_router.hpp
+ * Created on:  2026-10-17
+ * Description: Endpoint selection for a client with several RPC URLs for the
+ *              same chain (ETH_RPC_URL="https://a,https://b,...").
+ *
+ *              Each endpoint keeps an EWMA of its latency and of its failure
+ *              rate, a count of outstanding requests and a circuit breaker.
+ *              pick() scores every endpoint the breaker admits as
+ *
+ *                  (ewma latency) x (outstanding + 1) / (1 - ewma failure rate)
+ *
+ *              and takes the lowest, i.e. least-outstanding weighted by speed.
+ *              Routing is sticky per thread: a thread keeps the endpoint it
+ *              used last until that one scores sticky_slack times worse than
+ *              the best, or its breaker opens. Consecutive reads from one flow
+ *              therefore see one node's view of the chain instead of hopping
+ *              between nodes a block apart.
+ *
+ *              Breaker: breaker_failures consecutive transport failures open
+ *              it for a cooldown; then a single probe request is let through
+ *              (half-open). Success closes it, failure reopens it with twice
+ *              the cooldown (up to breaker_max_cooldown). If every endpoint is
+ *              open, the one due back soonest is used anyway.
+ *
+ *              Admission: each endpoint also has a token bucket and an AIMD
+ *              concurrency limit (rpc_limiter.hpp); an endpoint over either,
+ *              or inside a 429's Retry-After, is skipped, and when all are,
+ *              pick() says how long to wait. A 429 is not a breaker failure:
+ *              the node is up and asking for less.
+ *
+ *              State is behind one mutex held for a few hundred nanoseconds
+ *              per request, small next to a network round trip.
+ */
+
+#pragma once
+
+#include "rpc_limiter.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct RouterOptions {
+    double ewma_alpha = 0.2;                                // weight of the newest sample
+    double sticky_slack = 2.0;                              // see above; 1.0 disables stickiness
+    int breaker_failures = 5;
+    std::chrono::milliseconds breaker_cooldown{1000};
+    std::chrono::milliseconds breaker_max_cooldown{30000};
+    LimiterOptions limits;                                  // per endpoint
+};
+
+enum class BreakerState { Closed, Open, HalfOpen };
+const char* breaker_state_name(BreakerState s);
+
+enum class RouteOutcome {
+    Success,     // the endpoint answered (any JSON-RPC result or error)
+    Failure,     // transport failure or HTTP 5xx
+    Throttled,   // HTTP 429
+    Cancelled,   // never completed; says nothing about the endpoint
+};
+
+// Point-in-time view of one endpoint.
+struct EndpointHealth {
+    std::string url;
+    bool enabled = true;
+    BreakerState state = BreakerState::Closed;
+    double ewma_latency_us = 0;
+    double ewma_failure = 0;
+    uint32_t outstanding = 0;
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    uint64_t throttled = 0;
+    double concurrency_limit = 0;
+    double rate_limit = 0;                        // requests/s, 0 = none
+    std::chrono::milliseconds retry_after{0};     // left of the last 429's Retry-After
+};
+
+class RpcRouter {
+public:
+    static constexpr size_t kMaxEndpoints = 64;   // `exclude` is a bitmask
+
+    explicit RpcRouter(std::vector<std::string> urls, RouterOptions opts = {});
+
+    size_t size() const { return endpoints_.size(); }
+    const std::string& url(size_t i) const { return endpoints_[i].url; }
+
+    // Endpoint for the calling thread's next request, skipping those whose bit
+    // is set in `exclude`, and counts it outstanding until finish(). nullopt
+    // when every enabled endpoint is excluded, or when the rest are at their
+    // limits; then *wait (if given) is set to when one frees up.
+    std::optional<size_t> pick(uint64_t exclude = 0, std::chrono::microseconds* wait = nullptr);
+    // Counts a request to an endpoint chosen by the caller, bypassing the
+    // breaker (per-endpoint checks). Paired with finish() like pick().
+    void claim(size_t i);
+    // Blocks up to `wait` (as set by pick()), returning early when a request
+    // finishes and may have freed a slot.
+    void wait_for_capacity(std::chrono::microseconds wait);
+
+    // retry_after: the 429's Retry-After, 0 if absent.
+    void finish(size_t i, RouteOutcome outcome, std::chrono::microseconds latency,
+                std::chrono::seconds retry_after = std::chrono::seconds(0));
+
+    // Takes an endpoint out of rotation for good (e.g. it serves another chain).
+    void disable(size_t i);
+
+    std::vector<EndpointHealth> health() const;
+
+private:
+    struct Endpoint {
+        Endpoint(std::string url, const RouterOptions& opts)
+            : url(std::move(url)), cooldown(opts.breaker_cooldown), bucket(opts.limits.rate, opts.limits.burst),
+              aimd(opts.limits) {}
+
+        std::string url;
+        bool enabled = true;
+        BreakerState state = BreakerState::Closed;
+        bool probing = false;                                // half-open probe in flight
+        int consecutive_failures = 0;
+        std::chrono::milliseconds cooldown{0};
+        std::chrono::steady_clock::time_point open_until{};
+        double ewma_latency_us = 0;
+        double ewma_failure = 0;
+        bool sampled = false;
+        uint32_t outstanding = 0;
+        uint64_t requests = 0;
+        uint64_t failures = 0;
+        TokenBucket bucket;
+        AimdLimiter aimd;
+        std::chrono::steady_clock::time_point blocked_until{};   // Retry-After
+        uint64_t throttled = 0;
+    };
+
+    static constexpr size_t kAffinitySlots = 64;
+    static constexpr uint8_t kNoEndpoint = 0xff;
+    static constexpr double kFailurePenaltyUs = 100000;   // latency sample a failure counts as, at least
+    static constexpr std::chrono::microseconds kBusyWait{1000};   // recheck when at the concurrency limit
+
+    bool available(const Endpoint& e, std::chrono::steady_clock::time_point now) const;
+    double score(const Endpoint& e) const;
+    std::chrono::microseconds admission_wait(const Endpoint& e, std::chrono::steady_clock::time_point now) const;
+    void set_state(Endpoint& e, BreakerState s);
+
+    RouterOptions opts_;
+    mutable std::mutex mu_;
+    std::condition_variable freed_;
+    std::vector<Endpoint> endpoints_;
+    std::array<uint8_t, kAffinitySlots> sticky_;   // thread affinity slot -> endpoint
+};
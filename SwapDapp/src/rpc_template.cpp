@@ -0,0 +1,78 @@
+/*
+ * File:        rpc_template.cpp
+ * Created on:  2026-10-17
+ * Description: Pre-rendered JSON-RPC request bodies (see rpc_template.hpp).
+ */
+
+#include "rpc_template.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+// -----------------------------------------------------------------------------
+// RpcArg
+// -----------------------------------------------------------------------------
+void RpcArg::write(std::string& out) const {
+    switch (kind_) {
+    case Kind::Text:
+        out.append(text_);
+        break;
+    case Kind::Bytes: {
+        size_t at = out.size();
+        out.resize(at + 2 + 2 * len_);
+        out[at] = '0';
+        out[at + 1] = 'x';
+        hex_encode(out.data() + at + 2, data_, len_);
+        break;
+    }
+    case Kind::Quantity: {
+        char buf[18] = {'0', 'x'};
+        out.append(buf, std::to_chars(buf + 2, buf + sizeof(buf), quantity_, 16).ptr);
+        break;
+    }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// RpcTemplate
+// -----------------------------------------------------------------------------
+// The id goes last so the invariant text is one prefix plus the holes.
+RpcTemplate::RpcTemplate(std::string_view method, std::string_view params) {
+    text_ = R"({"jsonrpc":"2.0","method":")";
+    text_.append(method);
+    text_ += R"(","params":)";
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (params[i] == '$' && i + 1 < params.size() && params[i + 1] >= '0' && params[i + 1] <= '9') {
+            unsigned arg = (unsigned)(params[i + 1] - '0');
+            holes_.push_back({text_.size(), arg});
+            arity_ = std::max<size_t>(arity_, arg + 1);
+            ++i;
+        } else {
+            text_ += params[i];
+        }
+    }
+    text_ += R"(,"id":)";
+}
+
+const std::string& RpcTemplate::render(std::string& buf, uint64_t id, std::initializer_list<RpcArg> args) const {
+    buf.clear();
+    size_t at = 0;
+    for (const Hole& h : holes_) {
+        buf.append(text_, at, h.offset - at);
+        if (h.arg < args.size()) args.begin()[h.arg].write(buf);
+        at = h.offset;
+    }
+    buf.append(text_, at, std::string::npos);
+
+    char digits[20];
+    buf.append(digits, std::to_chars(digits, digits + sizeof(digits), id).ptr);
+    buf += '}';
+    return buf;
+}
+
+std::string RpcTemplate::render(uint64_t id, std::initializer_list<RpcArg> args) const {
+    std::string buf;
+    buf.reserve(text_.size() + 24 + 70 * args.size());
+    render(buf, id, args);
+    return buf;
+}
@@ -0,0 +1,91 @@
+/*
+ * File:        rpc_template.hpp
+ * Created on:  2026-10-17
+ * Description: Pre-rendered JSON-RPC request bodies. Hot requests (receipt
+ *              polls, block-number and nonce reads, eth_call) have a fixed
+ *              shape: the envelope and method are rendered once, and each
+ *              call writes only the id and the hex arguments into a buffer
+ *              the caller keeps. Once the buffer has grown to fit, a request
+ *              costs no allocation and no nlohmann tree.
+ *
+ *              static const RpcTemplate kReceipt("eth_getTransactionReceipt", R"(["$0"])");
+ *              thread_local std::string body;
+ *              client.post(kReceipt.render(body, id, {txhash}));
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "hex_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Arguments
+// -----------------------------------------------------------------------------
+// One placeholder value. Text is written verbatim (it lands inside the
+// template's quotes); bytes as "0x" + hex; quantities as minimal "0x" hex.
+// Views only: arguments must outlive the render() call.
+class RpcArg {
+public:
+    RpcArg(std::string_view text) : kind_(Kind::Text), text_(text) {}
+    RpcArg(const char* text) : RpcArg(std::string_view(text)) {}
+    RpcArg(const std::string& text) : RpcArg(std::string_view(text)) {}
+    template <size_t N>
+    RpcArg(const FixedBytes<N>& v) : kind_(Kind::Bytes), data_(v.data()), len_(N) {}
+    template <size_t N>
+    RpcArg(const std::array<uint8_t, N>& v) : kind_(Kind::Bytes), data_(v.data()), len_(N) {}
+    RpcArg(const Bytes& v) : kind_(Kind::Bytes), data_(v.data()), len_(v.size()) {}
+
+    static RpcArg quantity(uint64_t v) {
+        RpcArg a{std::string_view()};
+        a.kind_ = Kind::Quantity;
+        a.quantity_ = v;
+        return a;
+    }
+
+    void write(std::string& out) const;
+
+private:
+    enum class Kind { Text, Bytes, Quantity };
+
+    Kind kind_;
+    std::string_view text_;
+    const uint8_t* data_ = nullptr;
+    size_t len_ = 0;
+    uint64_t quantity_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// RpcTemplate
+// -----------------------------------------------------------------------------
+class RpcTemplate {
+public:
+    // params is the params array as JSON text; $0..$9 mark the arguments.
+    //   RpcTemplate("eth_call", R"([{"to":"$0","data":"$1"},"$2"])")
+    explicit RpcTemplate(std::string_view method, std::string_view params = "[]");
+
+    // Clears buf (keeping its capacity), renders the request into it and
+    // returns it. Missing arguments render empty.
+    const std::string& render(std::string& buf, uint64_t id, std::initializer_list<RpcArg> args = {}) const;
+
+    // Same, into a fresh string: for transports that take ownership of the body.
+    std::string render(uint64_t id, std::initializer_list<RpcArg> args = {}) const;
+
+    size_t arity() const { return arity_; }
+
+private:
+    struct Hole {
+        size_t offset;   // into text_
+        unsigned arg;
+    };
+
+    std::string text_;          // envelope and params with the placeholders cut out, up to "id":
+    std::vector<Hole> holes_;
+    size_t arity_ = 0;
+};
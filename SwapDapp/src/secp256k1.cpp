@@ -0,0 +1,243 @@
+/*
+ * File:        secp256k1.cpp
+ * Created on:  2026-10-17
+ * Description: secp256k1 keys and recoverable signatures (see secp256k1.hpp).
+ */
+
+#include "secp256k1.hpp"
+#include "hex_codec.hpp"
+#include "keccak.hpp"
+
+#include <openssl/bn.h>
+#include <openssl/crypto.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/obj_mac.h>
+
+#include <cstring>
+#include <memory>
+
+// -----------------------------------------------------------------------------
+// OpenSSL handles
+// -----------------------------------------------------------------------------
+namespace {
+
+struct BnCtxFree { void operator()(BN_CTX* p) const { BN_CTX_free(p); } };
+struct BnFree { void operator()(BIGNUM* p) const { BN_clear_free(p); } };
+struct PointFree { void operator()(EC_POINT* p) const { EC_POINT_clear_free(p); } };
+struct MontFree { void operator()(BN_MONT_CTX* p) const { BN_MONT_CTX_free(p); } };
+using CtxPtr = std::unique_ptr<BN_CTX, BnCtxFree>;
+using BnPtr = std::unique_ptr<BIGNUM, BnFree>;
+using PointPtr = std::unique_ptr<EC_POINT, PointFree>;
+using MontPtr = std::unique_ptr<BN_MONT_CTX, MontFree>;
+
+// The curve is immutable once built; one instance serves every thread.
+const EC_GROUP* curve() {
+    static EC_GROUP* group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+    return group;
+}
+
+const BIGNUM* order() { return EC_GROUP_get0_order(curve()); }
+
+BnPtr bn_from(const uint8_t* be, size_t len) { return BnPtr(BN_bin2bn(be, (int)len, nullptr)); }
+BnPtr bn_new() { return BnPtr(BN_new()); }
+
+bool bn_to32(const BIGNUM* v, std::array<uint8_t, 32>& out) {
+    return BN_bn2binpad(v, out.data(), (int)out.size()) == (int)out.size();
+}
+
+// Keccak of the uncompressed public key (without the 0x04 tag), last 20 bytes.
+bool address_of(const EC_POINT* pub, BN_CTX* ctx, AddressBytes& out) {
+    uint8_t buf[65];
+    if (EC_POINT_point2oct(curve(), pub, POINT_CONVERSION_UNCOMPRESSED, buf, sizeof(buf), ctx) != sizeof(buf)) {
+        return false;
+    }
+    Keccak256::Digest d = keccak256(buf + 1, 64);
+    std::memcpy(out.data(), d.data() + 12, out.size());
+    return true;
+}
+
+// RFC 6979 section 3.2 nonce generator (HMAC-SHA256, qlen = hlen = 256).
+class Rfc6979 {
+public:
+    Rfc6979(const std::array<uint8_t, 32>& secret, const Bytes32& h1) {
+        std::memset(v_, 0x01, sizeof(v_));
+        std::memset(k_, 0x00, sizeof(k_));
+        for (uint8_t tag = 0; tag < 2; ++tag) {
+            uint8_t msg[32 + 1 + 32 + 32];
+            std::memcpy(msg, v_, 32);
+            msg[32] = tag;
+            std::memcpy(msg + 33, secret.data(), 32);
+            std::memcpy(msg + 65, h1.data(), 32);
+            mac(msg, sizeof(msg), k_);
+            mac(v_, 32, v_);
+            OPENSSL_cleanse(msg, sizeof(msg));
+        }
+    }
+    ~Rfc6979() {
+        OPENSSL_cleanse(k_, sizeof(k_));
+        OPENSSL_cleanse(v_, sizeof(v_));
+    }
+
+    // Next candidate k (the caller rejects k outside [1, n-1] or r/s == 0).
+    void next(uint8_t out[32]) {
+        if (started_) {
+            uint8_t msg[33];
+            std::memcpy(msg, v_, 32);
+            msg[32] = 0x00;
+            mac(msg, sizeof(msg), k_);
+            mac(v_, 32, v_);
+        }
+        started_ = true;
+        mac(v_, 32, v_);
+        std::memcpy(out, v_, 32);
+    }
+
+private:
+    void mac(const uint8_t* data, size_t len, uint8_t out[32]) {
+        unsigned int n = 32;
+        uint8_t tmp[32];
+        HMAC(EVP_sha256(), k_, 32, data, len, tmp, &n);
+        std::memcpy(out, tmp, 32);
+    }
+
+    uint8_t k_[32];
+    uint8_t v_[32];
+    bool started_ = false;
+};
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Secp256k1Key
+// -----------------------------------------------------------------------------
+std::optional<Secp256k1Key> Secp256k1Key::from_secret(const std::array<uint8_t, 32>& secret) {
+    CtxPtr ctx(BN_CTX_new());
+    BnPtr d = bn_from(secret.data(), secret.size());
+    PointPtr pub(EC_POINT_new(curve()));
+    if (!ctx || !d || !pub || BN_is_zero(d.get()) || BN_cmp(d.get(), order()) >= 0) return std::nullopt;
+    if (!EC_POINT_mul(curve(), pub.get(), d.get(), nullptr, nullptr, ctx.get())) return std::nullopt;
+
+    Secp256k1Key key;
+    key.secret_ = secret;
+    if (!address_of(pub.get(), ctx.get(), key.address_)) return std::nullopt;
+    return key;
+}
+
+Secp256k1Key::~Secp256k1Key() {
+    OPENSSL_cleanse(secret_.data(), secret_.size());
+}
+
+std::string Secp256k1Key::address_hex() const {
+    return to_hex(address_.data(), address_.size());
+}
+
+std::optional<Signature> Secp256k1Key::sign(const Bytes32& hash) const {
+    CtxPtr ctx(BN_CTX_new());
+    BnPtr d = bn_from(secret_.data(), secret_.size());
+    BnPtr z = bn_from(hash.data(), hash.size());
+    BnPtr k = bn_new(), r = bn_new(), s = bn_new(), x = bn_new(), y = bn_new(), kinv = bn_new();
+    BnPtr nMinus2 = bn_new(), tmp = bn_new();
+    PointPtr R(EC_POINT_new(curve()));
+    MontPtr mont(BN_MONT_CTX_new());
+    if (!ctx || !d || !z || !k || !r || !s || !x || !y || !kinv || !nMinus2 || !tmp || !R || !mont) return std::nullopt;
+    const BIGNUM* n = order();
+    // The key and the nonce only ever meet constant-time code: Montgomery
+    // products and a Fermat inverse (k^(n-2)), never BN_mod_inverse.
+    BN_set_flags(d.get(), BN_FLG_CONSTTIME);
+    BN_set_flags(k.get(), BN_FLG_CONSTTIME);
+    BN_set_flags(kinv.get(), BN_FLG_CONSTTIME);
+    BN_set_flags(s.get(), BN_FLG_CONSTTIME);
+    BN_set_flags(tmp.get(), BN_FLG_CONSTTIME);
+    if (!BN_MONT_CTX_set(mont.get(), n, ctx.get()) || !BN_copy(nMinus2.get(), n) ||
+        !BN_sub_word(nMinus2.get(), 2)) {
+        return std::nullopt;
+    }
+
+    // bits2octets: h1 = (hash mod n), 32 bytes.
+    Bytes32 h1{};
+    BnPtr zmod = bn_new();
+    if (!zmod || !BN_nnmod(zmod.get(), z.get(), n, ctx.get()) || !bn_to32(zmod.get(), h1)) return std::nullopt;
+
+    Rfc6979 nonces(secret_, h1);
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        uint8_t kb[32];
+        nonces.next(kb);
+        BN_bin2bn(kb, sizeof(kb), k.get());
+        OPENSSL_cleanse(kb, sizeof(kb));
+        if (BN_is_zero(k.get()) || BN_cmp(k.get(), n) >= 0) continue;
+
+        // R = kG; r = R.x mod n
+        if (!EC_POINT_mul(curve(), R.get(), k.get(), nullptr, nullptr, ctx.get()) ||
+            !EC_POINT_get_affine_coordinates(curve(), R.get(), x.get(), y.get(), ctx.get()) ||
+            !BN_nnmod(r.get(), x.get(), n, ctx.get())) {
+            return std::nullopt;
+        }
+        if (BN_is_zero(r.get())) continue;
+        // R.x >= n happens with probability ~2^-128 and cannot be encoded in a
+        // 0/1 y parity; treat it like any other rejected nonce.
+        if (BN_cmp(x.get(), n) >= 0) continue;
+        uint8_t parity = BN_is_odd(y.get()) ? 1 : 0;
+
+        // s = k^-1 (z + r d) mod n. mont(a, b) = a b / R, so converting one
+        // factor into Montgomery form first leaves the plain product.
+        if (!BN_mod_exp_mont_consttime(kinv.get(), k.get(), nMinus2.get(), n, ctx.get(), mont.get()) ||
+            !BN_to_montgomery(tmp.get(), d.get(), mont.get(), ctx.get()) ||
+            !BN_mod_mul_montgomery(s.get(), r.get(), tmp.get(), mont.get(), ctx.get()) ||
+            !BN_mod_add_quick(s.get(), s.get(), zmod.get(), n) ||
+            !BN_to_montgomery(tmp.get(), s.get(), mont.get(), ctx.get()) ||
+            !BN_mod_mul_montgomery(s.get(), tmp.get(), kinv.get(), mont.get(), ctx.get())) {
+            return std::nullopt;
+        }
+        if (BN_is_zero(s.get())) continue;
+
+        // Low-s (EIP-2): s > n/2 -> n - s, which mirrors R and flips the parity.
+        BnPtr half = bn_new();
+        if (!half || !BN_rshift1(half.get(), n)) return std::nullopt;
+        if (BN_cmp(s.get(), half.get()) > 0) {
+            if (!BN_sub(s.get(), n, s.get())) return std::nullopt;
+            parity ^= 1;
+        }
+
+        Signature sig;
+        if (!bn_to32(r.get(), sig.r) || !bn_to32(s.get(), sig.s)) return std::nullopt;
+        sig.y_parity = parity;
+        return sig;
+    }
+    return std::nullopt;
+}
+
+// -----------------------------------------------------------------------------
+// Recovery
+// -----------------------------------------------------------------------------
+std::optional<AddressBytes> recover_address(const Bytes32& hash, const Signature& sig) {
+    if (sig.y_parity > 1) return std::nullopt;
+    CtxPtr ctx(BN_CTX_new());
+    BnPtr r = bn_from(sig.r.data(), sig.r.size());
+    BnPtr s = bn_from(sig.s.data(), sig.s.size());
+    BnPtr z = bn_from(hash.data(), hash.size());
+    BnPtr rinv = bn_new(), u1 = bn_new(), u2 = bn_new();
+    PointPtr R(EC_POINT_new(curve())), Q(EC_POINT_new(curve()));
+    if (!ctx || !r || !s || !z || !rinv || !u1 || !u2 || !R || !Q) return std::nullopt;
+    const BIGNUM* n = order();
+    if (BN_is_zero(r.get()) || BN_is_zero(s.get()) || BN_cmp(r.get(), n) >= 0 || BN_cmp(s.get(), n) >= 0) {
+        return std::nullopt;
+    }
+
+    // Q = r^-1 (sR - zG) = (-z r^-1) G + (s r^-1) R
+    if (!EC_POINT_set_compressed_coordinates(curve(), R.get(), r.get(), sig.y_parity, ctx.get()) ||
+        !BN_mod_inverse(rinv.get(), r.get(), n, ctx.get()) ||
+        !BN_nnmod(u1.get(), z.get(), n, ctx.get()) ||
+        !BN_mod_sub(u1.get(), n, u1.get(), n, ctx.get()) ||
+        !BN_mod_mul(u1.get(), u1.get(), rinv.get(), n, ctx.get()) ||
+        !BN_mod_mul(u2.get(), s.get(), rinv.get(), n, ctx.get()) ||
+        !EC_POINT_mul(curve(), Q.get(), u1.get(), R.get(), u2.get(), ctx.get()) ||
+        EC_POINT_is_at_infinity(curve(), Q.get())) {
+        return std::nullopt;
+    }
+
+    AddressBytes out{};
+    if (!address_of(Q.get(), ctx.get(), out)) return std::nullopt;
+    return out;
+}
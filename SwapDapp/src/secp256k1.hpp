@@ -0,0 +1,50 @@
+/*
+ * File:        secp256k1.hpp
+ * Created on:  2026-10-17
+ * Description: secp256k1 keys and recoverable ECDSA signatures over OpenSSL's
+ *              libcrypto (EC_GROUP / EC_POINT / BIGNUM). Nonces are
+ *              deterministic (RFC 6979, HMAC-SHA256). Signatures are
+ *              normalized to low-s and carry the y parity that Ethereum
+ *              transactions need.
+ */
+
+#pragma once
+
+#include "hex_codec.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+struct Signature {
+    std::array<uint8_t, 32> r{};
+    std::array<uint8_t, 32> s{};
+    uint8_t y_parity = 0;   // recovery id, 0 or 1
+};
+
+class Secp256k1Key {
+public:
+    // nullopt unless 0 < secret < n.
+    static std::optional<Secp256k1Key> from_secret(const std::array<uint8_t, 32>& secret);
+
+    ~Secp256k1Key();
+    Secp256k1Key(const Secp256k1Key&) = default;
+    Secp256k1Key& operator=(const Secp256k1Key&) = default;
+
+    const AddressBytes& address() const { return address_; }
+    std::string address_hex() const;   // lower-case, 0x-prefixed
+    const std::array<uint8_t, 32>& secret() const { return secret_; }
+
+    // Signs a 32-byte message hash. nullopt only on an OpenSSL failure.
+    std::optional<Signature> sign(const Bytes32& hash) const;
+
+private:
+    Secp256k1Key() = default;
+
+    std::array<uint8_t, 32> secret_{};
+    AddressBytes address_{};
+};
+
+// Address of the key that produced sig over hash; nullopt if sig is invalid.
+std::optional<AddressBytes> recover_address(const Bytes32& hash, const Signature& sig);
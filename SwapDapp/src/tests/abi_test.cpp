@@ -0,0 +1,81 @@
+/*
+ * File:        abi_test.cpp
+ * Created on:  2026-10-17
+ * Description: abi::Function against real ABI output. The selectors are
+ *              checked at compile time against the published ones (the same
+ *              strings the clients used to hard-code); the calldata vectors
+ *              are written out word by word from the ABI specification.
+ */
+
+#include "abi.hpp"
+#include "check.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+using Approve = abi::Function<"approve(address,uint256)">;
+using Allowance = abi::Function<"allowance(address,address)">;
+using Transfer = abi::Function<"transfer(address,uint256)">;
+using Decimals = abi::Function<"decimals()">;
+using SwapExactInSingle = abi::Function<"swapExactInSingle(address,address,uint24,uint256,uint256)">;
+using Mixed = abi::Function<"mixed(int8,bool,bytes4)">;
+
+static_assert(Approve::selector == std::array<uint8_t, 4>{0x09, 0x5e, 0xa7, 0xb3});
+static_assert(Allowance::selector == std::array<uint8_t, 4>{0xdd, 0x62, 0xed, 0x3e});
+static_assert(Transfer::selector == std::array<uint8_t, 4>{0xa9, 0x05, 0x9c, 0xbb});
+static_assert(Decimals::selector == std::array<uint8_t, 4>{0x31, 0x3c, 0xe5, 0x67});
+static_assert(SwapExactInSingle::selector == std::array<uint8_t, 4>{0x43, 0xec, 0xfa, 0x0a});
+static_assert(Approve::encoded_size == 68 && SwapExactInSingle::encoded_size == 164 && Decimals::encoded_size == 4);
+
+// Encoding is constexpr too: transfer(0x...01, 1).
+static_assert([] {
+    AddressBytes to{};
+    to[19] = 1;
+    std::array<uint8_t, 68> d = Transfer::encode(to, 1);
+    return d[0] == 0xa9 && d[35] == 0x01 && d[67] == 0x01 && d[66] == 0x00;
+}());
+
+static Address addr(const char* hex) {
+    return Address::from_hex(hex).value_or(Address());
+}
+
+static void calldata() {
+    Address spender = addr("0x70997970C51812dc3A010C7d01b50e0d17dc79C8");
+    CHECK(Approve::encode_hex(spender, uint256::max()) ==
+          "0x095ea7b3"
+          "00000000000000000000000070997970c51812dc3a010c7d01b50e0d17dc79c8"
+          "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+
+    Address owner = addr("0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266");
+    CHECK(Allowance::encode_hex(owner, spender) ==
+          "0xdd62ed3e"
+          "000000000000000000000000f39fd6e51aad88f6f4ce6ab8827279cfffb92266"
+          "00000000000000000000000070997970c51812dc3a010c7d01b50e0d17dc79c8");
+
+    CHECK(Decimals::encode_hex() == "0x313ce567");
+
+    Address tokenIn = addr("0x1c7D4B196Cb0C7B01d743Fbc6116a902379C7238");
+    Address tokenOut = addr("0xfFf9976782d46CC05630D1f6eBAb18b2324d6B14");
+    CHECK(SwapExactInSingle::encode_hex(tokenIn, tokenOut, 3000, uint256(1000000), uint256()) ==
+          "0x43ecfa0a"
+          "0000000000000000000000001c7d4b196cb0c7b01d743fbc6116a902379c7238"
+          "000000000000000000000000fff9976782d46cc05630d1f6ebab18b2324d6b14"
+          "0000000000000000000000000000000000000000000000000000000000000bb8"
+          "00000000000000000000000000000000000000000000000000000000000f4240"
+          "0000000000000000000000000000000000000000000000000000000000000000");
+
+    // Negative intN is sign-extended, bool is 0/1, bytesN is left-aligned.
+    std::array<uint8_t, 4> tag = {0xde, 0xad, 0xbe, 0xef};
+    std::string mixed = Mixed::encode_hex((int8_t)-2, true, tag);
+    CHECK(mixed.size() == 2 + 2 * Mixed::encoded_size);
+    CHECK(mixed.substr(10) ==
+          "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+          "0000000000000000000000000000000000000000000000000000000000000001"
+          "deadbeef00000000000000000000000000000000000000000000000000000000");
+}
+
+int main() {
+    calldata();
+    return check_result();
+}
@@ -0,0 +1,33 @@
+/*
+ * File:        check.hpp
+ * Created on:  2026-10-17
+ * Description: Minimal assertions for the test programs: a failed CHECK
+ *              prints where and what, and the program exits non-zero from
+ *              check_result() at the end of main.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+inline int& check_failures() {
+    static int n = 0;
+    return n;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++check_failures();                                                       \
+        }                                                                             \
+    } while (0)
+
+inline int check_result() {
+    if (check_failures() == 0) {
+        std::printf("ok\n");
+        return 0;
+    }
+    std::fprintf(stderr, "%d check(s) failed\n", check_failures());
+    return 1;
+}
@@ -0,0 +1,95 @@
+/*
+ * File:        head_subscriber_test.cpp
+ * Created on:  2026-10-17
+ * Description: HeadSubscriber against mock_ws.py: subscribes, delivers heads
+ *              to listeners and one-shot waiters, resubscribes after the
+ *              stand-in drops the connection, and with no URL reports itself
+ *              down so receipt waits fall back to polling at once.
+ *
+ *              head_subscriber_test ws://127.0.0.1:PORT   (mock dropping every 3 heads)
+ *
+ *              Exits 77 (skipped) when libcurl was built without WebSockets.
+ */
+
+#include "check.hpp"
+#include "ws_transport.hpp"
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static bool wait_until(const std::function<bool()>& pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(10ms);
+    }
+    return true;
+}
+
+static bool curl_has_ws() {
+    const curl_version_info_data* info = curl_version_info(CURLVERSION_NOW);
+    for (const char* const* p = info->protocols; *p; ++p) {
+        if (std::strcmp(*p, "ws") == 0) return true;
+    }
+    return false;
+}
+
+static void polling_only() {
+    HeadSubscriber heads("");
+    CHECK(!heads.connected());
+    bool fired = false, got = true;
+    heads.on_next_head([&](bool arrived) { fired = true; got = arrived; }, 5000ms);
+    CHECK(fired);   // right away, on this thread
+    CHECK(!got);
+    CHECK(!heads.wait_next_head(50ms));
+}
+
+static void subscribe_and_reconnect(const std::string& url) {
+    HeadSubscriber heads(url);
+    std::mutex mu;
+    std::vector<std::string> numbers;
+    heads.on_head([&](const nlohmann::json& head) {
+        std::lock_guard<std::mutex> lock(mu);
+        numbers.push_back(head.value("number", ""));
+    });
+
+    CHECK(wait_until([&] { return heads.connected(); }, 5000ms));
+    CHECK(heads.wait_next_head(2000ms));
+
+    std::atomic<bool> waited{false};
+    heads.on_next_head([&](bool arrived) { waited = arrived; }, 2000ms);
+    CHECK(wait_until([&] { return waited.load(); }, 3000ms));
+
+    // The mock closes after 3 heads; more than that means a resubscribe.
+    CHECK(wait_until([&] { return heads.heads_seen() >= 7; }, 10000ms));
+    std::lock_guard<std::mutex> lock(mu);
+    CHECK(numbers.size() >= 7);
+    for (const std::string& n : numbers) CHECK(n.rfind("0x", 0) == 0);
+}
+
+int main(int argc, char** argv) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    polling_only();
+    if (argc > 1) {
+        if (!curl_has_ws()) {
+            std::printf("libcurl %s has no WebSocket support: skipped\n", curl_version_info(CURLVERSION_NOW)->version);
+            curl_global_cleanup();
+            return check_failures() ? check_result() : 77;
+        }
+        subscribe_and_reconnect(argv[1]);
+    }
+    curl_global_cleanup();
+    return check_result();
+}
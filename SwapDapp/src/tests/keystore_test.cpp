@@ -0,0 +1,135 @@
+/*
+ * File:        keystore_test.cpp
+ * Created on:  2026-10-17
+ * Description: Keystore v3 against the two test vectors of the Web3 Secret
+ *              Storage definition (password "testpassword"): pbkdf2 with
+ *              c = 262144, and scrypt with n = 262144, r = 1, p = 8, which
+ *              OpenSSL refuses and keystore.cpp derives itself. Then a wrong
+ *              password, a tampered MAC, a mismatched address field,
+ *              mistyped or out-of-range kdf parameters, and an
+ *              encrypt_keystore() round trip.
+ */
+
+#include "check.hpp"
+#include "keystore.hpp"
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+static const char* kSecret = "0x7a28b5ba57c53603b0b07b56bba752f7784bf506fa95edc395f5cf6c7514fe9d";
+
+static nlohmann::json pbkdf2_vector() {
+    return nlohmann::json::parse(R"({
+        "crypto": {
+            "cipher": "aes-128-ctr",
+            "cipherparams": {"iv": "6087dab2f9fdbbfaddc31a909735c1e6"},
+            "ciphertext": "5318b4d5bcd28de64ee5559e671353e16f075ecae9f99c7a79a38af5f869aa46",
+            "kdf": "pbkdf2",
+            "kdfparams": {
+                "c": 262144,
+                "dklen": 32,
+                "prf": "hmac-sha256",
+                "salt": "ae3cd4e7013836a3df6bd7241b12db061dbe2c6785853cce422d148a624ce0bd"
+            },
+            "mac": "517ead924a9d0dc3124507e3393d175ce3ff7c1e96529c6c555ce9e51205e9b2"
+        },
+        "id": "3198bc9c-6672-5ab3-d995-4942343ae5b6",
+        "version": 3
+    })");
+}
+
+static nlohmann::json scrypt_vector() {
+    return nlohmann::json::parse(R"({
+        "crypto": {
+            "cipher": "aes-128-ctr",
+            "cipherparams": {"iv": "83dbcc02d8ccb40e466191a123791e0e"},
+            "ciphertext": "d172bf743a674da9cdad04534d56926ef8358534d458fffccd4e6ad2fbde479c",
+            "kdf": "scrypt",
+            "kdfparams": {
+                "dklen": 32,
+                "n": 262144,
+                "r": 1,
+                "p": 8,
+                "salt": "ab0c7876052600dd703518d6fc3fe8984592145b591fc8fb5c6d43190334ba19"
+            },
+            "mac": "2103ac29920d71da29f15d75b4a16dbe95cfd7ff8faea1056c33131d846e3097"
+        },
+        "id": "3198bc9c-6672-5ab3-d995-4942343ae5b6",
+        "version": 3
+    })");
+}
+
+static std::string secret_hex(const Secp256k1Key& key) {
+    return to_hex(key.secret().data(), key.secret().size());
+}
+
+static void spec_vectors() {
+    std::optional<Secp256k1Key> k = decrypt_keystore(pbkdf2_vector(), "testpassword");
+    CHECK(k && secret_hex(*k) == kSecret);
+    k = decrypt_keystore(scrypt_vector(), "testpassword");
+    CHECK(k && secret_hex(*k) == kSecret);
+}
+
+static void rejects() {
+    nlohmann::json doc = pbkdf2_vector();
+    CHECK(!decrypt_keystore(doc, "wrongpassword").has_value());
+
+    nlohmann::json tampered = doc;
+    tampered["crypto"]["mac"] = "417ead924a9d0dc3124507e3393d175ce3ff7c1e96529c6c555ce9e51205e9b2";
+    CHECK(!decrypt_keystore(tampered, "testpassword").has_value());
+
+    nlohmann::json other = doc;
+    other["address"] = "0000000000000000000000000000000000000001";
+    CHECK(!decrypt_keystore(other, "testpassword").has_value());
+
+    // Malformed parameters are rejected, not thrown or allocated.
+    nlohmann::json dklen = doc;
+    dklen["crypto"]["kdfparams"]["dklen"] = "32";
+    CHECK(!decrypt_keystore(dklen, "testpassword").has_value());
+    dklen["crypto"]["kdfparams"]["dklen"] = -1;
+    CHECK(!decrypt_keystore(dklen, "testpassword").has_value());
+    dklen["crypto"]["kdfparams"]["dklen"] = 1ull << 62;
+    CHECK(!decrypt_keystore(dklen, "testpassword").has_value());
+    nlohmann::json iterations = doc;
+    iterations["crypto"]["kdfparams"]["c"] = "262144";
+    CHECK(!decrypt_keystore(iterations, "testpassword").has_value());
+    nlohmann::json scrypt = scrypt_vector();
+    scrypt["crypto"]["kdfparams"]["n"] = "262144";
+    CHECK(!decrypt_keystore(scrypt, "testpassword").has_value());
+    scrypt["crypto"]["kdfparams"]["n"] = 1ull << 32;   // 512 GiB of scratch
+    CHECK(!decrypt_keystore(scrypt, "testpassword").has_value());
+    nlohmann::json kdf = doc;
+    kdf["crypto"]["kdf"] = 7;
+    CHECK(!decrypt_keystore(kdf, "testpassword").has_value());
+
+    nlohmann::json cipher = doc;
+    cipher["crypto"]["cipher"] = "aes-128-cbc";
+    CHECK(!decrypt_keystore(cipher, "testpassword").has_value());
+}
+
+static void round_trip() {
+    std::optional<Bytes32> secret = parse_word(kSecret);
+    std::optional<Secp256k1Key> key = secret ? Secp256k1Key::from_secret(*secret) : std::nullopt;
+    CHECK(key.has_value());
+    if (!key) return;
+    std::optional<nlohmann::json> doc = encrypt_keystore(*key, "hunter2", 1024);
+    CHECK(doc.has_value());
+    if (!doc) return;
+    CHECK((*doc)["crypto"]["kdfparams"].value("n", 0) == 1024);
+    CHECK("0x" + doc->value("address", "") == key->address_hex());
+
+    std::optional<Secp256k1Key> back = decrypt_keystore(*doc, "hunter2");
+    CHECK(back && back->address() == key->address() && back->secret() == key->secret());
+    CHECK(!decrypt_keystore(*doc, "hunter3").has_value());
+
+    // Fresh salt and IV every time.
+    std::optional<nlohmann::json> again = encrypt_keystore(*key, "hunter2", 1024);
+    CHECK(again && (*again)["crypto"]["ciphertext"] != (*doc)["crypto"]["ciphertext"]);
+}
+
+int main() {
+    spec_vectors();
+    rejects();
+    round_trip();
+    return check_result();
+}
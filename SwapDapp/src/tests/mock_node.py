@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# File:        mock_node.py
+# Created on:  2026-10-17
+# Description: JSON-RPC stand-in for an Ethereum node. It mines a block
+#              every BLOCK_TIME seconds. Sent transactions are mined in the
+#              next block with status 0x1. It answers the reads the clients
+#              make: chain id, block number, headers, receipts (single and
+#              per block), calls, nonces and fees.
+#
+#              Tests steer it through extra methods that are never counted:
+#                mock_set [key, value]   down (bool: 503 to everything),
+#                                        throttle (n: next n requests get 429),
+#                                        retry_after (s, with throttle),
+#                                        delay_ms (before every answer),
+#                                        block_receipts (bool: eth_getBlockReceipts known)
+#                mock_stats              {"requests": HTTP requests, "methods": {name: calls}}
+#                mock_reset              zero the counters and restore the defaults
+#
+#              mock_node.py PORT [BLOCK_TIME=1.0]
+
+import json
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+DEFAULTS = {"down": False, "throttle": 0, "retry_after": 1, "delay_ms": 0, "block_receipts": True}
+
+lock = threading.Lock()
+settings = dict(DEFAULTS)
+stats = {"requests": 0, "methods": {}}
+chain = {"block": 100, "ts": {}, "txs": {}, "nonce": 5}
+block_time = 1.0
+
+
+def header(n):
+    ts = chain["ts"].get(n, int(time.time() - (chain["block"] - n) * block_time))
+    return {"number": hex(n), "hash": "0x%064x" % n, "timestamp": hex(ts), "baseFeePerGas": "0x3b9aca00"}
+
+
+def receipt(h, n):
+    return {"transactionHash": h, "blockNumber": hex(n), "status": "0x1", "gasUsed": "0x5208", "logs": []}
+
+
+def block_arg(p, i=0):
+    tag = p[i] if len(p) > i else "latest"
+    return int(tag, 16) if isinstance(tag, str) and tag.startswith("0x") else chain["block"]
+
+
+def answer(req):
+    m = req.get("method")
+    p = req.get("params") or []
+    stats["methods"][m] = stats["methods"].get(m, 0) + 1
+    if m == "eth_chainId":
+        res = "0xaa36a7"
+    elif m == "eth_blockNumber":
+        res = hex(chain["block"])
+    elif m == "eth_getBlockByNumber":
+        n = block_arg(p)
+        res = header(n) if n <= chain["block"] else None
+    elif m in ("eth_sendTransaction", "eth_sendRawTransaction"):
+        h = "0x%064x" % (len(chain["txs"]) + 1)
+        chain["txs"][h] = chain["block"] + 1
+        res = h
+    elif m == "eth_getTransactionReceipt":
+        n = chain["txs"].get(p[0])
+        res = receipt(p[0], n) if n is not None and n <= chain["block"] else None
+    elif m == "eth_getTransactionByHash":
+        res = {"hash": p[0]} if p[0] in chain["txs"] else None
+    elif m == "eth_getBlockReceipts" and settings["block_receipts"]:
+        n = block_arg(p)
+        res = [receipt(h, b) for h, b in chain["txs"].items() if b == n] if n <= chain["block"] else None
+    elif m == "eth_call":
+        res = "0x" + "0" * 56 + "000f4240"
+    elif m == "eth_getTransactionCount":
+        res = hex(chain["nonce"])
+    elif m == "eth_getBalance":
+        res = "0xde0b6b3a7640000"
+    elif m == "eth_estimateGas":
+        res = "0xb411"
+    elif m in ("eth_gasPrice", "eth_maxPriorityFeePerGas"):
+        res = "0x3b9aca00"
+    else:
+        return {"jsonrpc": "2.0", "id": req.get("id"), "error": {"code": -32601, "message": "method not found"}}
+    return {"jsonrpc": "2.0", "id": req.get("id"), "result": res}
+
+
+def control(req):
+    m = req.get("method")
+    p = req.get("params") or []
+    if m == "mock_set":
+        settings[p[0]] = p[1]
+        res = True
+    elif m == "mock_reset":
+        settings.clear()
+        settings.update(DEFAULTS)
+        stats["requests"] = 0
+        stats["methods"] = {}
+        res = True
+    else:
+        res = {"requests": stats["requests"], "methods": dict(stats["methods"])}
+    return {"jsonrpc": "2.0", "id": req.get("id"), "result": res}
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, status, body, headers=()):
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        for k, v in headers:
+            self.send_header(k, v)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_POST(self):
+        body = json.loads(self.rfile.read(int(self.headers.get("Content-Length", 0))))
+        if isinstance(body, dict) and str(body.get("method", "")).startswith("mock_"):
+            with lock:
+                out = control(body)
+            self.reply(200, json.dumps(out).encode())
+            return
+
+        with lock:
+            stats["requests"] += 1
+            down = settings["down"]
+            throttled = settings["throttle"] > 0
+            if throttled:
+                settings["throttle"] -= 1
+            retry_after = settings["retry_after"]
+            delay = settings["delay_ms"] / 1000.0
+        if down:
+            self.reply(503, b"")
+            return
+        if throttled:
+            self.reply(429, b'{"error":"too many requests"}', [("Retry-After", str(retry_after))])
+            return
+        if delay:
+            time.sleep(delay)
+        with lock:
+            out = [answer(r) for r in body] if isinstance(body, list) else answer(body)
+        self.reply(200, json.dumps(out).encode())
+
+
+def miner():
+    while True:
+        time.sleep(block_time)
+        with lock:
+            chain["block"] += 1
+            chain["ts"][chain["block"]] = int(time.time())
+
+
+def main():
+    global block_time
+    port = int(sys.argv[1])
+    block_time = float(sys.argv[2]) if len(sys.argv) > 2 else 1.0
+    threading.Thread(target=miner, daemon=True).start()
+    ThreadingHTTPServer.daemon_threads = True
+    ThreadingHTTPServer.request_queue_size = 256
+    ThreadingHTTPServer(("127.0.0.1", port), Handler).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
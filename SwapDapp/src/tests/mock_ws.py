@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+#
+# File:        mock_ws.py
+# Created on:  2026-10-17
+# Description: WebSocket stand-in for a node's newHeads subscription. Accepts
+#              the upgrade, answers eth_subscribe with a subscription id and
+#              then pushes a head every INTERVAL seconds. With DROP_AFTER > 0
+#              each connection is closed after that many heads, so clients
+#              have to reconnect and subscribe again.
+#
+#              mock_ws.py PORT [INTERVAL=0.2] [DROP_AFTER=0]
+
+import base64
+import hashlib
+import json
+import socket
+import struct
+import sys
+import threading
+import time
+
+GUID = b"258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+block = 100
+block_lock = threading.Lock()
+
+
+def recv_exact(c, n):
+    d = b""
+    while len(d) < n:
+        part = c.recv(n - len(d))
+        if not part:
+            raise ConnectionError("closed")
+        d += part
+    return d
+
+
+def recv_frame(c):
+    h = recv_exact(c, 2)
+    n = h[1] & 0x7F
+    if n == 126:
+        n = struct.unpack(">H", recv_exact(c, 2))[0]
+    elif n == 127:
+        n = struct.unpack(">Q", recv_exact(c, 8))[0]
+    mask = recv_exact(c, 4) if h[1] & 0x80 else b"\0\0\0\0"
+    d = recv_exact(c, n)
+    return h[0] & 0x0F, bytes(b ^ mask[i % 4] for i, b in enumerate(d))
+
+
+def send_text(c, s):
+    d = s.encode()
+    n = len(d)
+    h = bytes([0x81]) + (bytes([n]) if n < 126 else bytes([126]) + struct.pack(">H", n))
+    c.sendall(h + d)
+
+
+def serve(c, interval, drop_after):
+    global block
+    try:
+        req = b""
+        while b"\r\n\r\n" not in req:
+            part = c.recv(4096)
+            if not part:
+                return
+            req += part
+        key = next(l.split(b":", 1)[1].strip() for l in req.split(b"\r\n")
+                   if l.lower().startswith(b"sec-websocket-key"))
+        accept = base64.b64encode(hashlib.sha1(key + GUID).digest()).decode()
+        c.sendall(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                   "Sec-WebSocket-Accept: %s\r\n\r\n" % accept).encode())
+
+        _, d = recv_frame(c)
+        r = json.loads(d)
+        if r.get("method") != "eth_subscribe" or r.get("params", [None])[0] != "newHeads":
+            send_text(c, json.dumps({"jsonrpc": "2.0", "id": r.get("id"),
+                                     "error": {"code": -32601, "message": "method not found"}}))
+            return
+        send_text(c, json.dumps({"jsonrpc": "2.0", "id": r["id"], "result": "0xsub1"}))
+
+        sent = 0
+        while drop_after <= 0 or sent < drop_after:
+            time.sleep(interval)
+            with block_lock:
+                block += 1
+                n = block
+            head = {"number": hex(n), "timestamp": hex(int(time.time())), "hash": "0x%064x" % n}
+            send_text(c, json.dumps({"jsonrpc": "2.0", "method": "eth_subscription",
+                                     "params": {"subscription": "0xsub1", "result": head}}))
+            sent += 1
+    except (OSError, ConnectionError, ValueError, StopIteration):
+        pass
+    finally:
+        c.close()
+
+
+def main():
+    port = int(sys.argv[1])
+    interval = float(sys.argv[2]) if len(sys.argv) > 2 else 0.2
+    drop_after = int(sys.argv[3]) if len(sys.argv) > 3 else 0
+    s = socket.socket()
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.bind(("127.0.0.1", port))
+    s.listen(16)
+    while True:
+        c, _ = s.accept()
+        threading.Thread(target=serve, args=(c, interval, drop_after), daemon=True).start()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,112 @@
+/*
+ * File:        rlp_test.cpp
+ * Created on:  2026-10-17
+ * Description: RLP encodings checked against the examples of the Ethereum
+ *              RLP spec and the edges of each form: single bytes around
+ *              0x80, strings and lists of 55 and 56 bytes (short and long
+ *              headers), integers with no leading zeros, nested empty lists,
+ *              and quantity_bytes().
+ */
+
+#include "check.hpp"
+#include "rlp.hpp"
+
+#include <cstdint>
+#include <string>
+
+static Bytes str(const std::string& s) {
+    return Bytes(s.begin(), s.end());
+}
+
+static std::string enc_bytes(const Bytes& b) {
+    Bytes out;
+    rlp_bytes(out, b);
+    return to_hex(out, false);
+}
+
+static std::string enc_uint(uint64_t v) {
+    Bytes out;
+    rlp_uint(out, v);
+    return to_hex(out, false);
+}
+
+static Bytes list(const Bytes& payload) {
+    Bytes out;
+    rlp_list(out, payload);
+    return out;
+}
+
+static void strings() {
+    CHECK(enc_bytes({}) == "80");
+    CHECK(enc_bytes(str("dog")) == "83646f67");
+    CHECK(enc_bytes({0x00}) == "00");
+    CHECK(enc_bytes({0x7f}) == "7f");
+    CHECK(enc_bytes({0x80}) == "8180");
+    CHECK(enc_bytes({0xff}) == "81ff");
+    CHECK(enc_bytes({0x00, 0x01}) == "820001");
+
+    // 55 bytes: last short header. 56: first long one (0xb8, one length byte).
+    CHECK(enc_bytes(Bytes(55, 0xaa)).substr(0, 2) == "b7");
+    std::string lorem = "Lorem ipsum dolor sit amet, consectetur adipisicing elit";
+    CHECK(lorem.size() == 56);
+    CHECK(enc_bytes(str(lorem)) == "b838" + to_hex(str(lorem), false));
+    // 1024 bytes: two length bytes.
+    CHECK(enc_bytes(Bytes(1024, 0x01)).substr(0, 6) == "b90400");
+}
+
+static void integers() {
+    CHECK(enc_uint(0) == "80");
+    CHECK(enc_uint(1) == "01");
+    CHECK(enc_uint(15) == "0f");
+    CHECK(enc_uint(127) == "7f");
+    CHECK(enc_uint(128) == "8180");
+    CHECK(enc_uint(1024) == "820400");
+    CHECK(enc_uint(0xffffff) == "83ffffff");
+    CHECK(enc_uint(UINT64_MAX) == "88ffffffffffffffff");
+}
+
+static void lists() {
+    CHECK(to_hex(list({}), false) == "c0");
+
+    Bytes catdog;
+    rlp_bytes(catdog, str("cat"));
+    rlp_bytes(catdog, str("dog"));
+    CHECK(to_hex(list(catdog), false) == "c88363617483646f67");
+
+    // The set-theoretic representation of three: [ [], [[]], [ [], [[]] ] ].
+    Bytes empty = list({});
+    Bytes one = list(empty);
+    Bytes pair = empty;
+    pair.insert(pair.end(), one.begin(), one.end());
+    Bytes three = empty;
+    three.insert(three.end(), one.begin(), one.end());
+    Bytes two = list(pair);
+    three.insert(three.end(), two.begin(), two.end());
+    CHECK(to_hex(list(three), false) == "c7c0c1c0c3c0c1c0");
+
+    // Payload of 55 bytes: 0xf7; of 56: 0xf8 0x38.
+    Bytes p55;
+    rlp_bytes(p55, Bytes(54, 0x11));
+    CHECK(p55.size() == 55);
+    CHECK(to_hex(list(p55), false).substr(0, 2) == "f7");
+    Bytes p56;
+    rlp_bytes(p56, str("Lorem ipsum dolor sit amet, consectetur adipisicing eli"));
+    CHECK(p56.size() == 56);
+    CHECK(to_hex(list(p56), false).substr(0, 4) == "f838");
+}
+
+static void quantities() {
+    CHECK(quantity_bytes("0x0") == Bytes{});
+    CHECK(quantity_bytes("0x00") == Bytes{});
+    CHECK(quantity_bytes("0x00ff") == Bytes{0xff});
+    CHECK(quantity_bytes("0x0de0b6b3a7640000") == (Bytes{0x0d, 0xe0, 0xb6, 0xb3, 0xa7, 0x64, 0x00, 0x00}));
+    CHECK(!quantity_bytes("0xzz").has_value());
+}
+
+int main() {
+    strings();
+    integers();
+    lists();
+    quantities();
+    return check_result();
+}
@@ -0,0 +1,219 @@
+/*
+ * File:        rpc_client_test.cpp
+ * Created on:  2026-10-17
+ * Description: RpcClient against mock_node.py instances: failover past a
+ *              dead port and past a node answering 503, the breaker opening
+ *              and closing again over HTTP, 429 handling (Retry-After
+ *              honoured, the concurrency limit lowered, a spent resend
+ *              budget not multiplied by RpcRetry) and single-flight
+ *              coalescing from threads and coroutines.
+ *
+ *              rpc_client_test URL_A URL_B URL_C DEAD_URL
+ */
+
+#include "check.hpp"
+#include "rpc_async.hpp"
+#include "rpc_client.hpp"
+#include "rpc_coalesce.hpp"
+#include "rpc_coro.hpp"
+#include "rpc_metrics.hpp"
+#include "rpc_retry.hpp"
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// -----------------------------------------------------------------------------
+// Mock control
+// -----------------------------------------------------------------------------
+static nlohmann::json mock(const std::string& url, const char* method, nlohmann::json params = nlohmann::json::array()) {
+    RpcClient ctl(url);
+    nlohmann::json req = {{"jsonrpc", "2.0"}, {"id", 1}, {"method", method}, {"params", std::move(params)}};
+    RpcResult r = rpc_result_from(rpc_call(ctl, req));
+    return r.ok() ? *r.result : nlohmann::json();
+}
+
+static void mock_set(const std::string& url, const char* key, nlohmann::json value) {
+    mock(url, "mock_set", nlohmann::json::array({key, std::move(value)}));
+}
+
+static int served(const std::string& url, const char* method = nullptr) {
+    nlohmann::json s = mock(url, "mock_stats");
+    if (!s.is_object()) return -1;
+    if (!method) return s.value("requests", -1);
+    return s["methods"].value(method, 0);
+}
+
+static nlohmann::json block_number_req() {
+    return {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "eth_blockNumber"}, {"params", nlohmann::json::array()}};
+}
+
+// -----------------------------------------------------------------------------
+// Failover and breaker
+// -----------------------------------------------------------------------------
+static void failover_dead_port(const std::string& a, const std::string& dead) {
+    mock(a, "mock_reset");
+    RpcClient client(std::vector<std::string>{dead, a});
+    int ok = 0;
+    for (int i = 0; i < 10; ++i) ok += rpc_call_retry(client, block_number_req()).ok();
+    CHECK(ok == 10);
+    CHECK(served(a, "eth_blockNumber") == 10);
+    std::vector<EndpointHealth> h = client.router().health();
+    CHECK(h[0].failures >= 1);
+    CHECK(h[0].requests <= 2);   // a failure counts as a slow sample: it drops out at once
+}
+
+static void failover_5xx(const std::string& a, const std::string& b) {
+    mock(a, "mock_reset");
+    mock(b, "mock_reset");
+    mock_set(b, "down", true);
+    RpcClient client(std::vector<std::string>{b, a});
+    int ok = 0;
+    for (int i = 0; i < 10; ++i) ok += rpc_call_retry(client, block_number_req()).ok();
+    CHECK(ok == 10);
+    CHECK(served(b) >= 1);
+    CHECK(served(a, "eth_blockNumber") == 10);
+    mock(b, "mock_reset");
+}
+
+static void breaker_over_http(const std::string& b) {
+    mock(b, "mock_reset");
+    mock_set(b, "down", true);
+    RpcClientOptions opts;
+    opts.router.breaker_failures = 2;
+    opts.router.breaker_cooldown = 200ms;
+    RpcClient client(b, opts);
+    for (int i = 0; i < 2; ++i) CHECK(!rpc_result_from(rpc_call(client, block_number_req())).ok());
+    CHECK(client.router().health()[0].state == BreakerState::Open);
+
+    mock_set(b, "down", false);
+    std::this_thread::sleep_for(250ms);
+    CHECK(rpc_result_from(rpc_call(client, block_number_req())).ok());   // the half-open probe
+    CHECK(client.router().health()[0].state == BreakerState::Closed);
+}
+
+// -----------------------------------------------------------------------------
+// 429 / Retry-After
+// -----------------------------------------------------------------------------
+static void throttled(const std::string& c) {
+    mock(c, "mock_reset");
+    mock_set(c, "throttle", 2);
+    mock_set(c, "retry_after", 1);
+    RpcClient client(c);
+    double limit = client.router().health()[0].concurrency_limit;
+
+    auto t0 = std::chrono::steady_clock::now();
+    RpcResult r = rpc_call_retry(client, block_number_req());
+    auto waited = std::chrono::steady_clock::now() - t0;
+    CHECK(r.ok());
+    CHECK(waited >= 1800ms);   // two Retry-After: 1 pauses
+    CHECK(served(c) == 3);
+    EndpointHealth h = client.router().health()[0];
+    CHECK(h.throttled == 2);
+    CHECK(h.concurrency_limit < limit);
+
+    // Still throttled after the client's own resends: RpcRetry does not add more.
+    mock(c, "mock_reset");
+    mock_set(c, "throttle", 100);
+    mock_set(c, "retry_after", 1);
+    RpcClientOptions opts;
+    opts.max_throttled_resends = 1;
+    RpcClient impatient(c, opts);
+    RpcErrorKind kind = RpcErrorKind::None;
+    CHECK(!rpc_call_retry(impatient, block_number_req(), {}, &kind).ok());
+    CHECK(kind == RpcErrorKind::RateLimited);
+    CHECK(served(c) == 2);
+    mock(c, "mock_reset");
+}
+
+// -----------------------------------------------------------------------------
+// Single-flight coalescing
+// -----------------------------------------------------------------------------
+static nlohmann::json decimals_call(int i) {
+    // Checksummed and lower-case spellings of one address: one key.
+    nlohmann::json call = {{"to", i % 2 ? "0x1c7D4B196Cb0C7B01d743Fbc6116a902379C7238"
+                                         : "0x1c7d4b196cb0c7b01d743fbc6116a902379c7238"},
+                           {"data", "0x313ce567"}};
+    return nlohmann::json::array({call});
+}
+
+static Task<int> coro_reads(CoroRpcClient& rpc, nlohmann::json call) {
+    RpcResult id = co_await rpc.call("eth_chainId");
+    RpcResult d = co_await rpc.call("eth_call", std::move(call));
+    co_return id.ok() && d.ok() ? 1 : 0;
+}
+
+static void coalescing(const std::string& a) {
+    mock(a, "mock_reset");
+    mock_set(a, "delay_ms", 300);
+    RpcClient client(a);
+    uint64_t joins = RpcMetrics::global().counters().coalesce_joins.value();
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&, i] {
+            RpcResult id = rpc_call_coalesced(client, "eth_chainId", nlohmann::json::array());
+            RpcResult d = rpc_call_coalesced(client, "eth_call", decimals_call(i));
+            ok += id.ok() && d.ok();
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    CHECK(ok == 16);
+    CHECK(served(a, "eth_chainId") == 1);
+    CHECK(served(a, "eth_call") == 1);
+    CHECK(RpcMetrics::global().counters().coalesce_joins.value() - joins == 30);
+
+    {
+        mock(a, "mock_reset");
+        mock_set(a, "delay_ms", 300);
+        AsyncRpcEngine engine(client);
+        ThreadPool pool(2);
+        CoroRpcClient rpc(engine, pool);
+        std::vector<std::future<int>> flows;
+        for (int i = 0; i < 16; ++i) flows.push_back(spawn(pool, coro_reads(rpc, decimals_call(i))));
+        int cok = 0;
+        for (std::future<int>& f : flows) cok += f.get();
+        CHECK(cok == 16);
+        CHECK(served(a, "eth_chainId") == 1);
+        CHECK(served(a, "eth_call") == 1);
+    }
+
+    // Writes and coalescing off: every call is sent.
+    mock(a, "mock_reset");
+    mock_set(a, "delay_ms", 100);
+    RpcClientOptions off;
+    off.coalesce = false;
+    RpcClient plain(a, off);
+    threads.clear();
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] { rpc_call_coalesced(plain, "eth_chainId", nlohmann::json::array()); });
+    }
+    for (std::thread& t : threads) t.join();
+    CHECK(served(a, "eth_chainId") == 8);
+    CHECK(!rpc_coalesce_key("eth_sendRawTransaction", nlohmann::json::array({"0x00"})).has_value());
+    mock(a, "mock_reset");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::fprintf(stderr, "usage: rpc_client_test URL_A URL_B URL_C DEAD_URL\n");
+        return 2;
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    failover_dead_port(argv[1], argv[4]);
+    failover_5xx(argv[1], argv[2]);
+    breaker_over_http(argv[2]);
+    throttled(argv[3]);
+    coalescing(argv[1]);
+    curl_global_cleanup();
+    return check_result();
+}
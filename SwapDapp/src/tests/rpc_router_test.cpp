@@ -0,0 +1,147 @@
+/*
+ * File:        rpc_router_test.cpp
+ * Created on:  2026-10-17
+ * Description: RpcRouter on its own, with outcomes reported by hand: sticky
+ *              per-thread routing and its slack, the circuit breaker
+ *              (open, half-open probe, reopen with a doubled cooldown,
+ *              close), Retry-After pauses and least-outstanding selection.
+ */
+
+#include "check.hpp"
+#include "rpc_router.hpp"
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static const std::vector<std::string> kUrls = {"http://a", "http://b"};
+
+static BreakerState state(const RpcRouter& r, size_t i) {
+    return r.health()[i].state;
+}
+
+// One request to whatever pick() chooses, answered in `latency`.
+static std::optional<size_t> request(RpcRouter& r, std::chrono::microseconds latency, uint64_t exclude = 0) {
+    std::optional<size_t> ep = r.pick(exclude);
+    if (ep) r.finish(*ep, RouteOutcome::Success, latency);
+    return ep;
+}
+
+// A sample for endpoint i that leaves the thread's affinity alone.
+static void sample(RpcRouter& r, size_t i, std::chrono::microseconds latency) {
+    r.claim(i);
+    r.finish(i, RouteOutcome::Success, latency);
+}
+
+static void sticky_routing() {
+    RpcRouter r(kUrls);
+    // Both sampled at the same latency; ties go to the first, then it sticks.
+    sample(r, 0, 1000us);
+    sample(r, 1, 1000us);
+    std::optional<size_t> first = request(r, 1000us);
+    CHECK(first == 0u);
+    for (int i = 0; i < 20; ++i) CHECK(request(r, 1000us) == first);
+
+    // Within the 2x slack the thread stays put...
+    for (int i = 0; i < 10; ++i) sample(r, 1, 700us);
+    CHECK(request(r, 1000us) == 0u);
+    // ...and moves once its endpoint scores more than twice the best.
+    for (int i = 0; i < 10; ++i) sample(r, 0, 5000us);
+    CHECK(request(r, 1000us) == 1u);
+    CHECK(request(r, 1000us) == 1u);
+
+    // Slack 1.0: no stickiness, always the best score.
+    RouterOptions loose;
+    loose.sticky_slack = 1.0;
+    RpcRouter plain(kUrls, loose);
+    sample(plain, 0, 1000us);
+    sample(plain, 1, 700us);
+    CHECK(request(plain, 1000us) == 1u);
+    sample(plain, 1, 3000us);
+    CHECK(request(plain, 1000us) == 0u);
+}
+
+static void breaker() {
+    RouterOptions opts;
+    opts.breaker_failures = 3;
+    opts.breaker_cooldown = 100ms;
+    RpcRouter r(kUrls, opts);
+    const uint64_t onlyB = 0b01;
+
+    for (int i = 0; i < 3; ++i) r.finish(*r.pick(onlyB), RouteOutcome::Failure, 1000us);
+    CHECK(state(r, 1) == BreakerState::Open);
+    CHECK(r.health()[1].failures == 3);
+    // Open: traffic goes to the other endpoint.
+    for (int i = 0; i < 5; ++i) CHECK(request(r, 1000us) == 0u);
+
+    // After the cooldown one probe is let through (half-open)...
+    std::this_thread::sleep_for(120ms);
+    std::optional<size_t> probe = r.pick(onlyB);
+    CHECK(probe == 1u);
+    CHECK(state(r, 1) == BreakerState::HalfOpen);
+    // ...and its failure reopens the breaker for twice the cooldown.
+    r.finish(1, RouteOutcome::Failure, 1000us);
+    CHECK(state(r, 1) == BreakerState::Open);
+    std::this_thread::sleep_for(120ms);
+    std::optional<size_t> early = r.pick(onlyB);   // all open: used anyway, still open
+    CHECK(early == 1u);
+    CHECK(state(r, 1) == BreakerState::Open);
+    r.finish(1, RouteOutcome::Cancelled, 0us);
+
+    std::this_thread::sleep_for(100ms);
+    probe = r.pick(onlyB);
+    CHECK(probe == 1u);
+    CHECK(state(r, 1) == BreakerState::HalfOpen);
+    r.finish(1, RouteOutcome::Success, 1000us);
+    CHECK(state(r, 1) == BreakerState::Closed);
+
+    // A 429 is not a breaker failure.
+    for (int i = 0; i < 5; ++i) {
+        std::optional<size_t> ep = r.pick(onlyB);
+        if (ep) r.finish(*ep, RouteOutcome::Throttled, 1000us, std::chrono::seconds(0));
+    }
+    CHECK(state(r, 1) == BreakerState::Closed);
+}
+
+static void retry_after() {
+    RpcRouter r(kUrls);
+    r.finish(*r.pick(0b10), RouteOutcome::Throttled, 1000us, std::chrono::seconds(1));
+    EndpointHealth a = r.health()[0];
+    CHECK(a.throttled == 1);
+    CHECK(a.retry_after > 500ms && a.retry_after <= 1000ms);
+    for (int i = 0; i < 5; ++i) CHECK(request(r, 1000us) == 1u);   // paused endpoint skipped
+
+    // With no other endpoint the caller is told how long to wait.
+    RpcRouter single({"http://a"});
+    single.finish(*single.pick(), RouteOutcome::Throttled, 1000us, std::chrono::seconds(1));
+    std::chrono::microseconds wait{0};
+    CHECK(!single.pick(0, &wait).has_value());
+    CHECK(wait > 500ms && wait <= 1000ms);
+}
+
+static void least_outstanding() {
+    RouterOptions opts;
+    opts.sticky_slack = 1.0;
+    RpcRouter r(kUrls, opts);
+    sample(r, 0, 1000us);
+    sample(r, 1, 1000us);
+    // Requests held open spread over both endpoints.
+    std::vector<size_t> held;
+    for (int i = 0; i < 6; ++i) held.push_back(*r.pick());
+    std::vector<EndpointHealth> h = r.health();
+    CHECK(h[0].outstanding == 3 && h[1].outstanding == 3);
+    for (size_t ep : held) r.finish(ep, RouteOutcome::Success, 1000us);
+    CHECK(r.health()[0].outstanding == 0);
+}
+
+int main() {
+    sticky_routing();
+    breaker();
+    retry_after();
+    least_outstanding();
+    return check_result();
+}
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#
+# File:        run_with_mock.py
+# Created on:  2026-10-17
+# Description: CTest driver: starts one or more mock servers, waits until each
+#              accepts connections, runs the test binary, stops the mocks and
+#              exits with the test's status.
+#
+#              run_with_mock.py MOCK PORT [ARGS...] [-- MOCK PORT [ARGS...]] -- TEST [ARGS...]
+#
+#              Every group but the last is a mock (a Python script and the
+#              port it listens on); the last group is the test command.
+
+import socket
+import subprocess
+import sys
+import time
+
+
+def wait_listening(port, proc, timeout=10.0):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if proc.poll() is not None:
+            return False
+        try:
+            with socket.create_connection(("127.0.0.1", port), timeout=0.2):
+                return True
+        except OSError:
+            time.sleep(0.05)
+    return False
+
+
+def main(argv):
+    groups = [[]]
+    for a in argv:
+        if a == "--":
+            groups.append([])
+        else:
+            groups[-1].append(a)
+    if len(groups) < 2 or any(len(g) < 2 for g in groups[:-1]) or not groups[-1]:
+        print("usage: run_with_mock.py MOCK PORT [ARGS...] [-- MOCK PORT [ARGS...]] -- TEST [ARGS...]", file=sys.stderr)
+        return 2
+
+    mocks = []
+    try:
+        for script, port, *args in groups[:-1]:
+            proc = subprocess.Popen([sys.executable, script, port, *args])
+            mocks.append(proc)
+            if not wait_listening(int(port), proc):
+                print(f"mock {script} did not start on port {port}", file=sys.stderr)
+                return 1
+        return subprocess.call(groups[-1])
+    finally:
+        for proc in mocks:
+            proc.terminate()
+        for proc in mocks:
+            try:
+                proc.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
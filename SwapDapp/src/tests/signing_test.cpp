@@ -0,0 +1,176 @@
+/*
+ * File:        signing_test.cpp
+ * Created on:  2026-10-17
+ * Description: Known-answer tests for signing:
+ *              - Keccak-256 of "" and "abc".
+ *              - secp256k1 RFC 6979 deterministic signatures (private key 1,
+ *                SHA-256 of the message; low-s), as published with
+ *                python-ecdsa and trezor-crypto.
+ *              - The EIP-155 example transaction, byte for byte.
+ *              - EIP-1559 signing hashes, raw envelopes and transaction
+ *                hashes for a transfer and a contract creation.
+ *              Each signature must also recover to the signing address.
+ */
+
+#include "check.hpp"
+#include "eth_tx.hpp"
+#include "keccak.hpp"
+#include "rlp.hpp"
+#include "secp256k1.hpp"
+
+#include <openssl/sha.h>
+
+#include <cstring>
+#include <string>
+
+static std::string hex(const uint8_t* data, size_t len) {
+    return to_hex(data, len, false);
+}
+
+template <size_t N>
+static std::string hex(const std::array<uint8_t, N>& a) {
+    return hex(a.data(), a.size());
+}
+
+static std::array<uint8_t, 32> secret(const char* h) {
+    std::optional<Bytes32> w = parse_word(h);
+    return w ? *w : std::array<uint8_t, 32>{};
+}
+
+// The EIP-155 example key, 0x4646...46.
+static Secp256k1Key key46() {
+    return *Secp256k1Key::from_secret(secret("0x4646464646464646464646464646464646464646464646464646464646464646"));
+}
+
+static void keccak() {
+    CHECK(hex(keccak256("")) == "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470");
+    CHECK(hex(keccak256("abc")) == "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45");
+}
+
+static void rfc6979() {
+    std::optional<Secp256k1Key> one = Secp256k1Key::from_secret(secret("0x01"));
+    CHECK(one.has_value());
+    if (!one) return;
+    CHECK(one->address_hex() == "0x7e5f4552091a69125d5dfcb7b8c2659029395bdf");
+
+    struct Vector {
+        const char* message;
+        const char* r;
+        const char* s;
+    };
+    const Vector vectors[] = {
+        {"Satoshi Nakamoto",
+         "934b1ea10a4b3c1757e2b0c017d0b6143ce3c9a7e6a4a49860d7a6ab210ee3d8",
+         "2442ce9d2b916064108014783e923ec36b49743e2ffa1c4496f01a512aafd9e5"},
+        {"All those moments will be lost in time, like tears in rain. Time to die...",
+         "8600dbd41e348fe5c9465ab92d23e3db8b98b873beecd930736488696438cb6b",
+         "547fe64427496db33bf66019dacbf0039c04199abb0122918601db38a72cfc21"},
+    };
+    for (const Vector& v : vectors) {
+        Bytes32 digest{};
+        SHA256(reinterpret_cast<const uint8_t*>(v.message), std::strlen(v.message), digest.data());
+        std::optional<Signature> sig = one->sign(digest);
+        CHECK(sig.has_value());
+        if (!sig) continue;
+        CHECK(hex(sig->r) == v.r);
+        CHECK(hex(sig->s) == v.s);
+        CHECK(recover_address(digest, *sig) == one->address());
+    }
+
+    // Zero and the group order are not keys.
+    CHECK(!Secp256k1Key::from_secret(std::array<uint8_t, 32>{}).has_value());
+    CHECK(!Secp256k1Key::from_secret(
+               secret("0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141")).has_value());
+}
+
+// Legacy transaction from EIP-155: nonce 9, 20 gwei, 21000 gas, 1 ether to
+// 0x3535...35, chain id 1, signed with v = 37 or 38.
+static void eip155() {
+    Secp256k1Key key = key46();
+    CHECK(key.address_hex() == "0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f");
+
+    Bytes fields;
+    rlp_uint(fields, 9);
+    rlp_uint(fields, 20000000000ull);
+    rlp_uint(fields, 21000);
+    rlp_bytes(fields, Bytes(20, 0x35));
+    rlp_uint(fields, 1000000000000000000ull);
+    rlp_bytes(fields, Bytes{});
+
+    Bytes unsigned_fields = fields;
+    rlp_uint(unsigned_fields, 1);
+    rlp_uint(unsigned_fields, 0);
+    rlp_uint(unsigned_fields, 0);
+    Bytes payload;
+    rlp_list(payload, unsigned_fields);
+    Bytes32 hash = keccak256(payload.data(), payload.size());
+    CHECK(hex(hash) == "daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53");
+
+    std::optional<Signature> sig = key.sign(hash);
+    CHECK(sig.has_value());
+    if (!sig) return;
+    rlp_uint(fields, 37 + sig->y_parity);
+    rlp_bytes(fields, sig->r.data(), sig->r.size());
+    rlp_bytes(fields, sig->s.data(), sig->s.size());
+    Bytes raw;
+    rlp_list(raw, fields);
+    CHECK(to_hex(raw, false) ==
+          "f86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025a028ef6134"
+          "0bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703304b3800ccf555c9f3"
+          "dc64214b297fb1966a3b6d83");
+}
+
+static void eip1559() {
+    Secp256k1Key key = key46();
+
+    // Transfer: chain 1, nonce 7, tip 2 gwei, max fee 50 gwei, 1 ether.
+    Eip1559Tx transfer;
+    transfer.chain_id = 1;
+    transfer.nonce = 7;
+    transfer.max_priority_fee_per_gas = 2000000000;
+    transfer.max_fee_per_gas = 50000000000;
+    transfer.gas_limit = 21000;
+    transfer.to = AddressBytes{};
+    transfer.to->fill(0x35);
+    transfer.value = *quantity_bytes("0xde0b6b3a7640000");
+    CHECK(hex(eip1559_signing_hash(transfer)) == "de3d28bfc974f49966be4edf169d127b9eb8bb67b41a3c4b0f58f7a9e7abbd49");
+    std::optional<SignedTx> t = sign_eip1559(transfer, key);
+    CHECK(t.has_value());
+    if (t) {
+        CHECK(t->raw ==
+              "0x02f87301078477359400850ba43b7400825208943535353535353535353535353535353535353535880de0b6b3a7"
+              "64000080c001a061c28b1e87a0ab3c0d3f05d1b4e5eae00067e08edada1a0d88f7c088056e9157a01bf434256727e2"
+              "ce6f66e5110d3e0129e0a81c5cda8441a3b91ef660e0111374");
+        CHECK(t->hash.hex_string() == "0x5f1a4223388da8dd7a4c6cff414e2b98a217f5d6765c711d30f77db7b8397c2b");
+    }
+
+    // Contract creation: chain 11155111, no `to`, zero value, init code.
+    Eip1559Tx create;
+    create.chain_id = 11155111;
+    create.nonce = 0;
+    create.max_priority_fee_per_gas = 1000000000;
+    create.max_fee_per_gas = 3000000000;
+    create.gas_limit = 100000;
+    create.data = *from_hex("0x6080604052");
+    CHECK(hex(eip1559_signing_hash(create)) == "57db348455d7200ab34db1373dd3b4db64f19c4eeaee2988f11beab052bc4a62");
+    std::optional<SignedTx> c = sign_eip1559(create, key);
+    CHECK(c.has_value());
+    if (c) {
+        CHECK(c->raw ==
+              "0x02f85f83aa36a780843b9aca0084b2d05e00830186a08080856080604052c001a0692679b26eb168a400efcf8bb8"
+              "3bc5f01179aadd12f9d4952f3a6c59cf033d5fa0584fe82425506390bf9356f029c8bf1d5d27190ed040dfc37618ec"
+              "c37ec63a0a");
+        CHECK(c->hash.hex_string() == "0x2823f175b97c51922fc39ad68b69a522f6117df9a7575365a0f6338ef553b37f");
+    }
+
+    std::optional<Signature> sig = key.sign(eip1559_signing_hash(create));
+    CHECK(sig && recover_address(eip1559_signing_hash(create), *sig) == key.address());
+}
+
+int main() {
+    keccak();
+    rfc6979();
+    eip155();
+    eip1559();
+    return check_result();
+}
@@ -0,0 +1,132 @@
+/*
+ * File:        tx_tracker_test.cpp
+ * Created on:  2026-10-17
+ * Description: TxTracker and the block clock against mock_node.py (1 s
+ *              blocks): the interval is learned from headers, many pending
+ *              transactions are settled by a few batched lookups and block
+ *              sweeps (with or without eth_getBlockReceipts on the node)
+ *              instead of polls per transaction, and a hash
+ *              that never confirms times out on the wheel.
+ *
+ *              tx_tracker_test URL
+ */
+
+#include "check.hpp"
+#include "poll_policy.hpp"
+#include "rpc_client.hpp"
+#include "tx_tracker.hpp"
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static nlohmann::json call(RpcClient& client, const char* method, nlohmann::json params = nlohmann::json::array()) {
+    nlohmann::json req = {{"jsonrpc", "2.0"}, {"id", 1}, {"method", method}, {"params", std::move(params)}};
+    RpcResult r = rpc_result_from(rpc_call(client, req));
+    return r.ok() ? *r.result : nlohmann::json();
+}
+
+static std::vector<std::string> send_txs(RpcClient& client, int n) {
+    std::vector<std::string> hashes;
+    nlohmann::json tx = {{"from", "0xf39fd6e51aad88f6f4ce6ab8827279cfffb92266"}, {"to", "0x70997970c51812dc3a010c7d01b50e0d17dc79c8"}};
+    for (int i = 0; i < n; ++i) {
+        nlohmann::json h = call(client, "eth_sendTransaction", nlohmann::json::array({tx}));
+        if (h.is_string()) hashes.push_back(h.get<std::string>());
+    }
+    return hashes;
+}
+
+// Tracks every hash and returns how many confirmed with status 0x1.
+static int confirm_all(TxTracker& tracker, const std::vector<std::string>& hashes) {
+    std::vector<std::future<nlohmann::json>> receipts;
+    for (const std::string& h : hashes) receipts.push_back(tracker.track(h, 10000ms));
+    int ok = 0;
+    for (std::future<nlohmann::json>& f : receipts) {
+        try {
+            ok += f.get().value("status", "") == "0x1";
+        } catch (const std::exception&) {
+        }
+    }
+    return ok;
+}
+
+static void block_clock(RpcClient& client, BlockClock& clock) {
+    CHECK(learn_block_time(client, clock));
+    std::optional<std::chrono::milliseconds> interval = clock.interval();
+    CHECK(interval.has_value());
+    if (interval) CHECK(*interval >= 800ms && *interval <= 1200ms);
+}
+
+static void one_sweep_per_block(RpcClient& client, BlockClock& clock) {
+    AdaptivePollPolicy policy(clock);
+    TxTrackerOptions opts;
+    opts.poll_policy = &policy;
+    opts.clock = &clock;
+    call(client, "mock_reset");
+    {
+        TxTracker tracker(client, nullptr, opts);
+        std::vector<std::string> hashes = send_txs(client, 20);
+        CHECK(hashes.size() == 20);
+        CHECK(confirm_all(tracker, hashes) == 20);
+        // Per-transaction polling would cost at least one request per tx.
+        CHECK(tracker.requests_sent() < 10);
+        CHECK(tracker.pending() == 0);
+    }
+    // The node agrees: past the sends, a handful of HTTP requests in all
+    // (tip polls, one batch of lookups by hash, block sweeps).
+    nlohmann::json stats = call(client, "mock_stats");
+    CHECK(stats.value("requests", 0) - 20 < 10);
+
+    // Without eth_getBlockReceipts: one batch of lookups by hash per block.
+    call(client, "mock_reset");
+    call(client, "mock_set", nlohmann::json::array({"block_receipts", false}));
+    {
+        TxTracker tracker(client, nullptr, opts);
+        std::vector<std::string> hashes = send_txs(client, 10);
+        CHECK(confirm_all(tracker, hashes) == 10);
+        CHECK(tracker.requests_sent() < 10);
+    }
+    stats = call(client, "mock_stats");
+    CHECK(stats.value("requests", 0) - 10 < 10);
+    call(client, "mock_reset");
+}
+
+static void timeout() {
+    RpcClient client(std::string("http://127.0.0.1:1"));   // nothing there: nothing ever confirms
+    TxTrackerOptions opts;
+    opts.block_poll_interval = 100ms;
+    TxTracker tracker(client, nullptr, opts);
+    std::future<nlohmann::json> f = tracker.track(std::string("0x") + std::string(64, 'a'), 300ms);
+    CHECK(f.wait_for(2s) == std::future_status::ready);
+    bool threw = false;
+    try {
+        f.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: tx_tracker_test URL\n");
+        return 2;
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    {
+        RpcClient client(argv[1]);
+        BlockClock clock;
+        block_clock(client, clock);
+        one_sweep_per_block(client, clock);
+        timeout();
+    }
+    curl_global_cleanup();
+    return check_result();
+}
@@ -0,0 +1,158 @@
+/*
+ * File:        uint256_test.cpp
+ * Created on:  2026-10-17
+ * Description: uint256 known answers: Knuth division (2-, 3- and 4-limb
+ *              divisors, the rare add-back step), plus q * v + r == u over
+ *              a fixed pseudo-random sweep; hex and decimal parsing at the
+ *              2^256 boundary; parse_units and format_units.
+ */
+
+#include "check.hpp"
+#include "uint256.hpp"
+
+#include <cstdint>
+#include <string>
+
+static const char* kMaxDec = "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+
+static uint256 hex(const char* s) {
+    return uint256::from_hex(s).value_or(uint256());
+}
+
+static std::string units(const uint256& v, unsigned decimals) {
+    char buf[96];
+    std::to_chars_result r = format_units(buf, buf + sizeof(buf), v, decimals);
+    return r.ec == std::errc() ? std::string(buf, r.ptr) : std::string("<error>");
+}
+
+static void divmod_known() {
+    struct Case {
+        const char* u;
+        const char* v;
+        const char* q;
+        const char* r;
+    };
+    const Case cases[] = {
+        {"0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff", "0x100000000000000000000000000000001",
+         "0xffffffffffffffffffffffffffffffff", "0x0"},
+        {"0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+         "0x1000000000000000000000000000000000000000000000001", "0xffffffffffffffff",
+         "0xffffffffffffffffffffffffffffffff0000000000000000"},
+        {"0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+         "0x8000000000000000ffffffffffffffff0000000000000001", "0x1fffffffffffffffc",
+         "0x5fffffffffffffffa0000000000000003"},
+        {"0x7fffffffffffffffffffffffffffffff00000000000000000000000000000000", "0x80000000000000000000000000000001",
+         "0xfffffffffffffffffffffffffffffffc", "0x4"},
+        // qhat one too large: the divisor is added back.
+        {"0x800000000000000000000000000000000000000000000003", "0x200000000000000000000000000000000000000000000001",
+         "0x3", "0x200000000000000000000000000000000000000000000000"},
+        {"0x7fff800000000000000000000000000000000000000000000000800000000000", "0x80000000000000010000ffffffffffff",
+         "0xfffefffffffffffe0000000200000006", "0xfffdfffdfff7fffa800200000006"},
+        {"0xdd15fe86affad91249ef0eb713f39ebeaa987b6e6fd2a0000000000000000000", "0x56bc75e2d63100007",
+         "0x28c87cb5c89a2571b75448dead52ea948752cda9e769ffff", "0x38fc549e80f2a0007"},
+    };
+    for (const Case& c : cases) {
+        uint256::DivMod d = uint256::divmod(hex(c.u), hex(c.v));
+        CHECK(d.quot == hex(c.q));
+        CHECK(d.rem == hex(c.r));
+    }
+    CHECK(uint256::divmod(uint256(7), uint256(9)).rem == uint256(7));
+    CHECK(uint256::divmod(uint256::max(), uint256()).quot.is_zero());   // like the EVM's DIV
+    CHECK(uint256::max() / uint256(10) == hex("0x1999999999999999999999999999999999999999999999999999999999999999"));
+}
+
+// Every (u, v) must satisfy u == q * v + r with r < v and no overflow.
+static void divmod_sweep() {
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    auto next = [&x] {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return x;
+    };
+    auto limbs = [&next](unsigned n, unsigned shift) {
+        uint64_t l[4] = {};
+        for (unsigned i = 0; i < n; ++i) l[i] = next() >> (i + 1 == n ? shift : 0);
+        return uint256::from_limbs(l[0], l[1], l[2], l[3]);
+    };
+    int bad = 0;
+    for (int i = 0; i < 20000; ++i) {
+        uint256 u = limbs(4, (unsigned)(next() % 64));
+        uint256 v = limbs(1 + (unsigned)(next() % 4), (unsigned)(next() % 64));
+        if (v.is_zero()) continue;
+        uint256::DivMod d = uint256::divmod(u, v);
+        uint256 back;
+        bool over = mul_overflow(d.quot, v, back) || add_overflow(back, d.rem, back);
+        if (over || back != u || d.rem >= v) ++bad;
+    }
+    CHECK(bad == 0);
+}
+
+static void parsing() {
+    CHECK(uint256::from_dec(kMaxDec) == uint256::max());
+    CHECK(!uint256::from_dec("115792089237316195423570985008687907853269984665640564039457584007913129639936"));
+    CHECK(!uint256::from_dec(std::string(79, '9')));
+    CHECK(uint256::from_dec("000000000000000000000000000000000000000000000000000000000000000000000000000000000042") ==
+          uint256(42));
+    CHECK(!uint256::from_dec(""));
+    CHECK(!uint256::from_dec("12a"));
+    CHECK(!uint256::from_dec("-1"));
+
+    CHECK(uint256::from_hex("0x12") == uint256(0x12));
+    CHECK(uint256::from_hex("12") == uint256(0x12));
+    CHECK(uint256::from_hex("0X0a") == uint256(10));
+    CHECK(!uint256::from_hex("0x0x12"));
+    CHECK(!uint256::from_hex("0x"));
+    CHECK(!uint256::from_hex(""));
+    CHECK(!uint256::from_hex("0xg1"));
+    CHECK(uint256::from_hex("0x" + std::string(64, 'f')) == uint256::max());
+    CHECK(!uint256::from_hex("0x1" + std::string(64, '0')));
+    CHECK(uint256::from_hex("0x" + std::string(70, '0') + "1") == uint256(1));
+
+    CHECK(uint256::parse("0x10") == uint256(16));
+    CHECK(uint256::parse("10") == uint256(10));
+    CHECK(to_string(uint256::max()) == kMaxDec);
+    CHECK(to_quantity(uint256()) == "0x0");
+    CHECK(to_quantity(uint256(255)) == "0xff");
+}
+
+static void parsing_units() {
+    CHECK(uint256::parse_units("1.5", 6) == uint256(1500000));
+    CHECK(uint256::parse_units("0.000001", 6) == uint256(1));
+    CHECK(!uint256::parse_units("0.0000001", 6));
+    CHECK(uint256::parse_units("1.50", 1) == uint256(15));   // trailing zeros are not precision
+    CHECK(uint256::parse_units(".5", 1) == uint256(5));
+    CHECK(uint256::parse_units("5.", 0) == uint256(5));
+    CHECK(uint256::parse_units("1", 18) == uint256(1000000000000000000ull));
+    CHECK(uint256::parse_units("1", 77) == pow10_u256(77));
+    CHECK(!uint256::parse_units("2", 77));   // 2 * 10^77 > 2^256
+    CHECK(!uint256::parse_units("1", 78));
+    CHECK(!uint256::parse_units(".", 6));
+    CHECK(!uint256::parse_units("", 6));
+    CHECK(!uint256::parse_units("1.2.3", 6));
+    CHECK(!uint256::parse_units("1e6", 6));
+}
+
+static void formatting_units() {
+    CHECK(units(uint256(1500000), 6) == "1.5");
+    CHECK(units(uint256(1), 18) == "0.000000000000000001");
+    CHECK(units(uint256(), 18) == "0");
+    CHECK(units(uint256(1000000000000000000ull), 18) == "1");
+    CHECK(units(uint256(123), 0) == "123");
+    CHECK(units(uint256(100), 2) == "1");
+    CHECK(units(uint256::max(), 18) == "115792089237316195423570985008687907853269984665640564039457.584007913129639935");
+
+    char small[2];   // "1.5" needs 3
+    CHECK(format_units(small, small + sizeof(small), uint256(1500000), 6).ec == std::errc::value_too_large);
+    // Round trip through parse_units.
+    CHECK(uint256::parse_units(units(uint256(123456789), 4), 4) == uint256(123456789));
+}
+
+int main() {
+    divmod_known();
+    divmod_sweep();
+    parsing();
+    parsing_units();
+    formatting_units();
+    return check_result();
+}
@@ -0,0 +1,313 @@
+/*
+ * File:        tx_tracker.cpp
+ * Created on:  2026-10-17
+ * Description: Central pending-transaction tracker (see tx_tracker.hpp).
+ */
+
+#include "tx_tracker.hpp"
+#include "hex_codec.hpp"
+#include "json_extract.hpp"
+#include "log.hpp"
+#include "rpc_arena.hpp"
+#include "rpc_batch.hpp"
+#include "rpc_metrics.hpp"
+#include "rpc_template.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// -----------------------------------------------------------------------------
+// TimerWheel
+// -----------------------------------------------------------------------------
+TimerWheel::TimerWheel(size_t slots, std::chrono::milliseconds tick)
+    : slots_(std::max<size_t>(1, slots)), tick_(std::max(tick, std::chrono::milliseconds(1))),
+      last_(std::chrono::steady_clock::now()) {}
+
+void TimerWheel::schedule(uint64_t key, std::chrono::milliseconds delay) {
+    uint64_t ticks = (uint64_t)std::max<int64_t>(1, (delay.count() + tick_.count() - 1) / tick_.count());
+    size_t n = slots_.size();
+    slots_[(cursor_ + ticks) % n].push_back({key, (ticks - 1) / n});
+}
+
+void TimerWheel::advance(std::chrono::steady_clock::time_point now, const std::function<void(uint64_t)>& fn) {
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_).count() / tick_.count();
+    if (elapsed <= 0) return;
+    last_ += tick_ * elapsed;
+
+    for (int64_t t = 0; t < elapsed; ++t) {
+        cursor_ = (cursor_ + 1) % slots_.size();
+        std::vector<Entry>& slot = slots_[cursor_];
+        size_t keep = 0;
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (slot[i].rounds == 0) {
+                fn(slot[i].key);
+            } else {
+                --slot[i].rounds;
+                slot[keep++] = slot[i];
+            }
+        }
+        slot.resize(keep);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// TxTracker: registration (any thread)
+// -----------------------------------------------------------------------------
+TxTracker::TxTracker(RpcClient& client, HeadSubscriber* heads, TxTrackerOptions opts)
+    : client_(client), heads_(heads), opts_(opts), wheel_(opts.wheel_slots, opts.tick) {
+    if (heads_) {
+        head_listener_ = heads_->on_head([this](const nlohmann::json& head) {
+            if (!head.contains("number")) return;
+            std::optional<uint64_t> number = json_quantity_of(head["number"]);
+            if (!number) return;
+            std::lock_guard<std::mutex> lock(mu_);
+            head_hint_ = std::max(head_hint_, *number);
+            cv_.notify_one();
+        });
+    }
+    thread_ = std::thread(&TxTracker::run, this);
+}
+
+TxTracker::~TxTracker() {
+    if (heads_) heads_->remove_head_listener(head_listener_);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+
+    // Nothing will resolve these any more.
+    RpcMetrics::global().counters().pending_txs.sub(pending_.size());
+    for (auto& kv : pending_) {
+        for (auto& cb : kv.second.waiters) cb(std::nullopt);
+    }
+}
+
+// Every request the tracker makes is on behalf of pending receipts.
+void TxTracker::add_requests(uint64_t n) {
+    requests_.fetch_add(n);
+    RpcMetrics::global().counters().receipt_polls_tracker.add(n);
+}
+
+void TxTracker::track(const Hash32& hash, ReceiptCallback cb,
+                      std::optional<std::chrono::milliseconds> timeout) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = pending_.find(hash);
+    if (it != pending_.end()) {
+        it->second.waiters.push_back(std::move(cb));   // first registration's timeout wins
+        return;
+    }
+    Pending& p = pending_[hash];
+    RpcMetrics::global().counters().pending_txs.add();
+    p.key = next_key_++;
+    p.waiters.push_back(std::move(cb));
+    by_key_[p.key] = hash;
+    wheel_.schedule(p.key, timeout.value_or(opts_.default_timeout));
+    unchecked_.push_back(hash);
+    cv_.notify_one();
+}
+
+std::future<nlohmann::json> TxTracker::track(const Hash32& txhash,
+                                             std::optional<std::chrono::milliseconds> timeout) {
+    auto done = std::make_shared<std::promise<nlohmann::json>>();
+    std::future<nlohmann::json> fut = done->get_future();
+    track(txhash, [done](std::optional<nlohmann::json> rcpt) {
+        if (rcpt) {
+            done->set_value(std::move(*rcpt));
+        } else {
+            done->set_exception(std::make_exception_ptr(std::runtime_error("timeout waiting for receipt")));
+        }
+    }, timeout);
+    return fut;
+}
+
+void TxTracker::track(std::string_view txhash, ReceiptCallback cb,
+                      std::optional<std::chrono::milliseconds> timeout) {
+    std::optional<Hash32> hash = Hash32::from_hex(txhash);
+    if (!hash) {
+        LOG_EVENT(LogLevel::Error, "tx.track").str("error", "not a transaction hash").str("tx", txhash);
+        cb(std::nullopt);
+        return;
+    }
+    track(*hash, std::move(cb), timeout);
+}
+
+std::future<nlohmann::json> TxTracker::track(std::string_view txhash,
+                                             std::optional<std::chrono::milliseconds> timeout) {
+    std::optional<Hash32> hash = Hash32::from_hex(txhash);
+    if (!hash) {
+        std::promise<nlohmann::json> bad;
+        bad.set_exception(std::make_exception_ptr(std::invalid_argument("not a transaction hash: " + std::string(txhash))));
+        return bad.get_future();
+    }
+    return track(*hash, timeout);
+}
+
+size_t TxTracker::pending() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return pending_.size();
+}
+
+// -----------------------------------------------------------------------------
+// Tracker thread
+// -----------------------------------------------------------------------------
+void TxTracker::run() {
+    auto next_poll = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!stop_) {
+        cv_.wait_for(lock, opts_.tick);
+        if (stop_) break;
+
+        // Timeouts first, so an expired tx is never resolved late.
+        std::vector<ReceiptCallback> expired;
+        wheel_.advance(std::chrono::steady_clock::now(), [&](uint64_t key) {
+            auto k = by_key_.find(key);
+            if (k == by_key_.end()) return;   // already resolved
+            auto p = pending_.find(k->second);
+            if (p != pending_.end()) {
+                for (auto& cb : p->second.waiters) expired.push_back(std::move(cb));
+                pending_.erase(p);
+                RpcMetrics::global().counters().pending_txs.sub();
+            }
+            by_key_.erase(k);
+        });
+
+        bool idle = pending_.empty();
+        uint64_t hint = head_hint_;
+        std::vector<Hash32> fresh;
+        fresh.swap(unchecked_);
+        lock.unlock();
+
+        for (auto& cb : expired) cb(std::nullopt);
+
+        if (idle) {
+            last_block_ = 0;   // resume from the tip once something registers again
+            lock.lock();
+            continue;
+        }
+
+        // Current tip: pushed by the subscriber, else polled on an interval.
+        std::optional<uint64_t> tip;
+        bool pushed = heads_ && heads_->connected() && hint > 0;
+        auto now = std::chrono::steady_clock::now();
+        if (pushed) {
+            tip = hint;
+        } else if (now >= next_poll || last_block_ == 0) {
+            uint64_t seen = last_block_;
+            tip = fetch_block_number();
+            if (tip && opts_.clock) opts_.clock->observe_tip(*tip);
+            empty_polls_ = (tip && *tip > seen) ? 1 : empty_polls_ + 1;
+            next_poll = now + (opts_.poll_policy ? opts_.poll_policy->next_delay(empty_polls_)
+                                                 : opts_.block_poll_interval);
+        }
+
+        if (tip && last_block_ == 0) last_block_ = *tip;
+        // Registered since the last cycle: may already be mined in an older block.
+        if (!fresh.empty()) check_by_hash(fresh);
+        if (tip && *tip > last_block_) process_blocks(last_block_ + 1, *tip);
+
+        lock.lock();
+    }
+}
+
+std::optional<uint64_t> TxTracker::fetch_block_number() {
+    static const RpcTemplate kBlockNumber("eth_blockNumber");
+    thread_local std::string body;
+    add_requests(1);
+    ArenaScope arena;
+    std::pmr::string response(arena.resource());
+    return rpc_result_quantity(client_.post(kBlockNumber.render(body, next_id_++), response));
+}
+
+void TxTracker::process_blocks(uint64_t from, uint64_t to) {
+    if (!block_receipts_supported_ || to - from + 1 > opts_.max_catch_up_blocks) {
+        // One batched lookup over everything still pending covers the whole gap.
+        std::vector<Hash32> all;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            for (auto& kv : pending_) all.push_back(kv.first);
+        }
+        check_by_hash(all);
+        last_block_ = to;
+        return;
+    }
+    for (uint64_t n = from; n <= to; ++n) {
+        if (!process_block(n)) {
+            if (!block_receipts_supported_) process_blocks(n, to);
+            return;   // block not served yet: retry from n next cycle
+        }
+        last_block_ = n;
+    }
+}
+
+bool TxTracker::process_block(uint64_t number) {
+    static const RpcTemplate kBlockReceipts("eth_getBlockReceipts", R"(["$0"])");
+    thread_local std::string body;
+    add_requests(1);
+    // Receipts are streamed: each one is checked as soon as it has arrived,
+    // and only those for our own transactions are materialized.
+    // The parser only delimits elements: one that is not a JSON object is
+    // looked up again by hash rather than handed to waiters.
+    std::vector<Hash32> unreadable;
+    RpcStreamParser stream([this, &unreadable](std::string_view rcpt) {
+        std::optional<std::string_view> field = json_member(rcpt, "transactionHash");
+        std::optional<Hash32> hash = field ? json_hash(*field) : std::nullopt;
+        if (!hash) return;
+        bool wanted;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            wanted = pending_.count(*hash) > 0;
+        }
+        if (!wanted) return;
+        nlohmann::json receipt = nlohmann::json::parse(rcpt.begin(), rcpt.end(), nullptr, false);
+        if (receipt.is_object()) {
+            resolve(*hash, std::move(receipt));
+        } else {
+            unreadable.push_back(*hash);
+        }
+    });
+    bool sent = client_.post_stream(kBlockReceipts.render(body, next_id_++, {RpcArg::quantity(number)}), stream);
+    check_by_hash(unreadable);
+    if (!sent) return false;
+    if (!stream.error().empty()) {
+        nlohmann::json err = nlohmann::json::parse(stream.error().begin(), stream.error().end(), nullptr, false);
+        if (!err.is_object()) return false;
+        int code = err.value("code", 0);
+        std::string msg = to_lower_ascii(err.value("message", ""));
+        if (code == -32601 || msg.find("not found") != std::string::npos ||
+            msg.find("not supported") != std::string::npos || msg.find("does not exist") != std::string::npos) {
+            LOG_EVENT(LogLevel::Warn, "tx.block_receipts").str("fallback", "batched eth_getTransactionReceipt");
+            block_receipts_supported_ = false;
+        }
+        return false;
+    }
+    return stream.streamed();   // null: node has not seen the block yet
+}
+
+void TxTracker::check_by_hash(const std::vector<Hash32>& hashes) {
+    if (hashes.empty()) return;
+    RpcBatch batch;
+    for (const auto& h : hashes) batch.add("eth_getTransactionReceipt", nlohmann::json::array({h.hex_string()}));
+    size_t limit = std::max<size_t>(1, client_.options().max_batch_size);   // as RpcBatch::send chunks
+    add_requests((hashes.size() + limit - 1) / limit);
+    rpc_call_batch(client_, batch);
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        const RpcResult& r = batch[i];
+        if (r.ok() && r.result->is_object()) resolve(hashes[i], *r.result);
+    }
+}
+
+void TxTracker::resolve(const Hash32& hash, std::optional<nlohmann::json> receipt) {
+    std::vector<ReceiptCallback> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = pending_.find(hash);
+        if (it == pending_.end()) return;
+        waiters.swap(it->second.waiters);
+        by_key_.erase(it->second.key);
+        pending_.erase(it);
+        RpcMetrics::global().counters().pending_txs.sub();
+    }
+    for (auto& cb : waiters) cb(receipt);
+}
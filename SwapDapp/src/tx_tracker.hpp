@@ -0,0 +1,142 @@
+/*
+ * File:        tx_tracker.hpp
+ * Created on:  2026-10-17
+ * Description: Central pending-transaction tracker. Any number of transactions
+ *              register with one TxTracker; for every new block it fetches that
+ *              block's receipts once (eth_getBlockReceipts, or one batched
+ *              eth_getTransactionReceipt over the pending set on nodes without it),
+ *              matches them against the pending hash set and resolves the waiters.
+ *              Cost is one request per block, not one per transaction per poll.
+ *
+ *              New blocks come from a HeadSubscriber when one is connected, else
+ *              from polling eth_blockNumber (paced by an optional PollPolicy).
+ *              Timeouts live on a hashed timer wheel.
+ */
+
+#pragma once
+
+#include "eth_types.hpp"
+#include "poll_policy.hpp"
+#include "rpc_client.hpp"
+#include "ws_transport.hpp"
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// TimerWheel: O(1) schedule/expire for many coarse timeouts
+// -----------------------------------------------------------------------------
+class TimerWheel {
+public:
+    TimerWheel(size_t slots, std::chrono::milliseconds tick);
+
+    // Schedules key to expire after delay (rounded up to whole ticks).
+    void schedule(uint64_t key, std::chrono::milliseconds delay);
+
+    // Advances to now and hands every expired key to fn. Cancelled keys are
+    // dropped lazily: fn is expected to ignore keys it no longer knows.
+    void advance(std::chrono::steady_clock::time_point now, const std::function<void(uint64_t)>& fn);
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t rounds;   // full revolutions still to go
+    };
+
+    std::vector<std::vector<Entry>> slots_;
+    std::chrono::milliseconds tick_;
+    size_t cursor_ = 0;
+    std::chrono::steady_clock::time_point last_;
+};
+
+// -----------------------------------------------------------------------------
+// TxTracker
+// -----------------------------------------------------------------------------
+struct TxTrackerOptions {
+    std::chrono::milliseconds default_timeout{120000};
+    std::chrono::milliseconds block_poll_interval{1000};   // used when no head subscription
+    const PollPolicy* poll_policy = nullptr;               // replaces block_poll_interval when set
+    BlockClock* clock = nullptr;                           // fed every polled tip when set
+    std::chrono::milliseconds tick{100};                   // timer wheel resolution
+    size_t wheel_slots = 1024;
+    uint64_t max_catch_up_blocks = 16;                     // beyond this, re-check pending by hash
+};
+
+class TxTracker {
+public:
+    // nullopt means the wait timed out.
+    using ReceiptCallback = std::function<void(std::optional<nlohmann::json>)>;
+
+    explicit TxTracker(RpcClient& client, HeadSubscriber* heads = nullptr, TxTrackerOptions opts = {});
+    ~TxTracker();
+
+    TxTracker(const TxTracker&) = delete;
+    TxTracker& operator=(const TxTracker&) = delete;
+
+    // Callback runs on the tracker thread and must not block.
+    void track(const Hash32& txhash, ReceiptCallback cb,
+               std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    // Future throws std::runtime_error on timeout.
+    std::future<nlohmann::json> track(const Hash32& txhash,
+                                      std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    // Hex hash as returned by the node. A malformed hash resolves at once
+    // with nullopt (the future throws std::invalid_argument).
+    void track(std::string_view txhash, ReceiptCallback cb,
+               std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+    std::future<nlohmann::json> track(std::string_view txhash,
+                                      std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    size_t pending() const;
+    uint64_t requests_sent() const { return requests_.load(); }
+
+private:
+    struct Pending {
+        uint64_t key = 0;
+        std::vector<ReceiptCallback> waiters;
+    };
+
+    void run();
+    std::optional<uint64_t> fetch_block_number();
+    void process_blocks(uint64_t from, uint64_t to);
+    bool process_block(uint64_t number);
+    void check_by_hash(const std::vector<Hash32>& hashes);
+    void resolve(const Hash32& hash, std::optional<nlohmann::json> receipt);
+    void add_requests(uint64_t n);
+
+    RpcClient& client_;
+    HeadSubscriber* heads_;
+    uint64_t head_listener_ = 0;
+    TxTrackerOptions opts_;
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::unordered_map<Hash32, Pending> pending_;         // tx hash -> waiters
+    std::unordered_map<uint64_t, Hash32> by_key_;         // timer key -> hash
+    std::vector<Hash32> unchecked_;                       // registered since the last cycle
+    TimerWheel wheel_;
+    uint64_t next_key_ = 1;
+    uint64_t head_hint_ = 0;                              // newest block pushed by the subscriber
+
+    uint64_t last_block_ = 0;                             // tracker thread only
+    bool block_receipts_supported_ = true;                // tracker thread only
+    int empty_polls_ = 0;                                 // tracker thread only: polls since the tip moved
+    int next_id_ = 1;                                     // tracker thread only
+
+    std::atomic<uint64_t> requests_{0};
+    bool stop_ = false;
+    std::thread thread_;
+};
@@ -0,0 +1,147 @@
+/*
+ * File:        uint256.cpp
+ * Created on:  2026-10-17
+ * Description: uint256 parsing and formatting (see uint256.hpp).
+ */
+
+#include "uint256.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Largest power of ten in 64 bits: decimal conversion works 19 digits at a time.
+static constexpr uint64_t kChunk = 10000000000000000000ull;
+static constexpr unsigned kChunkDigits = 19;
+
+// -----------------------------------------------------------------------------
+// Parsing
+// -----------------------------------------------------------------------------
+std::optional<uint256> uint256::from_hex(std::string_view s) {
+    // parse_word strips the prefix itself; stripping it here too would let
+    // "0x0x12" through. Only the emptiness check looks past it.
+    bool prefixed = s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X');
+    if (s.size() == (prefixed ? 2u : 0u)) return std::nullopt;
+    std::optional<Bytes32> word = parse_word(s);
+    if (!word) return std::nullopt;
+    return from_word(*word);
+}
+
+std::optional<uint256> uint256::from_dec(std::string_view s) {
+    if (s.empty()) return std::nullopt;
+    uint256 v;
+    while (!s.empty()) {
+        size_t take = std::min<size_t>(s.size(), kChunkDigits);
+        uint64_t chunk = 0, scale = 1;
+        for (size_t i = 0; i < take; ++i) {
+            char c = s[i];
+            if (c < '0' || c > '9') return std::nullopt;
+            chunk = chunk * 10 + (uint64_t)(c - '0');
+            scale *= 10;
+        }
+        s.remove_prefix(take);
+        if (mul_overflow(v, uint256(scale), v) || add_overflow(v, uint256(chunk), v)) return std::nullopt;
+    }
+    return v;
+}
+
+std::optional<uint256> uint256::parse(std::string_view s) {
+    if (s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) return from_hex(s);
+    return from_dec(s);
+}
+
+std::optional<uint256> uint256::parse_units(std::string_view s, unsigned decimals) {
+    if (decimals > 77) return std::nullopt;
+    size_t dot = s.find('.');
+    std::string_view whole = s.substr(0, dot);
+    std::string_view frac = dot == std::string_view::npos ? std::string_view() : s.substr(dot + 1);
+    while (!frac.empty() && frac.back() == '0') frac.remove_suffix(1);
+    if (frac.size() > decimals || (whole.empty() && frac.empty())) return std::nullopt;
+
+    uint256 w, f;
+    if (!whole.empty()) {
+        std::optional<uint256> p = from_dec(whole);
+        if (!p) return std::nullopt;
+        w = *p;
+    }
+    if (!frac.empty()) {
+        std::optional<uint256> p = from_dec(frac);
+        if (!p) return std::nullopt;
+        f = *p * pow10_u256(decimals - (unsigned)frac.size());
+    }
+    uint256 out;
+    if (mul_overflow(w, pow10_u256(decimals), out) || add_overflow(out, f, out)) return std::nullopt;
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Formatting
+// -----------------------------------------------------------------------------
+// Decimal digits into the tail of buf[78]; returns the first written index.
+static size_t dec_digits(char (&buf)[78], uint256 v) {
+    size_t pos = sizeof(buf);
+    do {
+        uint64_t chunk = v.divmod_u64(kChunk);
+        // Every chunk but the most significant is zero-padded to 19 digits.
+        unsigned n = 0;
+        do {
+            buf[--pos] = (char)('0' + chunk % 10);
+            chunk /= 10;
+            ++n;
+        } while (chunk || (!v.is_zero() && n < kChunkDigits));
+    } while (!v.is_zero());
+    return pos;
+}
+
+std::to_chars_result to_chars(char* first, char* last, const uint256& v, int base) {
+    char buf[78];
+    size_t pos = sizeof(buf);
+    if (base == 16) {
+        char word[64];
+        Bytes32 be = v.to_word();
+        hex_encode(word, be.data(), be.size());
+        size_t lead = 0;
+        while (lead < 63 && word[lead] == '0') ++lead;
+        pos = 14 + lead;   // buf holds 78, the hex digits occupy the last 64
+        std::memcpy(buf + 14, word, sizeof(word));
+    } else {
+        pos = dec_digits(buf, v);
+    }
+    size_t len = sizeof(buf) - pos;
+    if ((size_t)(last - first) < len) return {last, std::errc::value_too_large};
+    std::memcpy(first, buf + pos, len);
+    return {first + len, std::errc()};
+}
+
+std::to_chars_result format_units(char* first, char* last, const uint256& v, unsigned decimals) {
+    char buf[78];
+    size_t pos = dec_digits(buf, v);
+    size_t len = sizeof(buf) - pos;
+    std::string_view digits(buf + pos, len);
+
+    // Integer part (at least "0"), then the fraction with trailing zeros dropped.
+    std::string_view whole = len > decimals ? digits.substr(0, len - decimals) : std::string_view("0");
+    std::string_view frac = len > decimals ? digits.substr(len - decimals) : digits;
+    size_t fracZeros = len > decimals ? 0 : decimals - len;   // leading zeros of the fraction
+    while (!frac.empty() && frac.back() == '0') frac.remove_suffix(1);
+    if (frac.empty()) fracZeros = 0;
+
+    size_t need = whole.size() + (frac.empty() ? 0 : 1 + fracZeros + frac.size());
+    if ((size_t)(last - first) < need) return {last, std::errc::value_too_large};
+    char* out = std::copy(whole.begin(), whole.end(), first);
+    if (!frac.empty()) {
+        *out++ = '.';
+        out = std::fill_n(out, fracZeros, '0');
+        out = std::copy(frac.begin(), frac.end(), out);
+    }
+    return {out, std::errc()};
+}
+
+std::string to_string(const uint256& v) {
+    char buf[78];
+    return std::string(buf, to_chars(buf, buf + sizeof(buf), v).ptr);
+}
+
+std::string to_quantity(const uint256& v) {
+    char buf[66] = {'0', 'x'};
+    return std::string(buf, to_chars(buf + 2, buf + sizeof(buf), v, 16).ptr);
+}
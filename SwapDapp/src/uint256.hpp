@@ -0,0 +1,307 @@
+/*
+ * File:        uint256.hpp
+ * Created on:  2026-10-17
+ * Description: Fixed-width 256-bit unsigned integer for token amounts,
+ *              allowances and balances. Four 64-bit limbs on the stack, no
+ *              heap: an 18-decimal balance or a max-uint allowance compares
+ *              exactly instead of being truncated to 64 bits.
+ *
+ *              Arithmetic wraps modulo 2^256 like Solidity's unchecked math;
+ *              add_overflow / sub_overflow / mul_overflow report the wrap.
+ *              Division by zero yields zero (as the EVM's DIV and MOD do).
+ *              Arithmetic is constexpr and header-only. Parsing and the
+ *              to_chars-style formatting live in uint256.cpp.
+ */
+
+#pragma once
+
+#include "hex_codec.hpp"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+class uint256 {
+public:
+    constexpr uint256() = default;
+    constexpr uint256(uint64_t v) : w_{v, 0, 0, 0} {}   // implicit: amounts start as literals
+
+    // Limbs least significant first.
+    static constexpr uint256 from_limbs(uint64_t l0, uint64_t l1, uint64_t l2, uint64_t l3) {
+        uint256 r;
+        r.w_ = {l0, l1, l2, l3};
+        return r;
+    }
+    static constexpr uint256 max() { return from_limbs(~0ull, ~0ull, ~0ull, ~0ull); }
+
+    // Big-endian 32-byte word, as in ABI encoding and eth_call results.
+    static constexpr uint256 from_word(const Bytes32& be) {
+        uint256 r;
+        for (size_t i = 0; i < 32; ++i) r.w_[3 - i / 8] |= (uint64_t)be[i] << (8 * (7 - i % 8));
+        return r;
+    }
+    constexpr Bytes32 to_word() const {
+        Bytes32 be{};
+        for (size_t i = 0; i < 32; ++i) be[i] = (uint8_t)(w_[3 - i / 8] >> (8 * (7 - i % 8)));
+        return be;
+    }
+
+    // "0x"-prefixed (or bare) hex, at most 64 significant digits.
+    static std::optional<uint256> from_hex(std::string_view s);
+    // Plain decimal digits; nullopt above 2^256 - 1.
+    static std::optional<uint256> from_dec(std::string_view s);
+    // Hex with a "0x" prefix, decimal otherwise.
+    static std::optional<uint256> parse(std::string_view s);
+    // Decimal token amount scaled by 10^decimals: ("1.5", 6) -> 1500000.
+    // nullopt on more fractional digits than decimals, or on overflow.
+    static std::optional<uint256> parse_units(std::string_view s, unsigned decimals);
+
+    constexpr uint64_t limb(size_t i) const { return w_[i]; }
+    constexpr bool fits_u64() const { return (w_[1] | w_[2] | w_[3]) == 0; }
+    constexpr uint64_t low_u64() const { return w_[0]; }
+    constexpr bool is_zero() const { return (w_[0] | w_[1] | w_[2] | w_[3]) == 0; }
+    constexpr explicit operator bool() const { return !is_zero(); }
+    // Index of the highest set bit + 1; 0 for zero.
+    constexpr unsigned bit_width() const {
+        for (int i = 3; i >= 0; --i) {
+            if (w_[i]) return (unsigned)(64 * i) + (unsigned)std::bit_width(w_[i]);
+        }
+        return 0;
+    }
+
+    // -------------------------------------------------------------------------
+    // Comparison
+    // -------------------------------------------------------------------------
+    friend constexpr bool operator==(const uint256& a, const uint256& b) = default;
+    friend constexpr std::strong_ordering operator<=>(const uint256& a, const uint256& b) {
+        for (int i = 3; i >= 0; --i) {
+            if (a.w_[i] != b.w_[i]) return a.w_[i] <=> b.w_[i];
+        }
+        return std::strong_ordering::equal;
+    }
+
+    // -------------------------------------------------------------------------
+    // Add / subtract
+    // -------------------------------------------------------------------------
+    friend constexpr bool add_overflow(const uint256& a, const uint256& b, uint256& out) {
+        unsigned __int128 carry = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            carry += (unsigned __int128)a.w_[i] + b.w_[i];
+            out.w_[i] = (uint64_t)carry;
+            carry >>= 64;
+        }
+        return carry != 0;
+    }
+    friend constexpr bool sub_overflow(const uint256& a, const uint256& b, uint256& out) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            uint64_t d = a.w_[i] - b.w_[i];
+            uint64_t nb = (a.w_[i] < b.w_[i]) | (d < borrow);
+            out.w_[i] = d - borrow;
+            borrow = nb;
+        }
+        return borrow != 0;
+    }
+    friend constexpr uint256 operator+(uint256 a, const uint256& b) { add_overflow(a, b, a); return a; }
+    friend constexpr uint256 operator-(uint256 a, const uint256& b) { sub_overflow(a, b, a); return a; }
+    constexpr uint256& operator+=(const uint256& b) { add_overflow(*this, b, *this); return *this; }
+    constexpr uint256& operator-=(const uint256& b) { sub_overflow(*this, b, *this); return *this; }
+
+    // -------------------------------------------------------------------------
+    // Multiply
+    // -------------------------------------------------------------------------
+    // Full schoolbook product; true if it does not fit in 256 bits.
+    friend constexpr bool mul_overflow(const uint256& a, const uint256& b, uint256& out) {
+        uint64_t r[8] = {};
+        for (size_t i = 0; i < 4; ++i) {
+            if (!a.w_[i]) continue;
+            unsigned __int128 carry = 0;
+            for (size_t j = 0; j < 4; ++j) {
+                carry += (unsigned __int128)a.w_[i] * b.w_[j] + r[i + j];
+                r[i + j] = (uint64_t)carry;
+                carry >>= 64;
+            }
+            r[i + 4] = (uint64_t)carry;
+        }
+        out.w_ = {r[0], r[1], r[2], r[3]};
+        return (r[4] | r[5] | r[6] | r[7]) != 0;
+    }
+    friend constexpr uint256 operator*(const uint256& a, const uint256& b) {
+        // Truncated product: only limbs below 2^256 are computed.
+        uint256 out;
+        for (size_t i = 0; i < 4; ++i) {
+            unsigned __int128 carry = 0;
+            for (size_t j = 0; i + j < 4; ++j) {
+                carry += (unsigned __int128)a.w_[i] * b.w_[j] + out.w_[i + j];
+                out.w_[i + j] = (uint64_t)carry;
+                carry >>= 64;
+            }
+        }
+        return out;
+    }
+    constexpr uint256& operator*=(const uint256& b) { return *this = *this * b; }
+
+    // -------------------------------------------------------------------------
+    // Divide
+    // -------------------------------------------------------------------------
+    struct DivMod;
+    static constexpr DivMod divmod(const uint256& u, const uint256& v);
+
+    // Fast path for a 64-bit divisor (decimal formatting, token scaling):
+    // *this becomes the quotient, the remainder is returned.
+    constexpr uint64_t divmod_u64(uint64_t d) {
+        if (d == 0) {
+            *this = uint256();
+            return 0;
+        }
+        unsigned __int128 rem = 0;
+        for (int i = 3; i >= 0; --i) {
+            unsigned __int128 cur = (rem << 64) | w_[i];
+            w_[i] = (uint64_t)(cur / d);
+            rem = cur % d;
+        }
+        return (uint64_t)rem;
+    }
+
+    friend constexpr uint256 operator/(const uint256& a, const uint256& b);
+    friend constexpr uint256 operator%(const uint256& a, const uint256& b);
+    constexpr uint256& operator/=(const uint256& b);
+    constexpr uint256& operator%=(const uint256& b);
+
+    // -------------------------------------------------------------------------
+    // Bitwise
+    // -------------------------------------------------------------------------
+    friend constexpr uint256 operator&(uint256 a, const uint256& b) { for (size_t i = 0; i < 4; ++i) a.w_[i] &= b.w_[i]; return a; }
+    friend constexpr uint256 operator|(uint256 a, const uint256& b) { for (size_t i = 0; i < 4; ++i) a.w_[i] |= b.w_[i]; return a; }
+    friend constexpr uint256 operator^(uint256 a, const uint256& b) { for (size_t i = 0; i < 4; ++i) a.w_[i] ^= b.w_[i]; return a; }
+    friend constexpr uint256 operator~(uint256 a) { for (auto& w : a.w_) w = ~w; return a; }
+
+    friend constexpr uint256 operator<<(const uint256& a, unsigned n) {
+        uint256 r;
+        if (n >= 256) return r;
+        unsigned limbs = n / 64, bits = n % 64;
+        for (int i = 3; i >= (int)limbs; --i) {
+            uint64_t v = a.w_[i - limbs] << bits;
+            if (bits && i > (int)limbs) v |= a.w_[i - limbs - 1] >> (64 - bits);
+            r.w_[i] = v;
+        }
+        return r;
+    }
+    friend constexpr uint256 operator>>(const uint256& a, unsigned n) {
+        uint256 r;
+        if (n >= 256) return r;
+        unsigned limbs = n / 64, bits = n % 64;
+        for (unsigned i = 0; i + limbs < 4; ++i) {
+            uint64_t v = a.w_[i + limbs] >> bits;
+            if (bits && i + limbs + 1 < 4) v |= a.w_[i + limbs + 1] << (64 - bits);
+            r.w_[i] = v;
+        }
+        return r;
+    }
+
+private:
+    std::array<uint64_t, 4> w_{};
+};
+
+struct uint256::DivMod {
+    uint256 quot;
+    uint256 rem;
+};
+
+// Knuth, TAOCP vol. 2, 4.3.1 Algorithm D on 64-bit limbs, with 128-bit
+// intermediates (layout follows Hacker's Delight divmnu).
+constexpr uint256::DivMod uint256::divmod(const uint256& u, const uint256& v) {
+    if (v.is_zero()) return {};
+    if (u < v) return {uint256(), u};
+    if (v.fits_u64()) {
+        uint256 q = u;
+        uint64_t r = q.divmod_u64(v.w_[0]);
+        return {q, uint256(r)};
+    }
+
+    int n = 4, m = 4;
+    while (v.w_[n - 1] == 0) --n;
+    while (u.w_[m - 1] == 0) --m;
+
+    // Normalize so the divisor's top limb has its high bit set.
+    unsigned s = (unsigned)std::countl_zero(v.w_[n - 1]);
+    uint64_t vn[4] = {}, un[5] = {};
+    for (int i = n - 1; i > 0; --i) vn[i] = (v.w_[i] << s) | (s ? v.w_[i - 1] >> (64 - s) : 0);
+    vn[0] = v.w_[0] << s;
+    un[m] = s ? u.w_[m - 1] >> (64 - s) : 0;
+    for (int i = m - 1; i > 0; --i) un[i] = (u.w_[i] << s) | (s ? u.w_[i - 1] >> (64 - s) : 0);
+    un[0] = u.w_[0] << s;
+
+    constexpr unsigned __int128 kBase = (unsigned __int128)1 << 64;
+    uint256 q;
+    for (int j = m - n; j >= 0; --j) {
+        unsigned __int128 num = ((unsigned __int128)un[j + n] << 64) | un[j + n - 1];
+        unsigned __int128 qhat = num / vn[n - 1];
+        unsigned __int128 rhat = num % vn[n - 1];
+        while (qhat >= kBase || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= kBase) break;
+        }
+
+        // un[j .. j+n] -= qhat * vn
+        __int128 borrow = 0, t = 0;
+        for (int i = 0; i < n; ++i) {
+            unsigned __int128 p = qhat * vn[i];
+            t = (__int128)un[i + j] - borrow - (__int128)(uint64_t)p;
+            un[i + j] = (uint64_t)t;
+            borrow = (__int128)(uint64_t)(p >> 64) - (t >> 64);
+        }
+        t = (__int128)un[j + n] - borrow;
+        un[j + n] = (uint64_t)t;
+
+        q.w_[j] = (uint64_t)qhat;
+        if (t < 0) {   // qhat was one too large: add the divisor back
+            --q.w_[j];
+            unsigned __int128 carry = 0;
+            for (int i = 0; i < n; ++i) {
+                carry += (unsigned __int128)un[i + j] + vn[i];
+                un[i + j] = (uint64_t)carry;
+                carry >>= 64;
+            }
+            un[j + n] += (uint64_t)carry;
+        }
+    }
+
+    uint256 r;
+    for (int i = 0; i < n; ++i) r.w_[i] = (un[i] >> s) | (s ? un[i + 1] << (64 - s) : 0);
+    return {q, r};
+}
+
+constexpr uint256 operator/(const uint256& a, const uint256& b) { return uint256::divmod(a, b).quot; }
+constexpr uint256 operator%(const uint256& a, const uint256& b) { return uint256::divmod(a, b).rem; }
+constexpr uint256& uint256::operator/=(const uint256& b) { return *this = *this / b; }
+constexpr uint256& uint256::operator%=(const uint256& b) { return *this = *this % b; }
+
+// 10^n for n <= 77 (the largest power of ten below 2^256).
+constexpr uint256 pow10_u256(unsigned n) {
+    uint256 r(1);
+    for (unsigned i = 0; i < n; ++i) r *= uint256(10);
+    return r;
+}
+
+// -----------------------------------------------------------------------------
+// Formatting (no allocation)
+// -----------------------------------------------------------------------------
+// Like std::to_chars: base 10 or 16, lower-case, no prefix, no padding.
+// Writes at most 78 (base 10) or 64 (base 16) chars.
+std::to_chars_result to_chars(char* first, char* last, const uint256& v, int base = 10);
+
+// Token amount with the decimal point placed `decimals` digits from the right,
+// trailing fractional zeros dropped: (1500000, 6) -> "1.5", (1, 18) -> "0.000000000000000001".
+std::to_chars_result format_units(char* first, char* last, const uint256& v, unsigned decimals);
+
+std::string to_string(const uint256& v);
+// "0x"-prefixed JSON-RPC quantity: 0 -> "0x0".
+std::string to_quantity(const uint256& v);
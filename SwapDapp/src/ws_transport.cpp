@@ -0,0 +1,252 @@
+/*
+ * File:        ws_transport.cpp
+ * Created on:  2026-10-17
+ * Description: WebSocket transport for push-based chain events (see ws_transport.hpp).
+ */
+
+#include "ws_transport.hpp"
+#include "log.hpp"
+
+#include <poll.h>
+#include <algorithm>
+#include <future>
+
+// -----------------------------------------------------------------------------
+// WsConnection
+// -----------------------------------------------------------------------------
+// A peer that has not drained our send buffer for this long is treated as gone.
+static constexpr int kSendTimeoutMs = 5000;
+
+bool WsConnection::open(const std::string& url, long connect_timeout_ms) {
+    close();
+    curl_ = curl_easy_init();
+    if (!curl_) {
+        LOG_EVENT(LogLevel::Error, "ws.init").str("error", "curl_easy_init failed");
+        return false;
+    }
+    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl_, CURLOPT_CONNECT_ONLY, 2L);   // WebSocket upgrade, then hand over
+    curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT_MS, connect_timeout_ms);
+    curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L);
+
+    CURLcode res = curl_easy_perform(curl_);
+    if (res != CURLE_OK) {
+        LOG_EVENT(LogLevel::Error, "ws.connect").str("url", url).str("error", curl_easy_strerror(res));
+        close();
+        return false;
+    }
+    return true;
+}
+
+void WsConnection::close() {
+    if (curl_) {
+        size_t sent = 0;
+        curl_ws_send(curl_, "", 0, &sent, 0, CURLWS_CLOSE);
+        curl_easy_cleanup(curl_);
+        curl_ = nullptr;
+    }
+    partial_.clear();
+}
+
+bool WsConnection::send_text(const std::string& msg) {
+    if (!curl_) return false;
+    size_t off = 0;
+    while (off < msg.size()) {
+        size_t sent = 0;
+        CURLcode res = curl_ws_send(curl_, msg.data() + off, msg.size() - off, &sent, 0, CURLWS_TEXT);
+        if (res == CURLE_AGAIN) {
+            // Send buffer full: wait until the socket drains, not for input.
+            if (wait_writable(kSendTimeoutMs)) continue;
+            res = CURLE_SEND_ERROR;
+        }
+        if (res != CURLE_OK) {
+            LOG_EVENT(LogLevel::Error, "ws.send").str("error", curl_easy_strerror(res));
+            close();
+            return false;
+        }
+        off += sent;
+    }
+    return true;
+}
+
+bool WsConnection::wait_readable(int timeout_ms) {
+    return wait_socket(POLLIN, timeout_ms);
+}
+
+bool WsConnection::wait_writable(int timeout_ms) {
+    return wait_socket(POLLOUT, timeout_ms);
+}
+
+bool WsConnection::wait_socket(short events, int timeout_ms) {
+    curl_socket_t fd = CURL_SOCKET_BAD;
+    if (curl_easy_getinfo(curl_, CURLINFO_ACTIVESOCKET, &fd) != CURLE_OK || fd == CURL_SOCKET_BAD) {
+        return false;
+    }
+    pollfd p{};
+    p.fd = fd;
+    p.events = events;
+    return ::poll(&p, 1, timeout_ms) > 0;
+}
+
+std::optional<std::string> WsConnection::recv_text(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    char buf[16384];
+    while (curl_) {
+        size_t n = 0;
+        const curl_ws_frame* meta = nullptr;
+        CURLcode res = curl_ws_recv(curl_, buf, sizeof(buf), &n, &meta);
+        if (res == CURLE_AGAIN) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0 || !wait_readable((int)left)) return std::nullopt;
+            continue;
+        }
+        if (res != CURLE_OK || !meta) {
+            LOG_EVENT(LogLevel::Error, "ws.recv").str("error", curl_easy_strerror(res));
+            close();
+            return std::nullopt;
+        }
+        if (meta->flags & CURLWS_CLOSE) {
+            close();
+            return std::nullopt;
+        }
+        if (meta->flags & CURLWS_PING) continue;   // curl answers pings itself
+
+        partial_.append(buf, n);
+        // A message is complete when this frame is drained and no fragment follows.
+        if (meta->bytesleft == 0 && !(meta->flags & CURLWS_CONT)) {
+            std::string msg;
+            msg.swap(partial_);
+            return msg;
+        }
+    }
+    return std::nullopt;
+}
+
+// -----------------------------------------------------------------------------
+// HeadSubscriber
+// -----------------------------------------------------------------------------
+HeadSubscriber::HeadSubscriber(std::string ws_url) : url_(std::move(ws_url)) {
+    if (!url_.empty()) thread_ = std::thread(&HeadSubscriber::run, this);
+}
+
+HeadSubscriber::~HeadSubscriber() {
+    stop_.store(true);
+    if (thread_.joinable()) thread_.join();
+    expire_waiters(true);
+}
+
+uint64_t HeadSubscriber::on_head(HeadListener fn) {
+    std::lock_guard<std::mutex> lock(listeners_mu_);
+    uint64_t id = next_listener_++;
+    listeners_.emplace_back(id, std::move(fn));
+    return id;
+}
+
+void HeadSubscriber::remove_head_listener(uint64_t id) {
+    std::lock_guard<std::mutex> lock(listeners_mu_);
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                    [id](const auto& l) { return l.first == id; }),
+                     listeners_.end());
+}
+
+void HeadSubscriber::on_next_head(HeadWaiter fn, std::chrono::milliseconds timeout) {
+    if (!connected_.load()) {
+        fn(false);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    waiters_.push_back({std::chrono::steady_clock::now() + timeout, std::move(fn)});
+}
+
+bool HeadSubscriber::wait_next_head(std::chrono::milliseconds timeout) {
+    auto done = std::make_shared<std::promise<bool>>();
+    std::future<bool> fut = done->get_future();
+    on_next_head([done](bool got) { done->set_value(got); }, timeout);
+    return fut.get();
+}
+
+bool HeadSubscriber::subscribe(WsConnection& ws) {
+    nlohmann::json req = {
+        {"jsonrpc", "2.0"},
+        {"id", 1},
+        {"method", "eth_subscribe"},
+        {"params", nlohmann::json::array({"newHeads"})}
+    };
+    if (!ws.send_text(req.dump())) return false;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (ws.is_open() && std::chrono::steady_clock::now() < deadline) {
+        std::optional<std::string> msg = ws.recv_text(200);
+        if (!msg) continue;
+        nlohmann::json j = nlohmann::json::parse(*msg, nullptr, false);
+        if (j.is_discarded() || j.value("id", 0) != 1) continue;
+        if (j.contains("result") && j["result"].is_string()) {
+            sub_id_ = j["result"].get<std::string>();
+            return true;
+        }
+        LOG_EVENT(LogLevel::Error, "ws.subscribe").str("reply", *msg);
+        return false;
+    }
+    return false;
+}
+
+void HeadSubscriber::run() {
+    auto backoff = std::chrono::milliseconds(500);
+    while (!stop_.load()) {
+        WsConnection ws;
+        if (!ws.open(url_) || !subscribe(ws)) {
+            connected_.store(false);
+            expire_waiters(true);
+            auto until = std::chrono::steady_clock::now() + backoff;
+            while (!stop_.load() && std::chrono::steady_clock::now() < until) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            backoff = std::min(backoff * 2, std::chrono::milliseconds(30000));
+            continue;
+        }
+        backoff = std::chrono::milliseconds(500);
+        connected_.store(true);
+
+        while (!stop_.load() && ws.is_open()) {
+            std::optional<std::string> msg = ws.recv_text(100);
+            expire_waiters(false);
+            if (!msg) continue;
+
+            nlohmann::json j = nlohmann::json::parse(*msg, nullptr, false);
+            if (j.is_discarded() || j.value("method", "") != "eth_subscription") continue;
+            const nlohmann::json& params = j["params"];
+            if (!params.is_object() || params.value("subscription", "") != sub_id_) continue;
+            if (params.contains("result")) deliver(params["result"]);
+        }
+        connected_.store(false);
+        expire_waiters(true);   // anyone waiting falls back to polling
+    }
+}
+
+void HeadSubscriber::deliver(const nlohmann::json& head) {
+    heads_seen_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(listeners_mu_);
+        for (auto& l : listeners_) l.second(head);
+    }
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        waiters.swap(waiters_);
+    }
+    for (auto& w : waiters) w.fn(true);
+}
+
+void HeadSubscriber::expire_waiters(bool all) {
+    std::vector<Waiter> expired;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto now = std::chrono::steady_clock::now();
+        auto split = std::partition(waiters_.begin(), waiters_.end(),
+                                    [&](const Waiter& w) { return !all && w.deadline > now; });
+        expired.assign(std::make_move_iterator(split), std::make_move_iterator(waiters_.end()));
+        waiters_.erase(split, waiters_.end());
+    }
+    for (auto& w : expired) w.fn(false);
+}
@@ -0,0 +1,116 @@
+/*
+ * File:        ws_transport.hpp
+ * Created on:  2026-10-17
+ * Description: WebSocket transport for push-based chain events. HeadSubscriber
+ *              opens a ws:// or wss:// connection (curl WebSocket API), sends
+ *              eth_subscribe ["newHeads"] and delivers every new block header to
+ *              registered listeners and one-shot waiters. Receipt waits check
+ *              pending hashes only when a block arrives instead of polling on a
+ *              fixed timer.
+ *
+ *              When the socket is down, connected() is false, waiters are released
+ *              immediately and callers fall back to polling. The reader thread keeps
+ *              reconnecting with backoff. Point ETH_WS_URL at any local WS stand-in
+ *              that answers eth_subscribe to exercise it without a real node.
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// WsConnection: one text-frame WebSocket (not thread-safe; owned by one thread)
+// -----------------------------------------------------------------------------
+class WsConnection {
+public:
+    WsConnection() = default;
+    ~WsConnection() { close(); }
+
+    WsConnection(const WsConnection&) = delete;
+    WsConnection& operator=(const WsConnection&) = delete;
+
+    bool open(const std::string& url, long connect_timeout_ms = 5000);
+    void close();
+    bool is_open() const { return curl_ != nullptr; }
+
+    bool send_text(const std::string& msg);
+
+    // Waits up to timeout_ms for one complete text message. nullopt on timeout;
+    // on error or close the connection is closed (check is_open()).
+    std::optional<std::string> recv_text(int timeout_ms);
+
+private:
+    bool wait_readable(int timeout_ms);
+    bool wait_writable(int timeout_ms);
+    bool wait_socket(short events, int timeout_ms);
+
+    CURL* curl_ = nullptr;
+    std::string partial_;   // fragments of a message still being received
+};
+
+// -----------------------------------------------------------------------------
+// HeadSubscriber: eth_subscribe newHeads with reconnect
+// -----------------------------------------------------------------------------
+class HeadSubscriber {
+public:
+    using HeadListener = std::function<void(const nlohmann::json& head)>;
+    // true: a new head arrived; false: timed out or the socket is down.
+    using HeadWaiter = std::function<void(bool)>;
+
+    explicit HeadSubscriber(std::string ws_url);
+    ~HeadSubscriber();
+
+    HeadSubscriber(const HeadSubscriber&) = delete;
+    HeadSubscriber& operator=(const HeadSubscriber&) = delete;
+
+    bool connected() const { return connected_.load(); }
+    uint64_t heads_seen() const { return heads_seen_.load(); }
+
+    // Persistent listener, called on the reader thread for every head. Returns an
+    // id for remove_head_listener(); listeners must not (un)register themselves.
+    uint64_t on_head(HeadListener fn);
+
+    // After this returns the listener is not running and will not run again.
+    void remove_head_listener(uint64_t id);
+
+    // One-shot: fn fires on the next head, at timeout, or right away if the
+    // subscription is down. Runs on the reader thread (or the caller's, when down).
+    void on_next_head(HeadWaiter fn, std::chrono::milliseconds timeout);
+
+    // Blocking form of on_next_head.
+    bool wait_next_head(std::chrono::milliseconds timeout);
+
+private:
+    struct Waiter {
+        std::chrono::steady_clock::time_point deadline;
+        HeadWaiter fn;
+    };
+
+    void run();
+    bool subscribe(WsConnection& ws);
+    void deliver(const nlohmann::json& head);
+    void expire_waiters(bool all);
+
+    std::string url_;
+    std::mutex listeners_mu_;             // held while listeners run
+    std::vector<std::pair<uint64_t, HeadListener>> listeners_;
+    uint64_t next_listener_ = 1;
+    std::mutex mu_;                       // guards waiters_
+    std::vector<Waiter> waiters_;
+    std::string sub_id_;                  // reader thread only
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> heads_seen_{0};
+    std::thread thread_;
+};
@@ -1,4 +1,4 @@
-/* 
+/*
  * File:        main.cpp
  * Author:      Viachelsav Markov
  * Created on: 2025-08-16
@@ -6,9 +6,39 @@
  *              Builds ABI calldata to send ERC-20 approve, verifies allowance via
  *              eth_call, and submits swapExactInSingle to a deployed SwapExecutorV3,
  *              then polls transaction receipts with verbose debug logging.
+ *              The flow is a coroutine (swap_flow): it reads top to bottom like
+ *              blocking code, but every RPC and receipt wait suspends instead of
+ *              parking a thread, so many flows can share one engine and pool.
+ *              Approve and swap are pipelined when the node shows the approve
+ *              in its pending state: both take their nonces from a
+ *              NonceManager and go out back-to-back, then confirm together.
+ *              Nodes that answer "pending" from the latest block get the
+ *              approve mined first. The swap's gas is estimated against the
+ *              state that has the approve (SWAP_GAS_HEX if that fails).
+ *              With ETH_KEYSTORE (+ ETH_KEYSTORE_PASSWORD) set, txs are signed
+ *              locally and sent with eth_sendRawTransaction instead of relying on
+ *              the node's unlocked account.
  *              This code was Written by human using Copilot AI.
  */
 
+#include "rpc_async.hpp"
+#include "rpc_client.hpp"
+#include "metrics_server.hpp"
+#include "rpc_metrics.hpp"
+#include "abi.hpp"
+#include "eth_tx.hpp"
+#include "eth_types.hpp"
+#include "json_extract.hpp"
+#include "keystore.hpp"
+#include "nonce_manager.hpp"
+#include "poll_policy.hpp"
+#include "rpc_coro.hpp"
+#include "rpc_template.hpp"
+#include "tx_tracker.hpp"
+#include "uint256.hpp"
+#include "ws_transport.hpp"
+
+#include <algorithm>
 #include <iostream>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
@@ -16,307 +46,403 @@
 #include <optional>
 #include <thread>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Swap parameters for one flow
+struct SwapParams {
+    Address from;
+    Address executor;
+    Address tokenIn;
+    Address tokenOut;
+    std::string feeHex;
+    std::string amountInHex;
+    std::string minOutHex;
+    std::string swapGasHex;   // fallback when the swap cannot be estimated
+    std::string approveGasHex;
+    // Local signing (optional): unset means eth_sendTransaction on the node
+    const Secp256k1Key* signer = nullptr;
+    uint64_t chainId = 0;
+    FeeQuote fees;
+};
+
+// Contract ABI: selectors are computed from the signatures at compile time
+using Approve = abi::Function<"approve(address,uint256)">;
+using Allowance = abi::Function<"allowance(address,address)">;
+using SwapExactInSingle = abi::Function<"swapExactInSingle(address,address,uint24,uint256,uint256)">;
+
+// Encoded calldata for one flow
+struct SwapCalldata {
+    std::string approve;
+    std::string allowance;
+    std::string swap;
+    uint256 amountIn;
+};
+
+// One submitted tx, kept so it can be rebroadcast if the node drops it
+struct Submission {
+    const char* what;
+    uint64_t nonce;
+    Hash32 hash;
+    std::string method;
+    nlohmann::json params;
+};
 
 // Function prototypes
-nlohmann::json wait_receipt(const std::string& url, const std::string& txhash);
-std::string pad_to_32bytes(const std::string& input); // Helper to pad hex strings to 64 chars(32 bytes)
-size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* uploadedData);
-std::optional<std::string> rpc_call(const std::string& url, const nlohmann::json& j);
-static std::string strip0x(std::string s);
-static uint64_t hex_to_u64(std::string s);
+Task<int> swap_flow(CoroRpcClient& rpc, TxTracker& tracker, NonceManager& nonces, SwapParams p);
+static nlohmann::json tx_params(const Address& from, const Address& to, const std::string& data,
+                                uint64_t nonce, const char* gas = nullptr);
+static std::pair<std::string, nlohmann::json> send_request(const SwapParams& p, const Address& to,
+                                                           const std::string& data, uint64_t nonce,
+                                                           const std::string& gasHex);
+static Task<RpcResult> call_at(CoroRpcClient& rpc, const Address& to, const std::string& data, const char* tag);
+static Task<RpcResult> estimate_gas(CoroRpcClient& rpc, const Address& from, const Address& to,
+                                    const std::string& data, const char* tag);
+static Task<std::optional<nlohmann::json>> await_receipt(CoroRpcClient& rpc, TxTracker& tracker,
+                                                         NonceManager& nonces, const Address& from, Submission& s);
+static uint256 allowance_of(const RpcResult& r);
+static std::optional<SwapCalldata> build_calldata(const SwapParams& p);
+static std::optional<Hash32> result_hash(const RpcResult& r);
+static std::string to_hex(uint64_t v);
 
 // Main function
 int main() {
 
     curl_global_init(CURL_GLOBAL_DEFAULT);
     std::string url = "http://127.0.0.1:8545";
+    const char* ws = std::getenv("ETH_WS_URL");
+    std::string wsUrl = ws ? ws : ""; // newHeads push; empty: receipts are polled
     if(url.empty()){
         std::cerr << "Error::URL is empty\n";
         curl_global_cleanup();
         return 1;
     }
 
-    std::string from = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266"; // Wallet address
-    std::string executor = "0xAc09beA4616a2f711AAdBEBB46246727181c0c6C"; // Contract address
-    //Tokens ERC 20 contract adresses in and out
-    std::string tokenIn = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266";
-    std::string tokenOut = "0x70997970C51812dc3A010C7d01b50e0d17dc79C8";
-
-    std::string feeHex = "0x1f4";
-    std::string amountInHex = "0x0f4240";
-    std::string minOutHex = "0x0"; // start with 0 to avoid slippage checks while testing
-
-    std::string approveSelector = "095ea7b3";
-    std::string approveData = "0x" + approveSelector + pad_to_32bytes(executor) + pad_to_32bytes(amountInHex);
-    if(approveData.rfind("0x095ea7b3", 0) != 0 || approveData.size() != 138) {
-        std::cerr << "approveData failed: size =" << approveData.size() << "data= " << approveData << "\n";
-    }
-
-    // Approve the transaction so the executor can spend something 
-    nlohmann::json approveTx = {
-        {"jsonrpc", "2.0"},
-        {"id", 1},
-        {"method", "eth_sendTransaction"},
-        {"params", nlohmann::json::array({
-            {
-                {"from", from},
-                {"to", tokenIn},
-                {"data",approveData},
-                {"value", "0x0"}
+    int rc = 1;
+    {
+        // Pooled client: every call below reuses the same kept-alive connection
+        RpcClientOptions clientOpts;
+        clientOpts.hedge = hedge_options_from_env();   // WEB3_RPC_HEDGE
+        clientOpts.router.limits = limiter_options_from_env();   // WEB3_RPC_RATE
+        RpcClient client(url, clientOpts);
+        MetricsReporter reporter(RpcMetrics::global(), metrics_interval_from_env());   // WEB3_METRICS_INTERVAL_MS
+        MetricsServer metrics(RpcMetrics::global(), metrics_port_from_env(), &client.router());   // WEB3_METRICS_PORT
+        AsyncRpcEngine engine(client);   // drives requests and sleeps
+        ThreadPool pool(2);              // runs the coroutine between awaits
+        CoroRpcClient rpc(engine, pool);
+        BlockClock clock;                // block interval, learned from headers
+        learn_block_time(client, clock);
+        AdaptivePollPolicy policy(clock); // without WS: poll once per expected block
+        HeadSubscriber heads(wsUrl);     // new blocks are pushed when the node supports WS
+        heads.on_head([&clock](const nlohmann::json& head){ clock.observe(head); });
+        TxTrackerOptions trackOpts;
+        trackOpts.poll_policy = &policy;
+        trackOpts.clock = &clock;
+        TxTracker tracker(client, &heads, trackOpts); // one receipt sweep per block for every pending tx
+        NonceManager nonces(client);     // pending nonce fetched once, then handed out locally
+
+        SwapParams p;
+        p.from = address_literal("0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266"); // Wallet address
+        p.executor = address_literal("0xAc09beA4616a2f711AAdBEBB46246727181c0c6C"); // Contract address
+        //Tokens ERC 20 contract adresses in and out
+        p.tokenIn = address_literal("0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266");
+        p.tokenOut = address_literal("0x70997970C51812dc3A010C7d01b50e0d17dc79C8");
+
+        p.feeHex = "0x1f4";
+        p.amountInHex = "0x0f4240";
+        p.minOutHex = "0x0"; // start with 0 to avoid slippage checks while testing
+        const char* swapGas = std::getenv("SWAP_GAS_HEX");
+        p.swapGasHex = swapGas ? swapGas : "0x7a120"; // 500k
+        p.approveGasHex = "0x186a0"; // 100k
+
+        std::optional<Secp256k1Key> key;
+        if(const char* keystore = std::getenv("ETH_KEYSTORE")){
+            const char* password = std::getenv("ETH_KEYSTORE_PASSWORD");
+            key = load_keystore(keystore, password ? password : "");
+            std::optional<uint64_t> chainId = fetch_chain_id(client);
+            std::optional<FeeQuote> fees = quote_fees(client);
+            if(!key || !chainId || !fees){
+                std::cerr << "Error::local signing unavailable (keystore, chainId or fees)\n";
+                curl_global_cleanup();
+                return 1;
             }
-        })}
-    };
+            p.signer = &*key;
+            p.from = key->address();
+            p.chainId = *chainId;
+            if(client.router().size() > 1) client.check_chain_id(*chainId);
+            p.fees = *fees;
+            std::cout << "signing locally as " << p.from << "\n";
+        }
 
-    std::optional<std::string> approveResp = rpc_call(url, approveTx);
-    if(!approveResp){
-        std::cerr << "approve: no response\n";
-        curl_global_cleanup();
-        return 1;
+        try {
+            rc = sync_wait(pool, swap_flow(rpc, tracker, nonces, p));
+        } catch(const std::exception& e){
+            std::cerr << "swap flow: " << e.what() << "\n";
+        }
+        std::cout << "receipt tracking: " << tracker.requests_sent() << " requests\n";
     }
 
-    std::cout << "Approve response: " << *approveResp << "\n";
+    curl_global_cleanup();
+    return rc;
+}
 
-    // Parsing tx hash 
-    nlohmann::json aj = nlohmann::json::parse(*approveResp);
-    if(aj.contains("error")) {
-        std::cerr << "approve error " << aj["error"] << "\n";
-        curl_global_cleanup();
-        return 1;
+// approve -> allowance check (pending state) -> swap -> wait both receipts
+Task<int> swap_flow(CoroRpcClient& rpc, TxTracker& tracker, NonceManager& nonces, SwapParams p){
+    std::optional<SwapCalldata> calldata = build_calldata(p);
+    if(!calldata){
+        std::cerr << "Error::swap amounts are not valid hex quantities\n";
+        co_return 1;
     }
-    std::string approveHash = aj["result"].get<std::string>();
 
-    // Waiting for/Fetch receipt
-    nlohmann::json approveRcpt = wait_receipt(url, approveHash);
-    std::cout << "approve status: " << approveRcpt.value("status", "0x?") << "\n";
-    if(approveRcpt.value("status", "0x?") != "0x1"){
-        std::cerr << "approve failed\n";
-        curl_global_cleanup();
-        return 1;
-    } else {
-        std::cout << "approve success\n";
+    std::optional<uint64_t> approveNonce = nonces.reserve(p.from);
+    if(!approveNonce){
+        std::cerr << "could not fetch nonce for " << p.from << "\n";
+        co_return 1;
     }
 
-    std::string allowanceSelector = "dd62ed3e";
-    std::string allowanceData = "0x" + allowanceSelector 
-                                + pad_to_32bytes(from)    // Owner
-                                + pad_to_32bytes(executor); //Spender
-
-    nlohmann::json allowCall = {
-        {"jsonrpc", "2.0"},
-        {"id", 2001},
-        {"method", "eth_call"},
-        {"params", nlohmann::json::array({
-            {
-                {"to", tokenIn}, // Contract address
-                {"data", allowanceData},
-            },
-            "latest"
-        })}
-    };
+    // Approve the transaction so the executor can spend something
+    Submission approve;
+    approve.what = "approve";
+    approve.nonce = *approveNonce;
+    std::tie(approve.method, approve.params) = send_request(p, p.tokenIn, calldata->approve, approve.nonce, p.approveGasHex);
+    RpcResult approveResp = co_await rpc.call_retry(approve.method, approve.params);
+    if(!approveResp.ok()){
+        std::cerr << "approve error " << approveResp.error->dump() << "\n";
+        if(is_nonce_too_low(*approveResp.error)) nonces.reset(p.from);
+        else nonces.release(p.from, approve.nonce);
+        co_return 1;
+    }
 
-    std::optional<std::string> allowResp = rpc_call(url, allowCall);
-    if(!allowResp){
-        std::cerr << "allowance: no response\n";
-        curl_global_cleanup();
-        return 1;
+    // Parsing tx hash
+    std::optional<Hash32> approveHash = result_hash(approveResp);
+    if(!approveHash){
+        std::cerr << "approve: node returned no tx hash " << approveResp.result->dump() << "\n";
+        nonces.release(p.from, approve.nonce);
+        co_return 1;
+    }
+    approve.hash = *approveHash;
+    nonces.submitted(p.from, approve.nonce, approve.hash);
+    std::cout << "Approve tx: " << approve.hash << " (nonce " << approve.nonce << ")\n";
+
+    // No wait for the approve receipt if the node's pending state already has it.
+    // Some nodes answer "pending" from the latest block: there the approve is
+    // mined first and the allowance read again at "latest".
+    RpcResult allowResp = co_await call_at(rpc, p.tokenIn, calldata->allowance, "pending");
+    bool pipelined = allowResp.ok() && allowance_of(allowResp) >= calldata->amountIn;
+    std::optional<nlohmann::json> approveRcpt;
+    if(!pipelined){
+        std::cout << "pending state does not show the approve yet; waiting for its receipt\n";
+        approveRcpt = co_await await_receipt(rpc, tracker, nonces, p.from, approve);
+        if(!approveRcpt || approveRcpt->value("status", "0x?") != "0x1"){
+            std::cerr << "approve failed\n";
+            co_return 1;
+        }
+        allowResp = co_await call_at(rpc, p.tokenIn, calldata->allowance, "latest");
     }
-    std::cout << "allowance response: " << *allowResp << "\n";
+    if(!allowResp.ok()){
+        std::cerr << "allowance error " << allowResp.error->dump() << "\n";
+        co_return 1;
+    }
+    std::cout << "allowance response: " << allowResp.result->dump() << "\n";
 
-    nlohmann::json allowJson = nlohmann::json::parse(*allowResp);
-    std::string allowHex = allowJson.value("result", "0x0");
-    uint64_t allowU64 = hex_to_u64(allowHex);
-    uint64_t amountInU64 = hex_to_u64(amountInHex);
+    uint256 allowance = allowance_of(allowResp);
 
-    std::cout << "allowance: (u64) = " << allowU64 << " ; amountIn: (u64) = " << amountInU64 << "\n";
+    std::cout << "allowance: " << to_string(allowance) << " ; amountIn: " << to_string(calldata->amountIn) << "\n";
 
-    if(allowU64 >= amountInU64){
+    if(allowance >= calldata->amountIn){
         std::cout << "allowance is sufficient!\n";
     }else{
         std::cout << "allowance is insufficient :( \n";
-        curl_global_cleanup();
-        return 1;
+        co_return 1;
     }
 
-    std::string swapSelector = "43ecfa0a";
-    std::string data = "0x" + swapSelector + pad_to_32bytes(tokenIn) + pad_to_32bytes(tokenOut) 
-        + pad_to_32bytes(feeHex) + pad_to_32bytes(amountInHex) + pad_to_32bytes(minOutHex);
-    if(data.rfind("0x43ecfa0a", 0) != 0 || data.size() != 330) {
-        std::cerr << "swap data failed: size=" << data.size() << "data= " << data << "\n";
+    // Estimated against the state the allowance was read from, which has the
+    // approve in it; the fixed limit only if the node cannot estimate.
+    std::string swapGasHex = p.swapGasHex;
+    RpcResult swapGas = co_await estimate_gas(rpc, p.from, p.executor, calldata->swap, pipelined ? "pending" : "latest");
+    if(std::optional<uint64_t> est = swapGas.ok() ? json_quantity_of(*swapGas.result) : std::nullopt){
+        swapGasHex = to_hex(*est + *est / 5);
+    }else{
+        std::cerr << "swap gas estimate failed, using " << swapGasHex << "\n";
     }
-    
-    nlohmann::json swapTx = {
-        {"jsonrpc", "2.0"},
-        {"method", "eth_sendTransaction"},
-        {"params", nlohmann::json::array({
-            {
-                {"from", from}, // Wallet address EOA
-                {"to", executor}, // Contract address
-                {"data", data},
-                {"value", "0x0"}
-            }
-        })},
-        {"id", 2}
-    };
 
-    std::optional<std::string> swapResp = rpc_call(url, swapTx);
-    if(!swapResp){
-        std::cerr << "swap: no response\n";
-        curl_global_cleanup();
-        return 1;
+    // Next nonce, sent right behind the approve
+    std::optional<uint64_t> swapNonce = nonces.reserve(p.from);
+    if(!swapNonce){
+        std::cerr << "could not reserve swap nonce\n";
+        co_return 1;
+    }
+    Submission swap;
+    swap.what = "swap";
+    swap.nonce = *swapNonce;
+    std::tie(swap.method, swap.params) = send_request(p, p.executor, calldata->swap, swap.nonce, swapGasHex);
+    RpcResult swapResp = co_await rpc.call_retry(swap.method, swap.params);
+    if(!swapResp.ok()){
+        std::cerr << "swap error: " << swapResp.error->dump() << "\n";
+        nonces.release(p.from, swap.nonce);
+        co_return 1;
     }
-
-    std::cout << "Swap resp: " << *swapResp << "\n";
 
     //Parsing txhash
-    nlohmann::json sj = nlohmann::json::parse(*swapResp);
-    if(sj.contains("error")) {
-        std::cerr << "swap error: " << sj["error"] << "\n";
-        curl_global_cleanup();
-        return 1;
+    std::optional<Hash32> swapHash = result_hash(swapResp);
+    if(!swapHash){
+        std::cerr << "swap: node returned no tx hash " << swapResp.result->dump() << "\n";
+        nonces.release(p.from, swap.nonce);
+        co_return 1;
+    }
+    swap.hash = *swapHash;
+    nonces.submitted(p.from, swap.nonce, swap.hash);
+    std::cout << "Swap tx: " << swap.hash << " (nonce " << swap.nonce << ")\n";
+
+    // Both are in flight; the tracker resolves them from the same block sweep
+    if(!approveRcpt){
+        approveRcpt = co_await await_receipt(rpc, tracker, nonces, p.from, approve);
+        std::cout << "approve status: " << (approveRcpt ? approveRcpt->value("status", "0x?") : "none") << "\n";
+        if(!approveRcpt || approveRcpt->value("status", "0x?") != "0x1"){
+            std::cerr << "approve failed\n";
+            co_return 1;
+        } else {
+            std::cout << "approve success\n";
+        }
     }
-    std::string swapHash = sj["result"].get<std::string>();
 
-    nlohmann::json swapRcpt = wait_receipt(url, swapHash);
-    std::cout << "swap status: " << swapRcpt.value("status", "0x?") << "\n";
-    if(swapRcpt.value("status", "0x?") != "0x1"){
+    std::optional<nlohmann::json> swapRcpt = co_await await_receipt(rpc, tracker, nonces, p.from, swap);
+    std::cout << "swap status: " << (swapRcpt ? swapRcpt->value("status", "0x?") : "none") << "\n";
+    if(!swapRcpt || swapRcpt->value("status", "0x?") != "0x1"){
         std::cerr << "swap failed\n";
-        curl_global_cleanup();
-        return 1;
+        co_return 1;
     } else{
         std::cout << "swap successfull\n";
     }
-    
-    curl_global_cleanup();
-    return 0; 
+    co_return 0;
 }
 
-// Function to wait for a transaction receipt
-nlohmann::json wait_receipt(const std::string& url, const std::string& txhash){
-    for(int i = 0; i < 40; ++i){
-        nlohmann::json req = {
-            {"jsonrpc", "2.0"},
-            {"id", 1000 + i},
-            {"method", "eth_getTransactionReceipt"},
-            {"params", nlohmann::json::array({txhash})}
-        };
-
-        std::optional<std::string> raw = rpc_call(url, req);
-        if(raw){
-            nlohmann::json resp = nlohmann::json::parse(*raw);
-            if(!resp.contains("error") && !resp["result"].is_null()){
-                return resp["result"];
-            }
+// Receipt of s; its nonce is confirmed once it is in. On a timeout the
+// sender's nonces are resynced: if the node dropped s it is rebroadcast once
+// with the same nonce, and released if that fails too. A tx the node still
+// has keeps its nonce in flight.
+static Task<std::optional<nlohmann::json>> await_receipt(CoroRpcClient& rpc, TxTracker& tracker,
+                                                         NonceManager& nonces, const Address& from, Submission& s){
+    for(bool resent = false;; resent = true){
+        std::optional<nlohmann::json> rcpt;
+        try {
+            rcpt = co_await rpc.receipt(s.hash, tracker);
+        } catch(const std::runtime_error& e){
+            std::cerr << s.what << " " << s.hash << ": " << e.what() << "\n";
+        }
+        if(rcpt){
+            nonces.confirmed(from, s.nonce);
+            co_return rcpt;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(300)); // 300 ms wait
-    }
-    throw std::runtime_error("timeout waiting for reciept");
-}
 
-// Helper to pad hex strings to 64 chars(32 bytes)
-std::string pad_to_32bytes(const std::string& input) {
-    std::string hex = input;
-    if(hex.rfind("0x", 0) == 0 || hex.rfind("0X", 0) == 0) {
-        hex = hex.substr(2); // Remove "0x" prefix
-    }
-    while(hex.length() < 64) {
-        hex = "0" + hex; // Pad with leading zeros
+        std::vector<uint64_t> dropped = nonces.resync(from);
+        if(std::find(dropped.begin(), dropped.end(), s.nonce) == dropped.end()) co_return std::nullopt;
+        if(resent){
+            nonces.release(from, s.nonce);
+            co_return std::nullopt;
+        }
+        // Plain call: call_retry knows this hash as sent and would skip it
+        RpcResult r = co_await rpc.call(s.method, s.params);
+        std::optional<Hash32> h = result_hash(r);
+        if(!h){
+            std::cerr << s.what << ": rebroadcast rejected\n";
+            nonces.release(from, s.nonce);
+            co_return std::nullopt;
+        }
+        s.hash = *h;
+        nonces.submitted(from, s.nonce, s.hash);
+        std::cout << s.what << " dropped by the node, rebroadcast: " << s.hash << "\n";
     }
-    return hex;
 }
 
-// Callback function to write response data
-size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* uploadedData){
-    std::string* out = static_cast<std::string*>(uploadedData);
-    if(!out){
-        std::cerr << "ERROR::Uploaded data pointer is null\n";
-        return 0;
-    }
-    out->append(ptr, size * nmemb);
-
-    return size * nmemb; 
+// eth_sendTransaction params: [{from, to, data, value, nonce[, gas]}]
+// (built outside the coroutine: GCC 12 mis-compiles json initializer lists in coroutine frames)
+static nlohmann::json tx_params(const Address& from, const Address& to, const std::string& data,
+                                uint64_t nonce, const char* gas){
+    nlohmann::json tx = {
+        {"from", from.hex_string()},
+        {"to", to.hex_string()},
+        {"data", data},
+        {"value", "0x0"},
+        {"nonce", to_hex(nonce)}
+    };
+    if(gas) tx["gas"] = gas;
+    return nlohmann::json::array({tx});
 }
 
-// Function to perform the RPC call
-std::optional<std::string> rpc_call(const std::string& url, const nlohmann::json& j){
-    if(url.empty()){
-        std::cerr << "Error::URL is empty\n";
-        return std::nullopt;
-    }
-
-    CURL* curl = curl_easy_init();
-    if(!curl){
-        std::cerr << "Error::Failed to initialize CURL\n";
-        return std::nullopt;
-    }
-
-    std::string body = j.dump();
-    std::cout << "\n--- SENDING ---\n" << body << "\n--------------\n";
-    
-    if(body.empty()){
-        std::cerr << "Error::Request body is empty\n";
-        curl_easy_cleanup(curl);
-        return std::nullopt;
+// {method, params} for one submission: eth_sendRawTransaction with a locally
+// signed EIP-1559 tx when p.signer is set, else eth_sendTransaction.
+static std::pair<std::string, nlohmann::json> send_request(const SwapParams& p, const Address& to,
+                                                           const std::string& data, uint64_t nonce,
+                                                           const std::string& gasHex){
+    if(!p.signer){
+        return {"eth_sendTransaction", tx_params(p.from, to, data, nonce, gasHex.c_str())};
     }
-
-    curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, body.size());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    // Just temporary check for stupid bugs
-    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
-    curl_easy_setopt(curl, CURLOPT_STDERR, stderr);
-
-    CURLcode res = curl_easy_perform(curl);
-    if(res != CURLE_OK){
-        std::cerr << "Error::" << curl_easy_strerror(res) << "\n";
-        curl_easy_cleanup(curl);
-        return std::nullopt;
+    Eip1559Tx tx;
+    tx.chain_id = p.chainId;
+    tx.nonce = nonce;
+    tx.max_priority_fee_per_gas = p.fees.max_priority_fee_per_gas;
+    tx.max_fee_per_gas = p.fees.max_fee_per_gas;
+    std::optional<uint256> gas = uint256::from_hex(gasHex);
+    tx.gas_limit = gas && gas->fits_u64() ? gas->low_u64() : 0; // 0: rejected by the node
+    tx.to = to.bytes();
+    tx.data = from_hex(data).value_or(Bytes{});
+    std::optional<SignedTx> signedTx = sign_eip1559(tx, *p.signer);
+    if(!signedTx){
+        // Sent as-is, the node rejects it and the flow reports the error
+        return {"eth_sendRawTransaction", nlohmann::json::array({"0x"})};
     }
+    return {"eth_sendRawTransaction", nlohmann::json::array({signedTx->raw})};
+}
 
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
+// eth_call [{to, data}, tag], retried if the node is briefly unavailable
+// (outside the coroutine for the same GCC 12 reason as tx_params)
+static Task<RpcResult> call_at(CoroRpcClient& rpc, const Address& to, const std::string& data, const char* tag){
+    nlohmann::json call = {{"to", to.hex_string()}, {"data", data}};
+    return rpc.call_retry("eth_call", nlohmann::json::array({call, tag}));
+}
 
-    if(response.empty()){
-        std::cerr << "Error::Response is empty\n";
-        return std::nullopt;
-    }
+// eth_estimateGas [{from, to, data}, tag]
+static Task<RpcResult> estimate_gas(CoroRpcClient& rpc, const Address& from, const Address& to,
+                                    const std::string& data, const char* tag){
+    nlohmann::json call = {{"from", from.hex_string()}, {"to", to.hex_string()}, {"data", data}};
+    return rpc.call_retry("eth_estimateGas", nlohmann::json::array({call, tag}));
+}
 
-    return response;
+// uint256 returned by allowance(); zero if the call failed
+static uint256 allowance_of(const RpcResult& r){
+    if(!r.ok() || !r.result->is_string()) return uint256();
+    return uint256::from_hex(r.result->get<std::string>()).value_or(uint256());
 }
 
-// Function to strip "0x" prefix from a hex string
-static std::string strip0x(std::string s){
-    if(s.rfind("0x", 0) == 0 || s.rfind("0X", 0) == 0) {
-        s = s.substr(2); // Removing "0x" frm the beginning
-        return s;
-    }
-    return s; // return original if no 0x
+// uint64_t -> "0x.." quantity
+static std::string to_hex(uint64_t v){
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)v);
+    return buf;
 }
 
-// Function to convert a hex string to a uint64_t value
-static uint64_t hex_to_u64(std::string s){
-    s = strip0x(s);
-    if(s.size() > 16){
-        s = s.substr(s.size() - 16); 
-    }
-    uint64_t value = 0;
-    for(char c : s){
-        value <<=4; //Shift left by 4 bits
-        if (c >= '0' && c <= '9') value |= (uint64_t)(c - '0');
-        else if(c >= 'a' && c <= 'f') value |= (uint64_t)(10 + c - 'a');
-        else if(c >= 'A' && c<= 'F') value |= (uint64_t)(10 + c - 'A');
+// approve / allowance / swap calldata; nullopt if an amount does not parse
+static std::optional<SwapCalldata> build_calldata(const SwapParams& p){
+    std::optional<uint256> fee = uint256::from_hex(p.feeHex);
+    std::optional<uint256> amountIn = uint256::from_hex(p.amountInHex);
+    std::optional<uint256> minOut = uint256::from_hex(p.minOutHex);
+    if(!fee || !amountIn || !minOut || *fee > uint256(0xffffff)){
+        return std::nullopt;
     }
-    return value;
+    SwapCalldata c;
+    c.amountIn = *amountIn;
+    c.approve = Approve::encode_hex(p.executor, *amountIn);       // spender, amount
+    c.allowance = Allowance::encode_hex(p.from, p.executor);      // owner, spender
+    c.swap = SwapExactInSingle::encode_hex(p.tokenIn, p.tokenOut, *fee, *amountIn, *minOut);
+    return c;
 }
 
-
-
-
-
+// Tx hash returned by eth_send(Raw)Transaction
+static std::optional<Hash32> result_hash(const RpcResult& r){
+    if(!r.ok() || !r.result->is_string()) return std::nullopt;
+    return Hash32::from_hex(r.result->get<std::string>());
+}